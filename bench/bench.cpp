@@ -0,0 +1,601 @@
+// the allocations are counted only when they are reported (the hooks slow
+// down the timings)
+#ifdef SERIALIZER_ALLOC_STATS
+#define SERIALIZER_ALLOC_HOOKS
+#endif
+#include <serializer/tools/alloc_stats.hpp>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <serializer/serializer.hpp>
+#include <serializer/io/async_file.hpp>
+#include <serializer/io/batch_buffer.hpp>
+#include <serializer/io/pipelined_sender.hpp>
+#include <serializer/io/record_log.hpp>
+#include <serializer/io/shm_ring.hpp>
+#include <serializer/io/unix_socket.hpp>
+#include <serializer/tools/bytes_pool.hpp>
+#include <serializer/tools/parallel.hpp>
+#include <serializer/tools/stats.hpp>
+#include <serializer/tools/work_stealing_pool.hpp>
+#include <sys/wait.h>
+#include "bench/suite.hpp"
+#include "bench/types.hpp"
+#include "test-classes/composed.hpp"
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+
+/******************************************************************************/
+/*                                  helpers                                   */
+/******************************************************************************/
+
+#define time(t)                                                                \
+    std::chrono::duration_cast<std::chrono::microseconds>(t).count() << "us"
+
+/// @brief Run the function and print its execution time.
+void bench(std::string const &name, std::function<void()> const &fun) {
+    auto begin = std::chrono::steady_clock::now();
+    fun();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << ": " << time(end - begin) << std::endl;
+}
+
+/******************************************************************************/
+/*                                 async file                                 */
+/******************************************************************************/
+
+/// @brief Compare blocking writes with the asynchronous file: the batches are
+///        serialized and written one after the other.
+void benchAsyncFile(std::string const &path, size_t nbBatches,
+                    size_t batchSize) {
+    std::vector<Simple> batch;
+
+    for (size_t i = 0; i < batchSize; ++i) {
+        batch.emplace_back(int(i), int(2 * i), "element " + std::to_string(i));
+    }
+    auto serialize = [&](serializer::Bytes &bytes) {
+        size_t pos = 0;
+        for (auto const &elt : batch) {
+            pos = elt.serialize(bytes, pos);
+        }
+    };
+
+    bench("blocking write", [&]() {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        serializer::Bytes bytes;
+        for (size_t i = 0; i < nbBatches; ++i) {
+            serialize(bytes);
+            if (::write(fd, bytes.data(), bytes.size()) < 0) {
+                std::cerr << "error: write failed." << std::endl;
+            }
+        }
+        ::close(fd);
+    });
+
+    auto async = [&](serializer::io::AsyncFileOptions options) {
+        serializer::io::AsyncFile file(path, O_WRONLY | O_CREAT | O_TRUNC,
+                                       options);
+        for (size_t i = 0; i < nbBatches; ++i) {
+            serializer::Bytes bytes = file.buffer();
+            serialize(bytes);
+            file.append(std::move(bytes));
+            file.poll();
+        }
+        file.close();
+    };
+    std::cout << "io_uring: "
+              << (serializer::io::AsyncFile(path, O_RDONLY).async() ? "yes"
+                                                                     : "no")
+              << std::endl;
+    bench("async write", [&]() { async({}); });
+    bench("async write (O_DIRECT)", [&]() { async({.direct = true}); });
+    std::remove(path.c_str());
+}
+
+/******************************************************************************/
+/*                                 record log                                 */
+/******************************************************************************/
+
+/// @brief Measure the append rate and the latency of the random reads of the
+///        record log.
+void benchRecordLog(std::string const &path, size_t nbRecords) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> dist(0, nbRecords - 1);
+    size_t nbReads = nbRecords / 10;
+    Simple simple(1, 2, "record");
+    long sum = 0;
+
+    std::remove(path.c_str());
+    std::remove((path + ".index").c_str());
+    serializer::io::RecordLog log(path);
+    bench("record log append (" + std::to_string(nbRecords) + " records)",
+          [&]() {
+              for (size_t i = 0; i < nbRecords; ++i) {
+                  simple.x(int(i));
+                  log.append(simple);
+              }
+              log.checkpoint();
+          });
+    log.view(); // map the file before measuring the reads
+    bench("record log random reads (" + std::to_string(nbReads) + " reads)",
+          [&]() {
+              for (size_t i = 0; i < nbReads; ++i) {
+                  log.read(dist(gen), simple);
+                  sum += simple.x();
+              }
+          });
+    std::cout << "checksum: " << sum << std::endl;
+    std::remove(path.c_str());
+    std::remove((path + ".index").c_str());
+}
+
+/******************************************************************************/
+/*                             shared memory ring                             */
+/******************************************************************************/
+
+/// @brief Message used to measure the latency of the transports.
+struct Message {
+    std::uint64_t seq = 0;  ///< sequence number
+    std::int64_t sent = 0;  ///< time of the send (ns)
+    std::string payload;    ///< data
+
+    SERIALIZE(seq, sent, payload);
+};
+
+/// @brief Current time in ns.
+std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// @brief Messages/sec and latency of the shared memory ring between two
+///        processes, compared with the copy through a Bytes buffer.
+void benchShmRing(size_t nbMessages, size_t payloadSize) {
+    Message msg{0, 0, std::string(payloadSize, 'x')};
+    auto ring = serializer::io::SpscRing::anonymous(1 << 20);
+    double latency = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (size_t i = 0; i < nbMessages; ++i) {
+            msg.seq = i;
+            msg.sent = now();
+            ring.send(msg);
+        }
+        _exit(0);
+    }
+    for (size_t i = 0; i < nbMessages; ++i) {
+        ring.receive(msg);
+        latency += double(now() - msg.sent);
+    }
+    auto end = std::chrono::steady_clock::now();
+    waitpid(pid, nullptr, 0);
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "shm ring: " << size_t(double(nbMessages) / seconds)
+              << " msg/s, latency: " << size_t(latency / double(nbMessages))
+              << "ns" << std::endl;
+
+    // stand-in: the message is serialized in a buffer that is copied
+    serializer::Bytes network;
+    bench("bytes copy (" + std::to_string(nbMessages) + " messages)", [&]() {
+        serializer::Bytes mem;
+        for (size_t i = 0; i < nbMessages; ++i) {
+            msg.seq = i;
+            msg.serialize(mem);
+            network.append(network.size(), mem.data(), mem.size());
+            serializer::Bytes received = network;
+            network.clear();
+            msg.deserialize(received);
+        }
+    });
+}
+
+/******************************************************************************/
+/*                                unix socket                                 */
+/******************************************************************************/
+
+/// @brief Throughput of the frames sent between two processes over a unix
+///        socket, compared with the in-process stand-in of the network (the
+///        serialized messages are appended to a buffer that is copied and
+///        deserialized).
+void benchUnixSocket(size_t nbMessages, size_t payloadSize) {
+    Message msg{0, 0, std::string(payloadSize, 'x')};
+    auto [in, out] = serializer::io::UnixSocket::pair();
+    size_t nbBytes = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        in.close();
+        serializer::io::FrameSender sender(out);
+        for (size_t i = 0; i < nbMessages; ++i) {
+            msg.seq = i;
+            sender.post(msg);
+        }
+        sender.flush();
+        _exit(0);
+    }
+    out.close();
+    serializer::io::FrameReceiver receiver(in);
+    while (receiver.receive([&](auto &mem, serializer::Frame frame) {
+        msg.deserialize(mem, frame.pos);
+        nbBytes += frame.header.length;
+    })) {
+    }
+    auto end = std::chrono::steady_clock::now();
+    waitpid(pid, nullptr, 0);
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "unix socket: " << size_t(double(nbMessages) / seconds)
+              << " msg/s, " << size_t(double(nbBytes) / seconds / 1e6)
+              << " MB/s" << std::endl;
+
+    // stand-in: the messages are serialized in a buffer that is copied
+    begin = std::chrono::steady_clock::now();
+    serializer::Bytes network;
+    serializer::Bytes mem;
+    for (size_t i = 0; i < nbMessages; ++i) {
+        msg.seq = i;
+        msg.serialize(mem);
+        network.append(network.size(), mem.data(), mem.size());
+    }
+    serializer::Bytes received = network;
+    for (size_t pos = 0; pos < received.size();) {
+        pos = msg.deserialize(received, pos);
+    }
+    end = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << "network stand-in: "
+              << size_t(double(nbMessages) / seconds) << " msg/s, "
+              << size_t(double(received.size()) / seconds / 1e6) << " MB/s"
+              << std::endl;
+}
+
+/******************************************************************************/
+/*                                  parallel                                  */
+/******************************************************************************/
+
+/// @brief Serialize and deserialize large containers sequentially and with
+///        thread pools of 1 to 32 threads.
+void benchParallel(size_t nbElements) {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    using serializer::tools::chunked;
+    std::vector<Composed> elements, result;
+    std::map<size_t, std::string> map, mapResult;
+    serializer::Bytes mem;
+
+    for (size_t i = 0; i < nbElements; ++i) {
+        elements.emplace_back(
+            Simple(int(i), int(2 * i), std::string(i % 32, 'x')), int(i),
+            double(i));
+        if (i % 10 == 0) {
+            map.insert({i, std::to_string(i)});
+        }
+    }
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << std::endl;
+    serializer::serialize<Ser>(mem, 0, elements); // allocate the buffer
+    bench("sequential (" + std::to_string(nbElements) + " elements)",
+          [&]() { serializer::serialize<Ser>(mem, 0, elements); });
+    bench("sequential deserialization",
+          [&]() { serializer::deserialize<Ser>(mem, 0, result); });
+    for (size_t nbThreads = 1; nbThreads <= 32; nbThreads *= 2) {
+        serializer::tools::ThreadPool pool(nbThreads);
+        std::string threads = " (" + std::to_string(nbThreads) + " threads)";
+        bench("parallel" + threads, [&]() {
+            serializer::serialize<Ser>(
+                mem, 0, serializer::tools::parallel(elements, pool));
+        });
+        bench("chunked" + threads, [&]() {
+            serializer::serialize<Ser>(mem, 0, chunked(elements, pool));
+        });
+        bench("chunked deserialization" + threads, [&]() {
+            serializer::deserialize<Ser>(mem, 0, chunked(result, pool));
+        });
+        serializer::serialize<Ser>(mem, 0, chunked(map, pool));
+        bench("chunked map deserialization" + threads, [&]() {
+            serializer::deserialize<Ser>(mem, 0, chunked(mapResult, pool));
+        });
+    }
+}
+
+/******************************************************************************/
+/*                                  dispatch                                  */
+/******************************************************************************/
+
+/// @brief Run the hedgehog pipeline (split -> compute -> result) with the
+///        sequential receive loop and with frame dispatchers of 1 to 32
+///        threads.
+void benchDispatch(size_t size, size_t blockSize) {
+    auto run = [&]<typename Transport>(Transport, auto &&receive) {
+        using Manager = TaskManager<TypeTable<double>,
+                                    SplitTask<double, Transport>,
+                                    ComputeTask<double, Transport>,
+                                    ResultTask<double>>;
+        auto data = new double[size * size];
+        auto matrix =
+            std::make_shared<Matrix<double>>(size, size, blockSize, data);
+        auto rt = std::make_shared<ResultTask<double>>();
+        Manager tm(std::make_shared<SplitTask<double, Transport>>(),
+                   std::make_shared<ComputeTask<double, Transport>>(), rt);
+
+        for (size_t i = 0; i < size * size; ++i) {
+            data[i] = 1;
+        }
+        Transport::send(*matrix);
+        delete[] data;
+        for (size_t i = 0; i < 3; ++i) {
+            receive(tm, Network::rcv());
+        }
+        if (rt->result != size * size) {
+            std::cerr << "error: wrong result." << std::endl;
+        }
+    };
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << std::endl;
+    bench("sequential receive (" + std::to_string(size) + "x" +
+              std::to_string(size) + " matrix)",
+          [&]() {
+              run(BufferTransport(),
+                  [](auto &tm, auto buff) { tm.receive(buff); });
+          });
+    for (size_t nbThreads = 1; nbThreads <= 32; nbThreads *= 2) {
+        serializer::tools::WorkStealingPool pool(nbThreads);
+        serializer::FrameDispatcher<TypeTable<double>> dispatcher(
+            pool, {.idInPayload = true});
+        bench("dispatch (" + std::to_string(nbThreads) + " threads)", [&]() {
+            run(FrameTransport(), [&](auto &tm, auto buff) {
+                tm.receive(dispatcher, buff);
+            });
+        });
+    }
+}
+
+/******************************************************************************/
+/*                                 bytes pool                                 */
+/******************************************************************************/
+
+/// @brief Serialize messages in a new buffer each time, in buffers of a
+///        BytesPool, and in buffers of the shared pool (1 to 8 threads).
+void benchBytesPool(size_t nbMessages) {
+    using SharedPool = serializer::tools::SharedBytesPool<std::byte>;
+    Simple msg(1, 2, std::string(256, 'x'));
+    SharedPool &shared = SharedPool::global();
+
+    bench("new buffers (" + std::to_string(nbMessages) + " messages)", [&]() {
+        for (size_t i = 0; i < nbMessages; ++i) {
+            serializer::Bytes mem;
+            msg.serialize(mem);
+        }
+    });
+    bench("bytes pool", [&]() {
+        serializer::tools::BytesPool<std::byte> pool;
+        for (size_t i = 0; i < nbMessages; ++i) {
+            serializer::Bytes mem = pool.acquire();
+            msg.serialize(mem);
+            pool.release(std::move(mem));
+        }
+    });
+    for (size_t nbThreads = 1; nbThreads <= 8; nbThreads *= 2) {
+        bench("shared bytes pool (" + std::to_string(nbThreads) + " threads)",
+              [&]() {
+                  std::vector<std::thread> threads;
+                  for (size_t t = 0; t < nbThreads; ++t) {
+                      threads.emplace_back([&]() {
+                          Simple local = msg;
+                          for (size_t i = 0; i < nbMessages / nbThreads; ++i) {
+                              serializer::Bytes mem = shared.acquire();
+                              local.serialize(mem);
+                              shared.release(std::move(mem));
+                          }
+                      });
+                  }
+                  for (auto &thread : threads) {
+                      thread.join();
+                  }
+              });
+    }
+    auto stats = shared.stats();
+    std::cout << "shared bytes pool: " << stats.hits << " hits, "
+              << stats.sharedHits << " shared hits, " << stats.misses
+              << " misses, " << stats.cachedBytes << " bytes cached"
+              << std::endl;
+}
+
+/******************************************************************************/
+/*                                batch buffer                                */
+/******************************************************************************/
+
+/// @brief Batch messages of several threads: each thread serializes in its
+///        own buffer which is copied in the batch under a lock, or the threads
+///        serialize directly in a shared batch buffer.
+void benchBatchBuffer(size_t nbMessages, size_t nbThreads) {
+    Simple msg(1, 2, std::string(64, 'x'));
+    auto run = [&](auto &&produce) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nbThreads; ++t) {
+            threads.emplace_back([&]() {
+                for (size_t i = 0; i < nbMessages / nbThreads; ++i) {
+                    produce();
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    };
+    std::string suffix = " (" + std::to_string(nbMessages) + " messages, " +
+                         std::to_string(nbThreads) + " threads)";
+
+    bench("locked copy" + suffix, [&]() {
+        serializer::Bytes batch(nbMessages * 128);
+        std::mutex mutex;
+        run([&]() {
+            thread_local serializer::Bytes mem;
+            msg.serialize(mem);
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.append(batch.size(), mem.data(), mem.size());
+        });
+    });
+    bench("batch buffer" + suffix, [&]() {
+        serializer::io::BatchBuffer batch(nbMessages * 128, nbMessages);
+        run([&]() { batch.tryAppend(msg); });
+        batch.flush([](std::span<std::byte const>) {});
+    });
+}
+
+/******************************************************************************/
+/*                              pipelined sender                              */
+/******************************************************************************/
+
+/// @brief Send messages to a file descriptor: synchronously (one write per
+///        message, or per batch), and with the pipelined sender which
+///        overlaps the serialization and the writes.
+void benchPipelinedSender(std::string const &path, size_t nbMessages) {
+    Simple msg(1, 2, std::string(64, 'x'));
+    constexpr size_t batchSize = 64 << 10;
+    auto run = [&](auto &&send) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        send(serializer::tools::FdSink{fd});
+        ::close(fd);
+    };
+    std::string suffix = " (" + std::to_string(nbMessages) + " messages)";
+
+    bench("synchronous send" + suffix, [&]() {
+        run([&](serializer::tools::FdSink sink) {
+            serializer::Bytes mem;
+            for (size_t i = 0; i < nbMessages; ++i) {
+                msg.serialize(mem);
+                sink.write(mem.data(), mem.size());
+            }
+        });
+    });
+    bench("synchronous batches", [&]() {
+        run([&](serializer::tools::FdSink sink) {
+            serializer::Bytes mem;
+            size_t pos = 0;
+            for (size_t i = 0; i < nbMessages; ++i) {
+                pos = msg.serialize(mem, pos);
+                if (pos >= batchSize) {
+                    sink.write(mem.data(), pos);
+                    pos = 0;
+                }
+            }
+            sink.write(mem.data(), pos);
+        });
+    });
+    for (size_t nbBuffers = 2; nbBuffers <= 4; nbBuffers *= 2) {
+        bench("pipelined sender (" + std::to_string(nbBuffers) + " buffers)",
+              [&]() {
+                  run([&](serializer::tools::FdSink sink) {
+                      serializer::io::PipelinedSender sender(
+                          sink, {.nbBuffers = nbBuffers,
+                                 .batchBytes = batchSize});
+                      for (size_t i = 0; i < nbMessages; ++i) {
+                          sender.post(msg);
+                      }
+                      sender.flush();
+                  });
+              });
+    }
+}
+
+/******************************************************************************/
+/*                              serializer stats                              */
+/******************************************************************************/
+
+template <typename MemT>
+using StatsSerializer =
+    serializer::Serializer<MemT, serializer::tools::TypeTable<>,
+                           serializer::tools::ThreadStats>;
+
+/// @brief Same members as Simple, serialized with the statistics policy.
+struct SimpleWithStats {
+    int x = 0;
+    int y = 0;
+    std::string str;
+    SERIALIZE_CUSTOM(StatsSerializer<SER_MEMT>, x, y, str);
+};
+
+/// @brief Serialize and deserialize messages without and with the thread
+///        statistics policy (cost of the policy), and dump the statistics.
+void benchStats(size_t nbMessages) {
+    Simple msg(1, 2, "message"), out;
+    SimpleWithStats statsMsg{1, 2, "message"}, statsOut;
+    serializer::Bytes mem;
+
+    bench("without stats (" + std::to_string(nbMessages) + " messages)",
+          [&]() {
+              for (size_t i = 0; i < nbMessages; ++i) {
+                  msg.serialize(mem);
+                  out.deserialize(mem);
+              }
+          });
+    bench("thread stats", [&]() {
+        for (size_t i = 0; i < nbMessages; ++i) {
+            statsMsg.serialize(mem);
+            statsOut.deserialize(mem);
+        }
+    });
+    serializer::tools::ThreadStats::dump(std::cout);
+}
+
+/******************************************************************************/
+/*                                    main                                    */
+/******************************************************************************/
+
+/// @brief Usage: serializer-bench [--types] [--json file] [path]
+///        --types: only run the type categories suite.
+///        --json: write the results of the suite in a JSON file.
+///        path: file used by the io benchmarks.
+int main(int argc, char **argv) {
+    std::string path = "serializer-bench.bin";
+    std::string jsonPath;
+    bool typesOnly = false;
+    Suite suite;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--types") {
+            typesOnly = true;
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            path = arg;
+        }
+    }
+
+    benchTypes(suite);
+    suite.printSummary();
+#ifdef SERIALIZER_ALLOC_STATS
+    suite.printAllocations();
+#endif
+    if (!jsonPath.empty()) {
+        std::ofstream fs(jsonPath);
+        suite.json(fs);
+    }
+    if (typesOnly) {
+        return 0;
+    }
+    benchAsyncFile(path, 1000, 1000);
+    benchRecordLog(path, 1000000);
+    benchShmRing(1000000, 64);
+    benchUnixSocket(1000000, 64);
+    benchParallel(1000000);
+    benchDispatch(256, 16);
+    benchBytesPool(1000000);
+    benchBatchBuffer(1000000, 1);
+    benchBatchBuffer(1000000, 4);
+    benchPipelinedSender(path, 1000000);
+    benchStats(1000000);
+    return 0;
+}
@@ -0,0 +1,342 @@
+#ifndef BENCH_SUITE_HPP
+#define BENCH_SUITE_HPP
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <cxxabi.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <serializer/serializer.hpp>
+#include <serializer/tools/alloc_stats.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/******************************************************************************/
+/*                                   suite                                    */
+/******************************************************************************/
+
+/// @brief Prevent the compiler from removing the computation of value.
+template <typename T> inline void doNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// @brief Time of a hand-written encoder used as a reference.
+struct BaselineResult {
+    std::string name;         ///< name of the baseline
+    size_t bytes = 0;         ///< encoded size of one object
+    double serializeNs = 0;   ///< time of one encoding
+    double deserializeNs = 0; ///< time of one decoding
+};
+
+/// @brief Result of the benchmark of one type.
+struct SuiteResult {
+    std::string category;     ///< type category
+    std::string name;         ///< name of the benchmark
+    size_t bytes = 0;         ///< serialized size of one object
+    double serializeNs = 0;   ///< time of one serialization
+    double deserializeNs = 0; ///< time of one deserialization
+    double memcpyNs = 0;      ///< copy of the same number of bytes
+    std::vector<BaselineResult> baselines; ///< hand-written encoders
+    serializer::tools::AllocReport serializeAllocs;   ///< one serialization
+    serializer::tools::AllocReport deserializeAllocs; ///< one deserialization
+
+    /// @brief Throughput in MB/s for a time per object in ns.
+    double throughput(double ns) const {
+        return ns > 0 ? double(bytes) / ns * 1e3 : 0;
+    }
+
+};
+
+/// @brief Benchmark of the serialization and the deserialization of objects.
+///        Each operation is repeated until it runs for at least minTime (the
+///        number of iterations doubles each time), and the time of the last
+///        run is reported. The serialization reuses the same buffer (steady
+///        state), and each deserialization creates a new object.
+///        The time of a copy of the serialized bytes with memcpy is reported
+///        next to each result (it is not a ratio: the small objects are
+///        copied faster by the inlined code of the serializer than by a
+///        memcpy of a runtime size), as well as the baselines added with
+///        baseline (hand-rolled or iostream encoders of the same data).
+///        The allocations of one serialization and one deserialization are
+///        counted by the operator new hooks (SERIALIZER_ALLOC_HOOKS, defined
+///        by the benchmark with SERIALIZER_ALLOC_STATS), the objects created
+///        for each type are counted when the serializer is compiled with
+///        SERIALIZER_ALLOC_STATS. The serialization in the reused buffer
+///        should never allocate (std::logic_error otherwise). Without the
+///        hooks, no allocation is counted.
+class Suite {
+  public:
+    /// @brief Constructor.
+    /// @param minTime Minimum duration of the measurements.
+    explicit Suite(std::chrono::nanoseconds minTime = std::chrono::milliseconds(
+                       100))
+        : minTime_(minTime) {}
+
+    /// @brief Results of the benchmarks.
+    std::vector<SuiteResult> const &results() const { return results_; }
+
+    /// @brief Measure the time of one call to fun (ns).
+    template <typename F> double measure(F &&fun) const {
+        fun(); // warm up
+        for (size_t iterations = 1;; iterations *= 2) {
+            auto begin = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                fun();
+            }
+            auto elapsed = std::chrono::steady_clock::now() - begin;
+            if (elapsed >= minTime_ || iterations >= (size_t(1) << 40)) {
+                return double(std::chrono::nanoseconds(elapsed).count()) /
+                       double(iterations);
+            }
+        }
+    }
+
+    /// @brief Benchmark the serialization and the deserialization of obj.
+    /// @param category Category of the type.
+    /// @param name Name of the benchmark.
+    /// @param obj Serialized object.
+    /// @param release Function called on the deserialized objects before
+    ///                their destruction (to free the memory they own).
+    /// @return Result (see baseline).
+    template <typename T>
+    SuiteResult &run(std::string const &category, std::string const &name,
+                     T const &obj,
+                     std::function<void(T &)> const &release = nullptr) {
+        SuiteResult result;
+        serializer::Bytes mem;
+
+        result.category = category;
+        result.name = name;
+        result.bytes = obj.serialize(mem);
+        result.serializeNs = measure([&] {
+            size_t pos = obj.serialize(mem);
+            doNotOptimize(pos);
+            doNotOptimize(mem.data());
+        });
+        result.deserializeNs = measure([&] {
+            T out;
+            size_t pos = out.deserialize(mem);
+            doNotOptimize(pos);
+            doNotOptimize(out);
+            if (release) {
+                release(out);
+            }
+        });
+
+        // allocations
+        result.serializeAllocs =
+            serializer::tools::countAllocations([&] { obj.serialize(mem); });
+        T out;
+        result.deserializeAllocs =
+            serializer::tools::countAllocations([&] { out.deserialize(mem); });
+        if (release) {
+            release(out);
+        }
+        if (result.serializeAllocs.heap.allocations > 0) {
+            throw std::logic_error("error: the serialization of " + name +
+                                   " allocates.");
+        }
+
+        // reference: copy of the serialized bytes
+        serializer::Bytes copy(result.bytes, result.bytes);
+        result.memcpyNs = measure([&] {
+            std::memcpy(copy.data(), mem.data(), result.bytes);
+            doNotOptimize(copy.data());
+        });
+        print(result);
+        results_.push_back(result);
+        return results_.back();
+    }
+
+    /// @brief Benchmark an encoder of the same data as a result.
+    /// @param result Result of the serializer.
+    /// @param name Name of the baseline.
+    /// @param encode Function that encodes the data (returns the number of
+    ///               bytes).
+    /// @param decode Function that decodes the data.
+    void baseline(SuiteResult &result, std::string const &name, auto &&encode,
+                  auto &&decode) {
+        BaselineResult baseline;
+
+        baseline.name = name;
+        baseline.bytes = encode();
+        baseline.serializeNs = measure([&] { doNotOptimize(encode()); });
+        baseline.deserializeNs = measure([&] { decode(); });
+        std::cout << std::left << std::setw(16) << "" << std::setw(28)
+                  << ("  " + name);
+        printTimes(baseline.bytes, baseline.serializeNs,
+                   baseline.deserializeNs);
+        result.baselines.push_back(baseline);
+    }
+
+    /// @brief Check that the deserialization of a result does not allocate.
+    /// @return The result.
+    /// @throw std::logic_error when the deserialization allocates.
+    static SuiteResult &requireNoAllocations(SuiteResult &result) {
+        if (result.deserializeAllocs.heap.allocations > 0) {
+            throw std::logic_error("error: the deserialization of " +
+                                   result.name + " allocates.");
+        }
+        return result;
+    }
+
+    /// @brief Print the header of the table.
+    static void printHeader() {
+        std::cout << std::left << std::setw(16) << "category" << std::setw(28)
+                  << "name" << std::right << std::setw(12) << "bytes/obj"
+                  << std::setw(26) << "serialize (MB/s)" << std::setw(26)
+                  << "deserialize (MB/s)" << std::setw(14) << "memcpy"
+                  << std::endl;
+    }
+
+    /// @brief Print the total time of the results of each category, and the
+    ///        time of the memcpy of the same bytes.
+    void printSummary() const {
+        std::cout << std::endl
+                  << std::left << std::setw(16) << "category" << std::right
+                  << std::setw(16) << "serialize" << std::setw(16)
+                  << "deserialize" << std::setw(16) << "memcpy"
+                  << "  (ns, all the results)" << std::endl;
+        for (auto const &[category, totals] : categories()) {
+            std::cout << std::left << std::setw(16) << category << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(13)
+                      << totals.serialize << " ns" << std::setw(13)
+                      << totals.deserialize << " ns" << std::setw(13)
+                      << totals.memcpy << " ns" << std::endl;
+        }
+    }
+
+    /// @brief Print the allocations of one deserialization of each result,
+    ///        and the objects created for each type (SERIALIZER_ALLOC_STATS).
+    void printAllocations() const {
+        std::cout << std::endl
+                  << std::left << std::setw(16) << "category" << std::setw(28)
+                  << "name" << std::right << std::setw(24)
+                  << "deserialize (allocs)" << std::setw(16) << "bytes"
+                  << std::setw(16) << "created" << std::endl;
+        for (SuiteResult const &r : results_) {
+            std::cout << std::left << std::setw(16) << r.category
+                      << std::setw(28) << r.name << std::right << std::setw(24)
+                      << r.deserializeAllocs.heap.allocations << std::setw(16)
+                      << r.deserializeAllocs.heap.bytes << std::setw(16)
+                      << r.deserializeAllocs.objects.allocations << std::endl;
+            for (auto const &[type, stats] : r.deserializeAllocs.types) {
+                std::cout << std::left << std::setw(16) << ""
+                          << ("  " + typeName(*type)) << ": "
+                          << stats.allocations << " (" << stats.bytes << " B)"
+                          << std::endl;
+            }
+        }
+    }
+
+    /// @brief Write the results in JSON.
+    void json(std::ostream &os) const {
+        os << "{\n  \"results\": [\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            SuiteResult const &r = results_[i];
+            os << "    {\"category\": \"" << r.category << "\", \"name\": \""
+               << r.name << "\", \"bytes_per_object\": " << r.bytes
+               << ", \"serialize_ns_per_op\": " << r.serializeNs
+               << ", \"serialize_mb_per_s\": " << r.throughput(r.serializeNs)
+               << ", \"deserialize_ns_per_op\": " << r.deserializeNs
+               << ", \"deserialize_mb_per_s\": "
+               << r.throughput(r.deserializeNs)
+               << ", \"memcpy_ns_per_op\": " << r.memcpyNs
+               << ", \"deserialize_allocations\": "
+               << r.deserializeAllocs.heap.allocations
+               << ", \"deserialize_allocated_bytes\": "
+               << r.deserializeAllocs.heap.bytes << ", \"created\": [";
+            for (size_t j = 0; j < r.deserializeAllocs.types.size(); ++j) {
+                auto const &[type, stats] = r.deserializeAllocs.types[j];
+                os << (j > 0 ? ", " : "") << "{\"type\": \""
+                   << typeName(*type)
+                   << "\", \"allocations\": " << stats.allocations
+                   << ", \"bytes\": " << stats.bytes << "}";
+            }
+            os << "], \"baselines\": [";
+            for (size_t j = 0; j < r.baselines.size(); ++j) {
+                BaselineResult const &b = r.baselines[j];
+                os << (j > 0 ? ", " : "") << "{\"name\": \"" << b.name
+                   << "\", \"bytes_per_object\": " << b.bytes
+                   << ", \"serialize_ns_per_op\": " << b.serializeNs
+                   << ", \"deserialize_ns_per_op\": " << b.deserializeNs
+                   << "}";
+            }
+            os << "]}" << (i + 1 < results_.size() ? "," : "") << "\n";
+        }
+        os << "  ],\n  \"categories\": [\n";
+        auto totals = categories();
+        size_t i = 0;
+        for (auto const &[category, total] : totals) {
+            os << "    {\"category\": \"" << category
+               << "\", \"serialize_ns\": " << total.serialize
+               << ", \"deserialize_ns\": " << total.deserialize
+               << ", \"memcpy_ns\": " << total.memcpy << "}"
+               << (++i < totals.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+
+  private:
+    /// @brief Total times of the results of a category (ns).
+    struct CategoryTotals {
+        double serialize = 0;   ///< serialization
+        double deserialize = 0; ///< deserialization
+        double memcpy = 0;      ///< copy of the serialized bytes
+    };
+
+    std::chrono::nanoseconds minTime_; ///< duration of the measurements
+    std::vector<SuiteResult> results_; ///< results
+
+    /// @brief Demangled name of a type.
+    static std::string typeName(std::type_info const &type) {
+        int status = 0;
+        char *name =
+            abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        std::string result = status == 0 ? name : type.name();
+        std::free(name);
+        return result;
+    }
+
+    /// @brief Total times of the results of each category.
+    std::map<std::string, CategoryTotals> categories() const {
+        std::map<std::string, CategoryTotals> totals;
+
+        for (SuiteResult const &r : results_) {
+            CategoryTotals &t = totals[r.category];
+            t.serialize += r.serializeNs;
+            t.deserialize += r.deserializeNs;
+            t.memcpy += r.memcpyNs;
+        }
+        return totals;
+    }
+
+    /// @brief Print the size, the times and the throughputs (and the time
+    ///        of the memcpy when memcpyNs is not 0).
+    static void printTimes(size_t bytes, double serializeNs,
+                           double deserializeNs, double memcpyNs = 0) {
+        auto mbs = [&](double ns) { return double(bytes) / ns * 1e3; };
+        std::cout << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << bytes << " B" << std::setw(12)
+                  << serializeNs << " ns" << std::setw(11) << mbs(serializeNs)
+                  << std::setw(12) << deserializeNs << " ns" << std::setw(11)
+                  << mbs(deserializeNs);
+        if (memcpyNs > 0) {
+            std::cout << std::setw(11) << memcpyNs << " ns";
+        }
+        std::cout << std::endl;
+    }
+
+    /// @brief Print a result as a line of the table.
+    static void print(SuiteResult const &result) {
+        std::cout << std::left << std::setw(16) << result.category
+                  << std::setw(28) << result.name;
+        printTimes(result.bytes, result.serializeNs, result.deserializeNs,
+                   result.memcpyNs);
+    }
+};
+
+#endif
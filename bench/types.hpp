@@ -0,0 +1,469 @@
+#ifndef BENCH_TYPES_HPP
+#define BENCH_TYPES_HPP
+#include "bench/suite.hpp"
+#include "test-classes/abstract.hpp"
+#include "test-classes/cstruct.h"
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+#include "test-classes/tree.hpp"
+#include "test-classes/withsmartptr.hpp"
+#include "test-classes/withstaticarrays.hpp"
+#include "test-classes/withtuple.hpp"
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <span>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/******************************************************************************/
+/*                               benched types                                */
+/******************************************************************************/
+
+/// @brief Trivial struct serialized with one copy.
+struct BenchCStruct {
+    CStruct value;
+    SERIALIZE(value);
+};
+
+struct BenchString {
+    std::string str;
+    SERIALIZE(str);
+};
+
+template <typename T> struct BenchVector {
+    std::vector<T> elts;
+    SERIALIZE(elts);
+};
+
+template <typename K, typename V> struct BenchMap {
+    std::map<K, V> elts;
+    SERIALIZE(elts);
+};
+
+template <typename T> struct BenchSet {
+    std::set<T> elts;
+    SERIALIZE(elts);
+};
+
+struct BenchDynamicArray {
+    BenchDynamicArray() = default;
+    explicit BenchDynamicArray(size_t size)
+        : size(size), data(new double[size]) {
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = double(i);
+        }
+    }
+    BenchDynamicArray(BenchDynamicArray const &) = delete;
+    ~BenchDynamicArray() { delete[] data; }
+
+    SERIALIZE(size, SER_DARR(data, size));
+
+    size_t size = 0;
+    double *data = nullptr;
+};
+
+struct BenchSharedPtrs {
+    std::vector<std::shared_ptr<Simple>> elts;
+    SERIALIZE(elts);
+};
+
+/******************************************************************************/
+/*                                 baselines                                  */
+/******************************************************************************/
+
+/// @brief Hand-rolled encoder: the fields are copied one by one in the
+///        buffer without any dispatch, the containers of trivial types are
+///        copied in one block and prefixed by their size.
+namespace hand {
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+inline void put(serializer::Bytes &mem, size_t &pos, T const &value) {
+    mem.upsize(pos + sizeof(T));
+    std::memcpy(mem.data() + pos, &value, sizeof(T));
+    pos += sizeof(T);
+    mem.resize(pos);
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+inline void put(serializer::Bytes &mem, size_t &pos,
+                std::span<T const> values) {
+    put(mem, pos, values.size());
+    mem.upsize(pos + values.size_bytes());
+    std::memcpy(mem.data() + pos, values.data(), values.size_bytes());
+    pos += values.size_bytes();
+    mem.resize(pos);
+}
+
+inline void put(serializer::Bytes &mem, size_t &pos, std::string const &str) {
+    put(mem, pos, std::span<char const>(str));
+}
+
+template <typename T>
+inline void put(serializer::Bytes &mem, size_t &pos,
+                std::vector<T> const &values) {
+    put(mem, pos, std::span<T const>(values));
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+inline void get(serializer::Bytes const &mem, size_t &pos, T &value) {
+    std::memcpy(&value, mem.data() + pos, sizeof(T));
+    pos += sizeof(T);
+}
+
+template <typename T>
+inline void get(serializer::Bytes const &mem, size_t &pos,
+                std::span<T> values) {
+    std::memcpy(values.data(), mem.data() + pos, values.size_bytes());
+    pos += values.size_bytes();
+}
+
+inline void get(serializer::Bytes const &mem, size_t &pos, std::string &str) {
+    size_t size = 0;
+    get(mem, pos, size);
+    str.resize(size);
+    get(mem, pos, std::span<char>(str));
+}
+
+template <typename T>
+inline void get(serializer::Bytes const &mem, size_t &pos,
+                std::vector<T> &values) {
+    size_t size = 0;
+    get(mem, pos, size);
+    values.resize(size);
+    get(mem, pos, std::span<T>(values));
+}
+
+} // end namespace hand
+
+/// @brief iostream encoder: the values are written in text separated by
+///        spaces, and the strings are prefixed by their size.
+namespace text {
+
+template <typename T> inline void put(std::ostream &os, T const &value) {
+    os << value << ' ';
+}
+
+template <typename T>
+inline void put(std::ostream &os, std::span<T const> values) {
+    os << values.size() << ' ';
+    for (T const &value : values) {
+        put(os, value);
+    }
+}
+
+inline void put(std::ostream &os, std::string const &str) {
+    os << str.size() << ' ';
+    os.write(str.data(), std::streamsize(str.size()));
+}
+
+template <typename T>
+inline void put(std::ostream &os, std::vector<T> const &values) {
+    put(os, std::span<T const>(values));
+}
+
+template <typename T> inline void get(std::istream &is, T &value) {
+    is >> value;
+}
+
+template <typename T> inline void get(std::istream &is, std::span<T> values) {
+    for (T &value : values) {
+        get(is, value);
+    }
+}
+
+inline void get(std::istream &is, std::string &str) {
+    size_t size = 0;
+    is >> size;
+    is.get();
+    str.resize(size);
+    is.read(str.data(), std::streamsize(size));
+}
+
+template <typename T>
+inline void get(std::istream &is, std::vector<T> &values) {
+    size_t size = 0;
+    is >> size;
+    values.resize(size);
+    get(is, std::span<T>(values));
+}
+
+} // end namespace text
+
+/// @brief Benchmark the hand-rolled and the iostream encoders of an object.
+/// @param write Function that writes the fields of the object with
+///              put(values...).
+/// @param read Function that reads the fields of an object with
+///             get(values &...).
+inline void baselines(Suite &suite, SuiteResult &result, auto &&write,
+                      auto &&read) {
+    // hand-rolled
+    serializer::Bytes mem;
+    size_t pos = 0;
+    auto handPut = [&](auto const &...values) {
+        (hand::put(mem, pos, values), ...);
+    };
+    auto handGet = [&](auto &&...values) {
+        (hand::get(mem, pos, values), ...);
+    };
+    suite.baseline(
+        result, "hand-rolled",
+        [&] {
+            pos = 0;
+            write(handPut);
+            return pos;
+        },
+        [&] {
+            pos = 0;
+            read(handGet);
+        });
+
+    // iostream (the streams are reused)
+    std::stringstream os, is;
+    os.precision(std::numeric_limits<double>::max_digits10);
+    auto textPut = [&](auto const &...values) { (text::put(os, values), ...); };
+    auto textGet = [&](auto &&...values) { (text::get(is, values), ...); };
+    auto encode = [&] {
+        os.seekp(0);
+        write(textPut);
+        return size_t(os.tellp());
+    };
+    size_t size = encode();
+    is.str(os.str().substr(0, size));
+    suite.baseline(result, "iostream", encode, [&] {
+        is.clear();
+        is.seekg(0);
+        read(textGet);
+    });
+}
+
+/******************************************************************************/
+/*                                 categories                                 */
+/******************************************************************************/
+
+/// @brief Benchmark one or two types of each category supported by the
+///        serializer.
+inline void benchTypes(Suite &suite) {
+    std::mt19937 gen(0);
+
+    Suite::printHeader();
+
+    // trivial structs
+    CStructSerializable cstruct('c', 1, 2, 3.f, 4.);
+    Suite::requireNoAllocations(suite.run(
+        "trivial", "CStruct (copy)", BenchCStruct{{'c', 1, 2, 3.f, 4.}}));
+    baselines(
+        suite,
+        Suite::requireNoAllocations(
+            suite.run("trivial", "CStructSerializable", cstruct)),
+        [&](auto &&put) {
+            put(cstruct.c(), cstruct.i(), cstruct.l(), cstruct.f(),
+                cstruct.d());
+        },
+        [](auto &&get) {
+            char c;
+            int i;
+            long l;
+            float f;
+            double d;
+            get(c, i, l, f, d);
+            doNotOptimize(CStructSerializable(c, i, l, f, d));
+        });
+
+    // strings
+    BenchString str{std::string(4096, 'x')};
+    suite.run("string", "string (16)", BenchString{std::string(16, 'x')});
+    baselines(
+        suite, suite.run("string", "string (4096)", str),
+        [&](auto &&put) { put(str.str); },
+        [](auto &&get) {
+            BenchString out;
+            get(out.str);
+            doNotOptimize(out);
+        });
+
+    // vectors
+    BenchVector<int> ints;
+    BenchVector<Simple> simples;
+    for (int i = 0; i < 1000; ++i) {
+        ints.elts.push_back(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        simples.elts.emplace_back(i, i, "simple " + std::to_string(i));
+    }
+    baselines(
+        suite, suite.run("vector", "vector<int> (1000)", ints),
+        [&](auto &&put) { put(ints.elts); },
+        [](auto &&get) {
+            BenchVector<int> out;
+            get(out.elts);
+            doNotOptimize(out);
+        });
+    baselines(
+        suite, suite.run("vector", "vector<Simple> (100)", simples),
+        [&](auto &&put) {
+            put(simples.elts.size());
+            for (Simple const &simple : simples.elts) {
+                put(simple.x(), simple.y(), simple.str());
+            }
+        },
+        [](auto &&get) {
+            BenchVector<Simple> out;
+            size_t size = 0;
+            get(size);
+            out.elts.resize(size);
+            for (Simple &simple : out.elts) {
+                int x, y;
+                std::string str;
+                get(x, y, str);
+                simple = Simple(x, y, std::move(str));
+            }
+            doNotOptimize(out);
+        });
+
+    // maps and sets
+    BenchMap<int, std::string> map;
+    BenchSet<std::string> strings;
+    BenchSet<int> set;
+    for (int i = 0; i < 100; ++i) {
+        map.elts.emplace(i, "value " + std::to_string(i));
+        strings.elts.insert("element " + std::to_string(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        set.elts.insert(i);
+    }
+    baselines(
+        suite, suite.run("map", "map<int, string> (100)", map),
+        [&](auto &&put) {
+            put(map.elts.size());
+            for (auto const &[key, value] : map.elts) {
+                put(key, value);
+            }
+        },
+        [](auto &&get) {
+            BenchMap<int, std::string> out;
+            size_t size = 0;
+            get(size);
+            for (size_t i = 0; i < size; ++i) {
+                int key;
+                std::string value;
+                get(key, value);
+                out.elts.emplace_hint(out.elts.end(), key, std::move(value));
+            }
+            doNotOptimize(out);
+        });
+    suite.run("set", "set<string> (100)", strings);
+    baselines(
+        suite, suite.run("set", "set<int> (1000)", set),
+        [&](auto &&put) {
+            put(set.elts.size());
+            for (int value : set.elts) {
+                put(value);
+            }
+        },
+        [](auto &&get) {
+            BenchSet<int> out;
+            size_t size = 0;
+            get(size);
+            for (size_t i = 0; i < size; ++i) {
+                int value;
+                get(value);
+                out.elts.emplace_hint(out.elts.end(), value);
+            }
+            doNotOptimize(out);
+        });
+
+    // tuples
+    suite.run("tuple", "WithTuple",
+              WithTuple(1, 2, 3.0, "str1", "str2", "str3", Simple(1, 2, "s"),
+                        Composed(Simple(3, 4, "c"), 5, 6.0), {1, 2, 3},
+                        {"a", "b", "c"}, {{"k1", "v1"}, {"k2", "v2"}},
+                        new int(7), new double(8)));
+
+    // static arrays
+    WithStaticArrays arrays;
+    for (size_t i = 0; i < 10; ++i) {
+        arrays.arr(i) = int(i);
+        for (size_t j = 0; j < 10; ++j) {
+            arrays.grid(i, j) = int(i * j);
+            arrays.tensor(i, j, 0) = int(i);
+            arrays.tensor(i, j, 1) = int(j);
+        }
+    }
+    Suite::requireNoAllocations(
+        suite.run("static array", "WithStaticArrays", arrays));
+
+    // dynamic arrays
+    BenchDynamicArray array(1000);
+    baselines(
+        suite, suite.run("dynamic array", "DynamicArray<double> (1000)", array),
+        [&](auto &&put) {
+            put(std::span<double const>(array.data, array.size));
+        },
+        [](auto &&get) {
+            BenchDynamicArray out;
+            get(out.size);
+            out.data = new double[out.size];
+            get(std::span<double>(out.data, out.size));
+            doNotOptimize(out);
+        });
+
+    // smart pointers
+    BenchSharedPtrs ptrs;
+    for (int i = 0; i < 100; ++i) {
+        ptrs.elts.push_back(std::make_shared<Simple>(i, i, "ptr"));
+    }
+    Suite::requireNoAllocations(suite.run("smart pointer", "WithSmartPtr",
+                                          WithSmartPtr(1, 2.0, "str")));
+    suite.run("smart pointer", "vector<shared_ptr> (100)", ptrs);
+
+    // polymorphic types
+    AbstractCollection collection;
+    for (int i = 0; i < 50; ++i) {
+        collection.push_back(std::make_shared<Concrete1>(i, double(i)));
+        collection.push_back(
+            std::make_shared<Concrete2>("concrete " + std::to_string(i)));
+    }
+    suite.run("polymorphic", "AbstractCollection (100)", collection);
+
+    // trees
+    Tree<int> tree;
+    std::uniform_int_distribution<int> values(0, 1 << 20);
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(values(gen));
+    }
+    suite.run("tree", "Tree<int> (1000)", tree);
+
+    // hedgehog pipeline types
+    constexpr size_t size = 64, blockSize = 16;
+    std::vector<double> data(size * size, 1.0);
+    Matrix<double> matrix(size, size, blockSize, data.data());
+    MatrixBlock<double, Input> block(0, 0, size, size, blockSize,
+                                     size * size, data.data());
+    PartialSum<double> sum;
+    sum.value = 42;
+    suite.run<Matrix<double>>("hedgehog", "Matrix (64x64)", matrix,
+                              [](Matrix<double> &m) { delete[] m.data(); });
+    suite.run<MatrixBlock<double, Input>>(
+        "hedgehog", "MatrixBlock (64x64)", block,
+        [](MatrixBlock<double, Input> &b) { delete[] b.data(); });
+    baselines(
+        suite,
+        Suite::requireNoAllocations(suite.run("hedgehog", "PartialSum", sum)),
+        [&](auto &&put) { put(sum.value); },
+        [](auto &&get) {
+            PartialSum<double> out;
+            get(out.value);
+            doNotOptimize(out);
+        });
+}
+
+#endif
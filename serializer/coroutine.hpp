@@ -0,0 +1,609 @@
+#ifndef SERIALIZER_COROUTINE_H
+#define SERIALIZER_COROUTINE_H
+#include "meta/concepts.hpp"
+#include "meta/fixed_size.hpp"
+#include "meta/members.hpp"
+#include "serialize.hpp"
+#include "serializer/serializer.hpp"
+#include "tools/coroutine.hpp"
+#include "tools/tools.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @file Asynchronous serialization using C++20 coroutines. The serialization
+///       suspends when the output buffer is full and the deserialization when
+///       the input data has not been received yet, so one thread can handle
+///       many partially sent or received messages. The members described by
+///       the SERIALIZE macros, the elements of the tuples, of the containers
+///       (including the Parallel and Chunked wrappers) and of the dynamic
+///       arrays, and the values of the pointers are processed one by one
+///       (the trivial dynamic arrays are copied in pieces). The values which
+///       serialized size is fixed are processed directly (without creating a
+///       coroutine). The other values (polymorphic objects, offset tables,
+///       custom serializers, ...) are (de)serialized by the Serializer in one
+///       step.
+
+/// @brief serializer namespace
+namespace serializer {
+
+/// @brief Default serializer of the asynchronous output.
+using AsyncOutputSerializer = Serializer<tools::AsyncOutput &>;
+
+/// @brief Default serializer of the asynchronous input.
+using AsyncInputSerializer = Serializer<tools::AsyncInput &>;
+
+/* helpers ********************************************************************/
+
+/// @brief Types which members are processed one by one (SERIALIZE macros
+///        without offset table, non polymorphic).
+template <typename T, typename MemT>
+concept AsyncMembers = mtf::has_members_v<T, MemT> &&
+                       !mtf::has_table_v<T, MemT> &&
+                       !std::is_polymorphic_v<mtf::clean_t<T>>;
+
+/// @brief Types serialized by a custom function of the serializer (processed
+///        in one step).
+template <typename T, typename Ser>
+concept AsyncCustom = std::is_base_of_v<Serialize<mtf::clean_t<T>>, Ser>;
+
+/// @brief Pointers which value is processed by a coroutine (the polymorphic
+///        types are processed in one step).
+template <typename T>
+concept AsyncPointer =
+    concepts::ConcretePtr<T> &&
+    !std::is_polymorphic_v<
+        std::remove_cvref_t<decltype(*std::declval<mtf::clean_t<T> &>())>>;
+
+/// @brief Containers which elements are processed one by one.
+template <typename T, typename MemT>
+concept AsyncContainer = concepts::Container<T> && !concepts::Trivial<T> &&
+                         !concepts::Serializable<T, MemT> &&
+                         !concepts::Deserializable<T, MemT>;
+
+/// @brief Fixed serialized sizes of the elements of a tuple type.
+template <typename Tuple, typename Ser, size_t... Idx>
+constexpr auto asyncFixedSizes_(std::index_sequence<Idx...>) {
+    return std::array<size_t, sizeof...(Idx)>{
+        mtf::fixed_serialized_size_v<std::tuple_element_t<Idx, Tuple>,
+                                     Ser>...};
+}
+
+/// @brief Call fun on the element idx of a tuple (runtime index).
+/// @return Result of fun.
+template <size_t... Idx>
+inline auto asyncVisit_(auto &tuple, size_t idx, auto &&fun,
+                        std::index_sequence<Idx...>) {
+    decltype(fun(std::get<0>(tuple))) result{};
+    ((idx == Idx ? (void)(result = fun(std::get<Idx>(tuple))) : void()), ...);
+    return result;
+}
+
+/// @brief Call fun on the element idx of a tuple (runtime index).
+/// @return Result of fun.
+inline auto asyncVisit(auto &tuple, size_t idx, auto &&fun) {
+    return asyncVisit_(
+        tuple, idx, fun,
+        std::make_index_sequence<std::tuple_size_v<mtf::clean_t<decltype(
+            tuple)>>>());
+}
+
+/******************************************************************************/
+/*                                 serialize                                  */
+/******************************************************************************/
+
+template <typename Ser>
+tools::Task<size_t> serializeAsync(tools::AsyncOutput &out, auto const &elt);
+
+/// @brief Append bytes to the asynchronous output in pieces that fit in its
+///        capacity (the task suspends when the output is full).
+/// @param out Asynchronous output.
+/// @param bytes Bytes to append (should outlive the task).
+/// @param nbBytes Number of bytes.
+/// @return Task which result is the end of the output.
+inline tools::Task<size_t> asyncAppend_(tools::AsyncOutput &out,
+                                        std::byte const *bytes,
+                                        size_t nbBytes) {
+    size_t capacity = std::max<size_t>(out.capacity(), 1);
+
+    while (nbBytes > 0) {
+        size_t pending = out.pending().size();
+        if (pending >= capacity) {
+            co_await tools::park;
+            continue;
+        }
+        size_t count = std::min(nbBytes, capacity - pending);
+        out.append(out.size(), bytes, count);
+        bytes += count;
+        nbBytes -= count;
+    }
+    co_return out.size();
+}
+
+/// @brief Serialize a value in one step (last resort for the types that are
+///        not split). The value is written directly when it fits in the
+///        capacity of the output, otherwise it is serialized in a temporary
+///        output that is copied in pieces.
+template <typename Ser>
+tools::Task<size_t> serializeAsyncWhole_(tools::AsyncOutput &out,
+                                         auto const &elt) {
+    size_t nbBytes = Ser(out, out.size()).measure(elt);
+
+    if (nbBytes <= out.capacity()) {
+        while (!out.hasSpace(nbBytes)) {
+            co_await tools::park;
+        }
+        co_return serialize<Ser>(out, out.size(), elt);
+    }
+    tools::AsyncOutput whole(nbBytes);
+    serialize<Ser>(whole, 0, elt);
+    auto data = whole.pending();
+    co_return co_await asyncAppend_(out, data.data(), data.size());
+}
+
+/// @brief Serialize the elements of a tuple (or of the tuple of members) one
+///        by one.
+template <typename Ser>
+tools::Task<size_t> serializeAsyncTuple_(tools::AsyncOutput &out,
+                                         auto const &tuple) {
+    using Tuple = mtf::clean_t<decltype(tuple)>;
+    constexpr auto sizes = asyncFixedSizes_<Tuple, Ser>(
+        std::make_index_sequence<std::tuple_size_v<Tuple>>());
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i] != mtf::dynamic_size) {
+            while (!out.hasSpace(sizes[i])) {
+                co_await tools::park;
+            }
+            asyncVisit(tuple, i, [&](auto const &member) {
+                return serialize<Ser>(out, out.size(), member);
+            });
+        } else {
+            co_await asyncVisit(tuple, i, [&](auto const &member) {
+                return serializeAsync<Ser>(out, member);
+            });
+        }
+    }
+    co_return out.size();
+}
+
+/// @brief Serialize the elements of a container one by one.
+template <typename Ser>
+tools::Task<size_t> serializeAsyncElements_(tools::AsyncOutput &out,
+                                            auto const &elts) {
+    using ValueType =
+        mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<decltype(elts)>>>;
+    constexpr size_t value_size = mtf::fixed_serialized_size_v<ValueType, Ser>;
+
+    for (auto const &value : elts) {
+        if constexpr (value_size != mtf::dynamic_size) {
+            while (!out.hasSpace(value_size)) {
+                co_await tools::park;
+            }
+            serialize<Ser>(out, out.size(), value);
+        } else {
+            co_await serializeAsync<Ser>(out, value);
+        }
+    }
+    co_return out.size();
+}
+
+/// @brief Serialize elt into the asynchronous output. The task suspends when
+///        the output is full: the user sends the pending data, consumes it and
+///        resumes the task until it is done. The output and elt should outlive
+///        the task.
+/// @tparam Ser Serializer type (same as the one used by the SERIALIZE macros).
+/// @param out Asynchronous output.
+/// @param elt Element to serialize.
+/// @return Task which result is the position of the end of the element.
+template <typename Ser = AsyncOutputSerializer>
+tools::Task<size_t> serializeAsync(tools::AsyncOutput &out,
+                                   auto const &elt) {
+    using T = mtf::clean_t<decltype(elt)>;
+    using MemT = tools::AsyncOutput;
+
+    if constexpr (concepts::FixedSize<T, Ser>) {
+        constexpr size_t size = mtf::fixed_serialized_size_v<T, Ser>;
+        while (!out.hasSpace(size)) {
+            co_await tools::park;
+        }
+        serialize<Ser>(out, out.size(), elt);
+    } else if constexpr (AsyncCustom<T, Ser>) {
+        co_await serializeAsyncWhole_<Ser>(out, elt);
+    } else if constexpr (AsyncMembers<T, MemT>) {
+        auto members = elt.serializerMembers(out);
+        co_await serializeAsyncTuple_<Ser>(out, members);
+    } else if constexpr (concepts::TupleLike<T>) {
+        co_await serializeAsyncTuple_<Ser>(out, elt);
+    } else if constexpr (AsyncContainer<T, MemT>) {
+        auto size = elt.size();
+
+        while (!out.hasSpace(sizeof(size))) {
+            co_await tools::park;
+        }
+        serialize<Ser>(out, out.size(), size);
+        co_await serializeAsyncElements_<Ser>(out, elt);
+    } else if constexpr (mtf::is_parallel_v<T>) {
+        // same data as the container
+        co_await serializeAsync<Ser>(out, elt.container);
+    } else if constexpr (mtf::is_chunked_v<T>) {
+        // same as Serializer::serialize_(Chunked) with a stream: the elements
+        // are measured to compute the ends of the chunks
+        auto size = std::size(elt.container);
+        size_t chunkSize = elt.chunkSize;
+        size_t nbBytes = 0;
+        size_t i = 0;
+        std::vector<size_t> ends;
+
+        for (auto const &value : elt.container) {
+            nbBytes += Ser(out, out.size()).measure(value);
+            if (++i % chunkSize == 0 || i == size_t(size)) {
+                ends.push_back(nbBytes);
+            }
+        }
+        while (!out.hasSpace(sizeof(size))) {
+            co_await tools::park;
+        }
+        serialize<Ser>(out, out.size(), size);
+        for (size_t value : {chunkSize, nbBytes}) {
+            while (!out.hasSpace(sizeof(value))) {
+                co_await tools::park;
+            }
+            serialize<Ser>(out, out.size(), value);
+        }
+        co_await serializeAsyncElements_<Ser>(out, elt.container);
+        co_await asyncAppend_(out,
+                              std::bit_cast<std::byte const *>(ends.data()),
+                              ends.size() * sizeof(size_t));
+    } else if constexpr (AsyncPointer<T>) {
+        while (!out.hasSpace(sizeof(char))) {
+            co_await tools::park;
+        }
+        serialize<Ser>(out, out.size(), elt == nullptr ? 'n' : 'v');
+        if (elt != nullptr) {
+            co_await serializeAsync<Ser>(out, *elt);
+        }
+    } else if constexpr (mtf::is_dynamic_array_v<T>) {
+        // same as Serializer::serialize_(DynamicArray)
+        using ST = std::remove_pointer_t<mtf::clean_t<decltype(elt.mem)>>;
+        constexpr size_t value_size = mtf::fixed_serialized_size_v<ST, Ser>;
+
+        while (!out.hasSpace(sizeof(char))) {
+            co_await tools::park;
+        }
+        serialize<Ser>(out, out.size(), elt.mem == nullptr ? 'n' : 'v');
+        if (elt.mem == nullptr) {
+            co_return out.size();
+        }
+        if constexpr (std::is_pointer_v<ST>) {
+            size_t size = (size_t)std::get<0>(elt.dimensions);
+            for (size_t i = 0; i < size; ++i) {
+                co_await serializeAsync<Ser>(
+                    out, tools::DynamicArray(
+                             elt.mem[i], tools::tuplePopFront(elt.dimensions)));
+            }
+        } else if constexpr (concepts::Trivial<ST> &&
+                             !concepts::Serializable<ST, MemT>) {
+            size_t size = tools::tupleProd<size_t>(elt.dimensions);
+            co_await asyncAppend_(out,
+                                  std::bit_cast<std::byte const *>(elt.mem),
+                                  size * sizeof(ST));
+        } else {
+            size_t size = tools::tupleProd<size_t>(elt.dimensions);
+            for (size_t i = 0; i < size; ++i) {
+                if constexpr (value_size != mtf::dynamic_size) {
+                    while (!out.hasSpace(value_size)) {
+                        co_await tools::park;
+                    }
+                    serialize<Ser>(out, out.size(), elt.mem[i]);
+                } else {
+                    co_await serializeAsync<Ser>(out, elt.mem[i]);
+                }
+            }
+        }
+    } else {
+        co_await serializeAsyncWhole_<Ser>(out, elt);
+    }
+    co_return out.size();
+}
+
+/******************************************************************************/
+/*                                deserialize                                 */
+/******************************************************************************/
+
+template <typename Ser>
+tools::Task<size_t> deserializeAsync(tools::AsyncInput &in, size_t pos,
+                                     auto &elt);
+
+/// @brief Read bytes from the asynchronous input as they are received (the
+///        task suspends when the data has not been received yet).
+/// @param in Asynchronous input.
+/// @param pos Position of the bytes in the input.
+/// @param bytes Destination buffer (should outlive the task).
+/// @param nbBytes Number of bytes.
+/// @return Task which result is the position after the bytes.
+inline tools::Task<size_t> asyncRead_(tools::AsyncInput &in, size_t pos,
+                                      std::byte *bytes, size_t nbBytes) {
+    while (nbBytes > 0) {
+        while (!in.hasData(pos, 1)) {
+            co_await tools::park;
+        }
+        // when the input is closed, read throws std::out_of_range
+        size_t count =
+            in.end() > pos ? std::min(nbBytes, in.end() - pos) : nbBytes;
+        in.read(pos, bytes, count);
+        pos += count;
+        bytes += count;
+        nbBytes -= count;
+        in.release(pos);
+    }
+    co_return pos;
+}
+
+/// @brief Deserialize a value in one step (last resort for the types that
+///        are not split: polymorphic objects, offset tables, custom
+///        serializers, ...). The serialized size of these values is not known
+///        in advance, so when the data is incomplete, the task waits for more
+///        data and the value is deserialized again from the start. The cost
+///        is quadratic in the size of the value, which should stay small.
+template <typename Ser>
+tools::Task<size_t> deserializeAsyncRetry_(tools::AsyncInput &in, size_t pos,
+                                           auto &elt) {
+    while (true) {
+        size_t end = in.end();
+        try {
+            co_return deserialize<Ser>(in, pos, elt);
+        } catch (tools::InputUnderflow const &) {
+        }
+        while (in.end() == end && !in.closed()) {
+            co_await tools::park;
+        }
+    }
+}
+
+/// @brief Deserialize the elements of a tuple (or of the tuple of members)
+///        one by one.
+template <typename Ser>
+tools::Task<size_t> deserializeAsyncTuple_(tools::AsyncInput &in, size_t pos,
+                                           auto &tuple) {
+    using Tuple = mtf::clean_t<decltype(tuple)>;
+    constexpr auto sizes = asyncFixedSizes_<Tuple, Ser>(
+        std::make_index_sequence<std::tuple_size_v<Tuple>>());
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i] != mtf::dynamic_size) {
+            while (!in.hasData(pos, sizes[i])) {
+                co_await tools::park;
+            }
+            pos = asyncVisit(tuple, i, [&](auto &member) {
+                return deserialize<Ser>(in, pos, member);
+            });
+        } else {
+            pos = co_await asyncVisit(tuple, i, [&](auto &member) {
+                return deserializeAsync<Ser>(in, pos, member);
+            });
+        }
+        in.release(pos);
+    }
+    co_return pos;
+}
+
+/// @brief Deserialize the elements of a container one by one (same as
+///        Serializer::deserializeElements).
+template <typename Ser>
+tools::Task<size_t> deserializeAsyncElements_(tools::AsyncInput &in,
+                                              size_t pos, auto &elts,
+                                              size_t size) {
+    using T = mtf::clean_t<decltype(elts)>;
+    using ValueType = mtf::remove_const_t<mtf::iter_value_t<T>>;
+    constexpr size_t value_size = mtf::fixed_serialized_size_v<ValueType, Ser>;
+
+    if constexpr (concepts::ContiguousResizeable<T>) {
+        elts.resize(size);
+    } else if constexpr (concepts::Clearable<T>) {
+        elts.clear();
+    }
+    if constexpr (std::contiguous_iterator<decltype(elts.begin())>) {
+        for (auto &value : elts) {
+            if constexpr (value_size != mtf::dynamic_size) {
+                while (!in.hasData(pos, value_size)) {
+                    co_await tools::park;
+                }
+                pos = deserialize<Ser>(in, pos, value);
+            } else {
+                pos = co_await deserializeAsync<Ser>(in, pos, value);
+            }
+            in.release(pos);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            ValueType value{};
+            if constexpr (value_size != mtf::dynamic_size) {
+                while (!in.hasData(pos, value_size)) {
+                    co_await tools::park;
+                }
+                pos = deserialize<Ser>(in, pos, value);
+            } else {
+                pos = co_await deserializeAsync<Ser>(in, pos, value);
+            }
+            if constexpr (concepts::Insertable<T, ValueType> ||
+                          concepts::PushBackable<T, ValueType>) {
+                tools::insert(elts, std::move(value));
+            } else {
+                tools::insert(elts, std::move(value), i);
+            }
+            in.release(pos);
+        }
+    }
+    co_return pos;
+}
+
+/// @brief Deserialize elt from the asynchronous input at pos. The task
+///        suspends when the data has not been received yet: the user feeds the
+///        input and resumes the task until it is done. The input and elt
+///        should outlive the task.
+/// @tparam Ser Serializer type (same as the one used by the SERIALIZE macros).
+/// @param in Asynchronous input.
+/// @param pos Position of the element in the input.
+/// @param elt Element to deserialize.
+/// @return Task which result is the position of the next element.
+/// @throw std::out_of_range when the input is closed before the end of the
+///        element (thrown when the task is resumed).
+template <typename Ser = AsyncInputSerializer>
+tools::Task<size_t> deserializeAsync(tools::AsyncInput &in, size_t pos,
+                                     auto &elt) {
+    using T = mtf::clean_t<decltype(elt)>;
+    using MemT = tools::AsyncInput;
+
+    if constexpr (concepts::FixedSize<T, Ser>) {
+        constexpr size_t size = mtf::fixed_serialized_size_v<T, Ser>;
+        while (!in.hasData(pos, size)) {
+            co_await tools::park;
+        }
+        pos = deserialize<Ser>(in, pos, elt);
+    } else if constexpr (AsyncCustom<T, Ser>) {
+        pos = co_await deserializeAsyncRetry_<Ser>(in, pos, elt);
+    } else if constexpr (AsyncMembers<T, MemT>) {
+        auto members = elt.serializerMembers(in);
+        pos = co_await deserializeAsyncTuple_<Ser>(in, pos, members);
+    } else if constexpr (concepts::TupleLike<T>) {
+        pos = co_await deserializeAsyncTuple_<Ser>(in, pos, elt);
+    } else if constexpr (AsyncContainer<T, MemT>) {
+        using size_type = decltype(std::size(std::declval<T>()));
+        size_type size;
+
+        while (!in.hasData(pos, sizeof(size))) {
+            co_await tools::park;
+        }
+        pos = deserialize<Ser>(in, pos, size);
+        pos = co_await deserializeAsyncElements_<Ser>(in, pos, elt,
+                                                      size_t(size));
+    } else if constexpr (mtf::is_parallel_v<T>) {
+        // same data as the container
+        pos = co_await deserializeAsync<Ser>(in, pos, elt.container);
+    } else if constexpr (mtf::is_chunked_v<T>) {
+        // same data as Serializer::deserialize_(Chunked), the elements are
+        // deserialized sequentially
+        using size_type = decltype(std::size(elt.container));
+        size_type size;
+        size_t header[2]; // chunk size, number of bytes of the elements
+
+        while (!in.hasData(pos, sizeof(size))) {
+            co_await tools::park;
+        }
+        pos = deserialize<Ser>(in, pos, size);
+        for (size_t &value : header) {
+            while (!in.hasData(pos, sizeof(value))) {
+                co_await tools::park;
+            }
+            pos = deserialize<Ser>(in, pos, value);
+        }
+        in.release(pos);
+        auto [chunkSize, nbBytes] = header;
+        if (chunkSize == 0 && size > 0) [[unlikely]] {
+            throw std::out_of_range("error: invalid chunk size.");
+        }
+        size_t begin = pos;
+        size_t nbChunks =
+            chunkSize == 0 ? 0 : (size_t(size) + chunkSize - 1) / chunkSize;
+        std::vector<size_t> ends(nbChunks);
+
+        pos = co_await deserializeAsyncElements_<Ser>(in, pos, elt.container,
+                                                      size_t(size));
+        pos = co_await asyncRead_(in, pos,
+                                  std::bit_cast<std::byte *>(ends.data()),
+                                  nbChunks * sizeof(size_t));
+        if (pos - begin != nbBytes + nbChunks * sizeof(size_t) ||
+            (nbChunks > 0 && ends.back() != nbBytes)) [[unlikely]] {
+            throw std::out_of_range("error: invalid chunk.");
+        }
+    } else if constexpr (AsyncPointer<T>) {
+        // same as Serializer::deserialize_(Pointer)
+        using Type = std::remove_cvref_t<decltype(*elt)>;
+        char valid = 'n';
+
+        while (!in.hasData(pos, sizeof(valid))) {
+            co_await tools::park;
+        }
+        pos = deserialize<Ser>(in, pos, valid);
+        if (valid != 'v') {
+            elt = nullptr;
+            co_return pos;
+        }
+        if (elt == nullptr) {
+            if constexpr (mtf::is_shared_v<T>) {
+                elt = std::make_shared<Type>();
+            } else if constexpr (mtf::is_unique_v<T>) {
+                elt = std::make_unique<Type>();
+            } else {
+                elt = new Type();
+            }
+#ifdef SERIALIZER_ALLOC_STATS
+            tools::countCreate<Type>();
+#endif
+        }
+        pos = co_await deserializeAsync<Ser>(in, pos, *elt);
+    } else if constexpr (mtf::is_dynamic_array_v<T>) {
+        // same as Serializer::deserialize_(DynamicArray)
+        using ST = std::remove_pointer_t<mtf::clean_t<decltype(elt.mem)>>;
+        constexpr size_t value_size = mtf::fixed_serialized_size_v<ST, Ser>;
+        char valid = 'n';
+
+        while (!in.hasData(pos, sizeof(valid))) {
+            co_await tools::park;
+        }
+        pos = deserialize<Ser>(in, pos, valid);
+        if (valid != 'v') {
+            elt.mem = nullptr;
+            co_return pos;
+        }
+        size_t size = std::is_pointer_v<ST>
+                          ? (size_t)std::get<0>(elt.dimensions)
+                          : tools::tupleProd<size_t>(elt.dimensions);
+        if (elt.mem == nullptr) {
+            elt.mem = new ST[size]();
+#ifdef SERIALIZER_ALLOC_STATS
+            tools::countCreate<ST>(size);
+#endif
+        }
+        if constexpr (std::is_pointer_v<ST>) {
+            for (size_t i = 0; i < size; ++i) {
+                tools::DynamicArray sub(elt.mem[i],
+                                        tools::tuplePopFront(elt.dimensions));
+                pos = co_await deserializeAsync<Ser>(in, pos, sub);
+            }
+        } else if constexpr (concepts::Trivial<ST> &&
+                             !concepts::Deserializable<ST, MemT>) {
+            pos = co_await asyncRead_(in, pos,
+                                      std::bit_cast<std::byte *>(elt.mem),
+                                      size * sizeof(ST));
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                if constexpr (value_size != mtf::dynamic_size) {
+                    while (!in.hasData(pos, value_size)) {
+                        co_await tools::park;
+                    }
+                    pos = deserialize<Ser>(in, pos, elt.mem[i]);
+                } else {
+                    pos = co_await deserializeAsync<Ser>(in, pos, elt.mem[i]);
+                }
+                in.release(pos);
+            }
+        }
+    } else {
+        pos = co_await deserializeAsyncRetry_<Ser>(in, pos, elt);
+    }
+    co_return pos;
+}
+
+} // end namespace serializer
+
+#endif
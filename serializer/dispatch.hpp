@@ -0,0 +1,158 @@
+#ifndef SERIALIZER_DISPATCH_H
+#define SERIALIZER_DISPATCH_H
+#include "exceptions/corrupt_frame.hpp"
+#include "frame.hpp"
+#include "tools/type_table.hpp"
+#include "tools/work_stealing_pool.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+/// @brief serializer namespace
+namespace serializer {
+
+/// @brief Order in which the frames given to a FrameDispatcher are handled.
+enum class DispatchOrder {
+    None,    ///< the frames are handled concurrently in any order
+    PerType, ///< the frames of the same type are handled in order
+    PerKey,  ///< the frames with the same key are handled in order
+};
+
+/// @brief Options of the frame dispatchers.
+struct DispatchOptions {
+    DispatchOrder order = DispatchOrder::None; ///< order of the frames
+    /// @brief Read the type id at the beginning of the payload (objects that
+    ///        serialize their id) instead of the type of the frame.
+    bool idInPayload = false;
+};
+
+/// @brief Decode the frames of a buffer on a work stealing pool and call a
+///        handler on the decoded objects concurrently. The buffer is split in
+///        frames on the calling thread (only the headers are read), then the
+///        checksums are verified and the objects are deserialized by the
+///        tasks of the pool. The type of each object is found using its id in
+///        the type table.
+///        With an ordering option, the frames of the same type (or with the
+///        same key) are handled sequentially in the order of the buffer, and
+///        the different types (or keys) are handled concurrently.
+/// @tparam TypeTable Type table of the objects.
+template <typename TypeTable> class FrameDispatcher {
+  public:
+    using key_type = std::size_t;
+    /// @brief Function that computes the key of a frame (PerKey).
+    using key_function =
+        std::function<key_type(Frame const &, std::span<std::byte const>)>;
+
+    /// @brief Constructor.
+    /// @param pool Pool that runs the tasks (it should outlive the
+    ///             dispatcher).
+    /// @param options Options.
+    /// @param key Key of the frames (used with DispatchOrder::PerKey).
+    /// @throw std::invalid_argument when the order is PerKey and there is no
+    ///        key function.
+    explicit FrameDispatcher(tools::WorkStealingPool &pool,
+                             DispatchOptions options = {},
+                             key_function key = nullptr)
+        : pool_(pool), options_(options), key_(std::move(key)) {
+        if (options_.order == DispatchOrder::PerKey && !key_) {
+            throw std::invalid_argument(
+                "error: the PerKey order requires a key function.");
+        }
+    }
+
+    /// @brief Decode the frames of mem and call handler(std::shared_ptr<T>)
+    ///        on each object (returns when all the objects are handled).
+    /// @param mem Buffer of frames (it should be a random access buffer).
+    /// @param handler Function called with each object (it should accept a
+    ///                shared pointer to each type of the type table, and may
+    ///                be called concurrently).
+    /// @return Number of frames.
+    /// @throw CorruptFrameError when a frame is corrupt (the valid frames are
+    ///        still handled).
+    /// @throw The first exception thrown by the handler.
+    size_t dispatch(auto &mem, auto &&handler) {
+        std::vector<Frame> frames;
+        std::exception_ptr error;
+        std::unordered_map<key_type, std::vector<Frame>> lanes;
+
+        try {
+            for (size_t pos = 0; pos < mem.size();) {
+                frames.push_back(readFrameHeader(mem, pos));
+                pos = frames.back().end();
+            }
+        } catch (exceptions::CorruptFrameError const &) {
+            error = std::current_exception();
+        }
+        if (options_.order == DispatchOrder::None) {
+            for (Frame const &frame : frames) {
+                pool_.submit([&, frame] { handle(mem, frame, handler); });
+            }
+        } else {
+            // one task per lane handles its frames in order
+            for (Frame const &frame : frames) {
+                lanes[laneKey(mem, frame)].push_back(frame);
+            }
+            for (auto &[key, lane] : lanes) {
+                pool_.submit([&, lane = &lane] {
+                    for (Frame const &frame : *lane) {
+                        handle(mem, frame, handler);
+                    }
+                });
+            }
+        }
+        pool_.wait();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return frames.size();
+    }
+
+  private:
+    tools::WorkStealingPool &pool_; ///< threads
+    DispatchOptions options_;       ///< options
+    key_function key_;              ///< key of the frames (PerKey)
+
+    /// @brief Type id of a frame.
+    auto typeId(auto &mem, Frame const &frame) const {
+        using id_type = typename TypeTable::id_type;
+        if (options_.idInPayload) {
+            return tools::getId<TypeTable>(mem, frame.pos);
+        }
+        return id_type(frame.header.type);
+    }
+
+    /// @brief Ordering lane of a frame.
+    key_type laneKey(auto &mem, Frame const &frame) const {
+        if (options_.order == DispatchOrder::PerType) {
+            return key_type(typeId(mem, frame));
+        }
+        return key_(frame, std::span<std::byte const>(
+                               std::bit_cast<std::byte const *>(
+                                   mem.data() + frame.pos),
+                               size_t(frame.header.length)));
+    }
+
+    /// @brief Verify, deserialize and handle a frame.
+    void handle(auto &mem, Frame const &frame, auto &handler) const {
+        verifyFrame(mem, frame);
+        tools::applyId(typeId(mem, frame), TypeTable(), [&]<typename T>() {
+            auto obj = std::make_shared<T>();
+            if (obj->deserialize(mem, frame.pos) != frame.end()) [[unlikely]] {
+                throw exceptions::CorruptFrameError(
+                    frame.pos - sizeof(tools::FrameHeader), "invalid payload");
+            }
+            handler(obj);
+        });
+    }
+};
+
+} // end namespace serializer
+
+#endif
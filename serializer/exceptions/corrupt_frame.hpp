@@ -0,0 +1,38 @@
+#ifndef SERIALIZER_CORRUPT_FRAME_ERROR_HPP
+#define SERIALIZER_CORRUPT_FRAME_ERROR_HPP
+#include <cstddef>
+#include <exception>
+#include <sstream>
+#include <string>
+
+/// @brief namespace serializer exception
+namespace serializer::exceptions {
+
+/// @brief Exception for frames that are invalid (bad header, truncated frame,
+///        checksum mismatch, ...).
+class CorruptFrameError : public std::exception {
+  public:
+    /// @brief Constructor
+    /// @param pos Position of the frame in the buffer.
+    /// @param reason Description of the error.
+    CorruptFrameError(size_t pos, std::string const &reason) : pos_(pos) {
+        std::ostringstream oss;
+        oss << "error: corrupt frame at position " << pos << " (" << reason
+            << ").";
+        msg = oss.str();
+    }
+
+    /// @brief Position of the frame in the buffer.
+    size_t position() const { return pos_; }
+
+    /// @brief what
+    const char *what() const noexcept override { return msg.c_str(); }
+
+  private:
+    size_t pos_ = 0; ///< position of the frame
+    std::string msg; ///< message for what.
+};
+
+} // end namespace serializer::exceptions
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef SERIALIZER_FRAME_H
+#define SERIALIZER_FRAME_H
+#include "exceptions/corrupt_frame.hpp"
+#include "serializer/serializer.hpp"
+#include "tools/frame.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+
+/// @brief serializer namespace
+namespace serializer {
+
+/// @brief Frame read from a memory buffer (see readFrame).
+struct Frame {
+    tools::FrameHeader header; ///< header of the frame
+    size_t pos = 0;            ///< position of the payload
+
+    /// @brief Position of the end of the frame (next frame).
+    size_t end() const { return pos + header.length; }
+};
+
+/* header *********************************************************************/
+
+/// @brief Compute the checksum of the fields of a header that precede it.
+/// @param header Frame header.
+/// @return crc32 of the fields.
+inline std::uint32_t frameHeaderChecksum(tools::FrameHeader const &header) {
+    return tools::crc32(std::bit_cast<std::byte const *>(&header),
+                        offsetof(tools::FrameHeader, headerChecksum));
+}
+
+/* write **********************************************************************/
+
+/// @brief Write the header of a frame which payload is already in mem (the
+///        space for the header should be reserved before the payload).
+/// @param mem Buffer of bytes.
+/// @param pos Position of the frame in mem.
+/// @param type Type id of the payload.
+/// @param end Position of the end of the payload.
+/// @param flags Flags of the frame (frame_checksum and user flags).
+/// @return Position of the next frame in the buffer.
+inline size_t writeFrameHeader(auto &mem, size_t pos, std::uint32_t type,
+                               size_t end, std::uint16_t flags) {
+    size_t payloadPos = pos + sizeof(tools::FrameHeader);
+    tools::FrameHeader header;
+
+    header.flags = flags;
+    header.type = type;
+    header.length = end - payloadPos;
+    if (flags & tools::frame_checksum) {
+        header.checksum =
+            tools::crc32(mem.data() + payloadPos, size_t(header.length));
+    }
+    header.headerChecksum = frameHeaderChecksum(header);
+    std::memcpy(mem.data() + pos, &header, sizeof(header));
+    return end;
+}
+
+/// @brief Append a frame which payload is a buffer of bytes that is already
+///        serialized (used to forward payloads).
+/// @param mem Buffer of bytes.
+/// @param pos Position of the frame in mem.
+/// @param type Type id of the payload.
+/// @param bytes Payload.
+/// @param nbBytes Size of the payload.
+/// @param flags Flags of the frame (frame_checksum and user flags).
+/// @return Position of the next frame in the buffer.
+inline size_t appendFrame(auto &mem, size_t pos, std::uint32_t type,
+                          auto const *bytes, size_t nbBytes,
+                          std::uint16_t flags = tools::frame_checksum) {
+    Serializer<decltype(mem)> serializer(mem, pos);
+    tools::FrameHeader header;
+
+    serializer.append(header);
+    serializer.append(
+        std::bit_cast<typename decltype(serializer)::byte_type const *>(
+            bytes),
+        nbBytes);
+    return writeFrameHeader(mem, pos, type, serializer.pos, flags);
+}
+
+/// @brief Serialize an object in a frame.
+/// @param mem Buffer of bytes.
+/// @param pos Position of the frame in mem.
+/// @param type Type id of the payload (ex: tools::getId<T>(TypeTable())).
+/// @param obj Serialized object (should have a serialize method).
+/// @param flags Flags of the frame (frame_checksum and user flags).
+/// @return Position of the next frame in the buffer.
+inline size_t serializeFrame(auto &mem, size_t pos, std::uint32_t type,
+                             auto const &obj,
+                             std::uint16_t flags = tools::frame_checksum) {
+    Serializer<decltype(mem)> serializer(mem, pos);
+    tools::FrameHeader header;
+
+    serializer.append(header);
+    size_t end = obj.serialize(mem, serializer.pos);
+    return writeFrameHeader(mem, pos, type, end, flags);
+}
+
+/* read ***********************************************************************/
+
+/// @brief Read and validate the header of the frame at pos (the checksum of
+///        the payload is not verified, see verifyFrame). It is used to split a
+///        buffer in frames cheaply.
+/// @param mem Buffer of bytes that contains the frames.
+/// @param pos Position of the frame in mem.
+/// @return Frame.
+/// @throw CorruptFrameError when the header is invalid or when the frame is
+///        truncated.
+inline Frame readFrameHeader(auto const &mem, size_t pos) {
+    Frame frame;
+
+    if (pos > mem.size() || mem.size() - pos < sizeof(tools::FrameHeader)) {
+        throw exceptions::CorruptFrameError(pos, "truncated header");
+    }
+    std::memcpy(&frame.header, mem.data() + pos, sizeof(tools::FrameHeader));
+    frame.pos = pos + sizeof(tools::FrameHeader);
+    if (frame.header.magic != tools::frame_magic ||
+        frame.header.headerChecksum != frameHeaderChecksum(frame.header)) {
+        throw exceptions::CorruptFrameError(pos, "invalid header");
+    }
+    if (mem.size() - frame.pos < frame.header.length) {
+        throw exceptions::CorruptFrameError(pos, "truncated payload");
+    }
+    return frame;
+}
+
+/// @brief Verify the checksum of the payload of a frame (when the frame has
+///        one).
+/// @param mem Buffer of bytes that contains the frame.
+/// @param frame Frame read with readFrameHeader.
+/// @throw CorruptFrameError when the checksum does not match.
+inline void verifyFrame(auto const &mem, Frame const &frame) {
+    if ((frame.header.flags & tools::frame_checksum) &&
+        frame.header.checksum != tools::crc32(mem.data() + frame.pos,
+                                              size_t(frame.header.length))) {
+        throw exceptions::CorruptFrameError(
+            frame.pos - sizeof(tools::FrameHeader), "checksum mismatch");
+    }
+}
+
+/// @brief Read and validate the frame at pos. The payload is not read
+///        (except to verify the checksum).
+/// @param mem Buffer of bytes that contains the frames.
+/// @param pos Position of the frame in mem.
+/// @return Frame.
+/// @throw CorruptFrameError when the header is invalid, when the frame is
+///        truncated or when the checksum does not match.
+inline Frame readFrame(auto const &mem, size_t pos) {
+    Frame frame = readFrameHeader(mem, pos);
+    verifyFrame(mem, frame);
+    return frame;
+}
+
+/// @brief Find the first valid frame at or after pos (used to resynchronize
+///        after a corrupt header).
+/// @param mem Buffer of bytes that contains the frames.
+/// @param pos Position where the search starts.
+/// @return Position of the frame, or nothing when there is no valid frame.
+inline std::optional<size_t> findFrame(auto const &mem, size_t pos) {
+    for (; pos + sizeof(tools::FrameHeader) <= mem.size(); ++pos) {
+        std::uint16_t magic;
+        std::memcpy(&magic, mem.data() + pos, sizeof(magic));
+        if (magic != tools::frame_magic) {
+            continue;
+        }
+        try {
+            readFrame(mem, pos);
+            return pos;
+        } catch (exceptions::CorruptFrameError const &) {
+        }
+    }
+    return std::nullopt;
+}
+
+/// @brief Access to the payload of a frame.
+/// @param mem Buffer of bytes that contains the frame.
+/// @param frame Frame.
+/// @return Span over the payload.
+inline auto framePayload(auto &mem, Frame const &frame) {
+    return std::span(mem.data() + frame.pos, size_t(frame.header.length));
+}
+
+/// @brief Deserialize the payload of a frame into obj.
+/// @param mem Buffer of bytes that contains the frame.
+/// @param frame Frame (see readFrame).
+/// @param obj Deserialized object (should have a deserialize method).
+/// @return Position of the next frame in the buffer.
+/// @throw CorruptFrameError when the payload does not match the length of
+///        the frame.
+inline size_t deserializeFrame(auto const &mem, Frame const &frame,
+                               auto &obj) {
+    if (obj.deserialize(mem, frame.pos) != frame.end()) [[unlikely]] {
+        throw exceptions::CorruptFrameError(
+            frame.pos - sizeof(tools::FrameHeader), "invalid payload");
+    }
+    return frame.end();
+}
+
+} // end namespace serializer
+
+#endif
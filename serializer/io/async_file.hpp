@@ -0,0 +1,557 @@
+#ifndef SERIALIZER_IO_ASYNC_FILE_HPP
+#define SERIALIZER_IO_ASYNC_FILE_HPP
+#include "../tools/bytes.hpp"
+#include "../tools/bytes_pool.hpp"
+#include "uring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                 async file                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Options of the asynchronous files.
+struct AsyncFileOptions {
+    unsigned queueDepth = 16;   ///< maximum number of requests in flight
+    bool direct = false;        ///< use O_DIRECT (aligned blocks)
+    size_t blockSize = 1 << 20; ///< size of the aligned blocks (O_DIRECT)
+    size_t alignment = 4096;    ///< alignment of the blocks (O_DIRECT)
+    size_t poolSize = 64;       ///< maximum number of buffers in the pool
+};
+
+/// @brief File that appends serialized batches and reads ranges
+///        asynchronously using io_uring, so the I/O overlaps with the
+///        serialization of the next batch. The buffers are given to the file
+///        (moved) and returned to a pool when the I/O completes (see buffer).
+///        When io_uring is not available, the requests are executed with
+///        blocking system calls.
+///        With the direct option, the file is opened with O_DIRECT and the
+///        appended data is copied into aligned blocks that are written when
+///        they are full (the last block is padded and the file is truncated
+///        to its real size by close).
+///        The data is appended after the current content of the file (with
+///        the direct option, the last partial block is read back, so the file
+///        should be opened for reading and writing, or truncated).
+///        The file should be used by a single thread.
+class AsyncFile {
+  public:
+    using byte_type = std::byte;
+    using bytes_type = tools::Bytes<byte_type>;
+    using read_callback = std::function<void(bytes_type &)>;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Open a file.
+    /// @param path Path to the file.
+    /// @param flags Flags given to open (ex: O_WRONLY | O_CREAT | O_TRUNC).
+    /// @param options Options.
+    /// @throw std::system_error when the file cannot be opened.
+    /// @throw std::invalid_argument when the options are invalid.
+    AsyncFile(std::string const &path, int flags,
+              AsyncFileOptions options = {})
+        : AsyncFile(openFile(path, flags, checkOptions(options)), options,
+                    true) {}
+
+    /// @brief Constructor from a file descriptor (not closed by the file).
+    /// @param fd File descriptor.
+    /// @param options Options.
+    /// @throw std::system_error when the file cannot be inspected.
+    /// @throw std::invalid_argument when the options are invalid.
+    explicit AsyncFile(int fd, AsyncFileOptions options = {})
+        : AsyncFile(fd, checkOptions(options), false) {}
+
+    AsyncFile(AsyncFile const &) = delete;
+    AsyncFile &operator=(AsyncFile const &) = delete;
+
+    /// @brief Destructor (close the file, the errors are ignored, call close
+    ///        to handle them).
+    ~AsyncFile() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief True if io_uring is used.
+    bool async() const { return uring_.has_value(); }
+
+    /// @brief Number of bytes appended to the file.
+    size_t size() const { return size_; }
+
+    /// @brief Number of requests in flight.
+    size_t inFlight() const { return slots_.size() - freeSlots_.size(); }
+
+    /// @brief File descriptor.
+    int fd() const { return fd_; }
+
+    /* buffers ****************************************************************/
+
+    /// @brief Get an empty buffer from the pool (buffers of completed requests
+    ///        are reused).
+    /// @param capacity Minimum capacity of the buffer.
+    bytes_type buffer(size_t capacity = 0) { return pool_.acquire(capacity); }
+
+    /// @brief Give a buffer back to the pool.
+    void release(bytes_type &&buffer) { pool_.release(std::move(buffer)); }
+
+    /* append *****************************************************************/
+
+    /// @brief Append a buffer at the end of the file. The buffer is returned
+    ///        to the pool when the write completes.
+    /// @param bytes Buffer that contains the serialized batch.
+    void append(bytes_type &&bytes) {
+        std::vector<bytes_type> segments;
+        segments.push_back(std::move(bytes));
+        append(std::move(segments));
+    }
+
+    /// @brief Append a list of buffers at the end of the file (one vectored
+    ///        write). The buffers are returned to the pool when the write
+    ///        completes.
+    /// @param segments Buffers that contain the serialized batches.
+    void append(std::vector<bytes_type> &&segments) {
+        if (options_.direct) {
+            appendDirect(std::move(segments));
+            return;
+        }
+        Slot &slot = acquireSlot();
+        size_t length = 0;
+
+        slot.buffers = std::move(segments);
+        slot.iov.clear();
+        for (auto &segment : slot.buffers) {
+            if (segment.size() > 0) {
+                slot.iov.push_back({segment.data(), segment.size()});
+                length += segment.size();
+            }
+        }
+        slot.offset = size_;
+        slot.length = length;
+        slot.write = true;
+        submit(slot);
+        size_ += length;
+    }
+
+    /* read *******************************************************************/
+
+    /// @brief Read a range of the file. The callback receives a buffer that
+    ///        holds the data (it can be moved out, otherwise it is returned
+    ///        to the pool). It is called by poll or drain.
+    /// @param offset Position of the range in the file.
+    /// @param nbBytes Number of bytes to read.
+    /// @param callback Function called when the data is available.
+    /// @throw std::logic_error with the direct option.
+    void read(size_t offset, size_t nbBytes, read_callback callback) {
+        if (options_.direct) {
+            throw std::logic_error("error: unaligned read with O_DIRECT.");
+        }
+        Slot &slot = acquireSlot();
+
+        slot.buffers.clear();
+        slot.buffers.push_back(pool_.acquire(nbBytes));
+        slot.buffers[0].resize(nbBytes);
+        slot.iov.assign(1, {slot.buffers[0].data(), nbBytes});
+        slot.offset = offset;
+        slot.length = nbBytes;
+        slot.write = false;
+        slot.callback = std::move(callback);
+        submit(slot);
+    }
+
+    /* completion *************************************************************/
+
+    /// @brief Process the completed requests without blocking.
+    /// @return Number of completed requests.
+    /// @throw std::system_error when a request has failed.
+    size_t poll() {
+        size_t count = 0;
+        io_uring_cqe cqe;
+
+        while (uring_ && uring_->pop(cqe)) {
+            if (cqe.user_data == ignored_completion) {
+                continue;
+            }
+            complete(slots_[cqe.user_data], cqe.res);
+            ++count;
+        }
+        return count;
+    }
+
+    /// @brief Wait for all the requests in flight.
+    /// @throw std::system_error when a request has failed.
+    void drain() {
+        while (inFlight() > 0) {
+            waitOne();
+        }
+    }
+
+    /// @brief Write the remaining data, wait for all the requests and close
+    ///        the file (when it has been opened by this object).
+    void close() {
+        if (fd_ < 0) {
+            return;
+        }
+        if (options_.direct && blockSize_ > 0) {
+            size_t padded = (blockSize_ + options_.alignment - 1) /
+                            options_.alignment * options_.alignment;
+            std::memset(block_.get() + blockSize_, 0, padded - blockSize_);
+            submitBlock(padded);
+        }
+        drain();
+        if (options_.direct && ftruncate(fd_, off_t(size_)) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot truncate the file.");
+        }
+        if (ownsFd_) {
+            ::close(fd_);
+        }
+        fd_ = -1;
+    }
+
+  private:
+    /// @brief Constructor from a file descriptor.
+    /// @param fd File descriptor.
+    /// @param options Options (checked).
+    /// @param ownsFd True if the file descriptor is closed by the file (also
+    ///               when the constructor throws).
+    AsyncFile(int fd, AsyncFileOptions const &options, bool ownsFd)
+        : fd_(fd), ownsFd_(ownsFd), options_(options),
+          pool_(options.poolSize), slots_(std::max(options.queueDepth, 1u)) {
+        try {
+            init();
+        } catch (...) {
+            if (ownsFd_) {
+                ::close(fd_);
+            }
+            throw;
+        }
+    }
+
+    /// @brief Deleter for the aligned blocks.
+    struct AlignedFree {
+        void operator()(std::byte *ptr) const { std::free(ptr); }
+    };
+    using block_type = std::unique_ptr<std::byte, AlignedFree>;
+
+    /// @brief Request in flight.
+    struct Slot {
+        std::vector<bytes_type> buffers; ///< buffers (released on completion)
+        std::vector<iovec> iov;          ///< vectored I/O
+        block_type block;                ///< aligned block (O_DIRECT)
+        read_callback callback;          ///< read callback
+        size_t offset = 0;               ///< position in the file
+        size_t length = 0;               ///< number of bytes
+        bool write = true;               ///< true for writes
+    };
+
+    /// @brief User data of the entries that have not been submitted.
+    static constexpr std::uint64_t ignored_completion = ~std::uint64_t(0);
+
+    int fd_ = -1;                    ///< file descriptor
+    bool ownsFd_ = false;            ///< true if fd_ is closed by close
+    AsyncFileOptions options_;       ///< options
+    std::optional<Uring> uring_;     ///< io_uring instance
+    tools::BytesPool<byte_type> pool_; ///< buffer pool
+    std::vector<Slot> slots_;        ///< requests
+    std::vector<size_t> freeSlots_;  ///< indices of the free slots
+    std::vector<block_type> blocks_; ///< free aligned blocks (O_DIRECT)
+    block_type block_;               ///< current aligned block (O_DIRECT)
+    size_t blockSize_ = 0;           ///< bytes in the current block
+    size_t blockOffset_ = 0;         ///< position of the current block
+    size_t size_ = 0;                ///< size of the file
+
+    /// @brief Check the options.
+    /// @throw std::invalid_argument when the aligned blocks cannot be used.
+    static AsyncFileOptions const &checkOptions(AsyncFileOptions const &opt) {
+        if (!opt.direct) {
+            return opt;
+        }
+        if (opt.alignment == 0 || (opt.alignment & (opt.alignment - 1)) != 0) {
+            throw std::invalid_argument(
+                "error: the alignment should be a power of two.");
+        }
+        if (opt.blockSize == 0 || opt.blockSize % opt.alignment != 0) {
+            throw std::invalid_argument(
+                "error: the block size should be a multiple of the "
+                "alignment.");
+        }
+        return opt;
+    }
+
+    /// @brief Initialize io_uring, the slots and the position of the end of
+    ///        the file.
+    void init() {
+        struct stat st;
+
+        try {
+            uring_.emplace(std::max(options_.queueDepth, 1u));
+        } catch (std::system_error const &) {
+            // io_uring is not available, blocking calls are used
+        }
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            freeSlots_.push_back(slots_.size() - i - 1);
+        }
+        if (fstat(fd_, &st) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot stat the file.");
+        }
+        size_ = S_ISREG(st.st_mode) ? size_t(st.st_size) : 0;
+        if (options_.direct) {
+            block_ = alignedBlock();
+            blockOffset_ = size_ / options_.alignment * options_.alignment;
+            blockSize_ = size_ - blockOffset_;
+            if (blockSize_ > 0) {
+                readLastBlock();
+            }
+        }
+    }
+
+    /// @brief Read the last partial block of the file in the current block
+    ///        (O_DIRECT), so it is rewritten with the appended data.
+    /// @throw std::system_error when the block cannot be read.
+    void readLastBlock() {
+        size_t done = 0;
+
+        while (done < blockSize_) {
+            ssize_t res = ::pread(fd_, block_.get() + done,
+                                  options_.alignment - done,
+                                  off_t(blockOffset_ + done));
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                throw std::system_error(
+                    res < 0 ? errno : EIO, std::generic_category(),
+                    "error: cannot read the last block of the file.");
+            }
+            done += size_t(res);
+        }
+    }
+
+    /// @brief Open the file (O_DIRECT is added with the direct option).
+    static int openFile(std::string const &path, int flags,
+                        AsyncFileOptions const &options) {
+        if (options.direct) {
+            flags |= O_DIRECT;
+        }
+        int fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot open " + path + ".");
+        }
+        return fd;
+    }
+
+    /// @brief Get a free slot (wait for a completion if all the slots are
+    ///        used).
+    Slot &acquireSlot() {
+        while (freeSlots_.empty()) {
+            waitOne();
+        }
+        return slots_[freeSlots_.back()];
+    }
+
+    /// @brief Submit the request of the last acquired slot. The slot is
+    ///        used only when the submission succeeds, otherwise its buffers
+    ///        are released (the aligned block is kept by the slot).
+    /// @throw std::system_error when the request cannot be submitted.
+    void submit(Slot &slot) {
+        size_t idx = freeSlots_.back();
+
+        if (!uring_) {
+            freeSlots_.pop_back();
+            complete(slot, transfer(slot));
+            return;
+        }
+        io_uring_sqe *sqe = nullptr;
+        try {
+            while ((sqe = uring_->sqe()) == nullptr) {
+                uring_->submit();
+            }
+            sqe->opcode = slot.write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe->fd = fd_;
+            sqe->addr = reinterpret_cast<std::uint64_t>(slot.iov.data());
+            sqe->len = unsigned(slot.iov.size());
+            sqe->off = slot.offset;
+            sqe->user_data = idx;
+            uring_->submit();
+        } catch (...) {
+            if (sqe) {
+                // the entry is still in the queue, its completion is ignored
+                std::memset(sqe, 0, sizeof(io_uring_sqe));
+                sqe->opcode = IORING_OP_NOP;
+                sqe->user_data = ignored_completion;
+            }
+            for (auto &buffer : slot.buffers) {
+                pool_.release(std::move(buffer));
+            }
+            slot.buffers.clear();
+            slot.callback = nullptr;
+            throw;
+        }
+        freeSlots_.pop_back();
+    }
+
+    /// @brief Wait for one completion.
+    void waitOne() {
+        if (poll() == 0) {
+            uring_->submit(1);
+            poll();
+        }
+    }
+
+    /// @brief Execute the request with blocking calls.
+    /// @return Number of bytes transferred or -errno.
+    long transfer(Slot &slot, size_t done = 0) {
+        size_t total = done;
+        size_t skip = done;
+
+        for (auto const &iov : slot.iov) {
+            if (skip >= iov.iov_len) {
+                skip -= iov.iov_len;
+                continue;
+            }
+            auto ptr = static_cast<std::byte *>(iov.iov_base) + skip;
+            size_t count = iov.iov_len - skip;
+            skip = 0;
+            while (count > 0) {
+                ssize_t res =
+                    slot.write
+                        ? ::pwrite(fd_, ptr, count, off_t(slot.offset + total))
+                        : ::pread(fd_, ptr, count, off_t(slot.offset + total));
+                if (res < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (res < 0) {
+                    return -errno;
+                }
+                if (res == 0) {
+                    return long(total);
+                }
+                ptr += res;
+                count -= size_t(res);
+                total += size_t(res);
+            }
+        }
+        return long(total);
+    }
+
+    /// @brief Complete a request: short transfers are finished with blocking
+    ///        calls, the buffers are released and the callback is called.
+    void complete(Slot &slot, long res) {
+        size_t idx = size_t(&slot - slots_.data());
+
+        if (res >= 0 && size_t(res) < slot.length) {
+            res = transfer(slot, size_t(res));
+        }
+        // the slot is freed before the callback, so it can submit requests
+        std::vector<bytes_type> buffers = std::move(slot.buffers);
+        read_callback callback = std::move(slot.callback);
+        bool incomplete = !slot.write && size_t(res) < slot.length;
+
+        slot.buffers.clear();
+        if (slot.block) {
+            blocks_.push_back(std::move(slot.block));
+        }
+        freeSlots_.push_back(idx);
+        if (res < 0) {
+            throw std::system_error(int(-res), std::generic_category(),
+                                    "error: asynchronous I/O failed.");
+        }
+        if (incomplete) {
+            throw std::out_of_range("error: read past the end of file.");
+        }
+        if (callback) {
+            callback(buffers[0]);
+        }
+        for (auto &buffer : buffers) {
+            pool_.release(std::move(buffer));
+        }
+    }
+
+    /* direct *****************************************************************/
+
+    /// @brief Get a free aligned block.
+    block_type alignedBlock() {
+        if (!blocks_.empty()) {
+            block_type block = std::move(blocks_.back());
+            blocks_.pop_back();
+            return block;
+        }
+        size_t size = (options_.blockSize + options_.alignment - 1) /
+                      options_.alignment * options_.alignment;
+        auto ptr = static_cast<std::byte *>(
+            std::aligned_alloc(options_.alignment, size));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return block_type(ptr);
+    }
+
+    /// @brief Copy the segments into the aligned blocks (the full blocks are
+    ///        submitted).
+    void appendDirect(std::vector<bytes_type> &&segments) {
+        for (auto &segment : segments) {
+            size_t copied = 0;
+            while (copied < segment.size()) {
+                size_t count = std::min(segment.size() - copied,
+                                        options_.blockSize - blockSize_);
+                std::memcpy(block_.get() + blockSize_,
+                            segment.data() + copied, count);
+                blockSize_ += count;
+                copied += count;
+                size_ += count;
+                if (blockSize_ == options_.blockSize) {
+                    submitBlock(blockSize_);
+                }
+            }
+            pool_.release(std::move(segment));
+        }
+    }
+
+    /// @brief Submit the current aligned block.
+    /// @param length Number of bytes to write (multiple of the alignment).
+    void submitBlock(size_t length) {
+        Slot &slot = acquireSlot();
+
+        slot.buffers.clear();
+        slot.block = std::move(block_);
+        slot.iov.assign(1, {slot.block.get(), length});
+        slot.offset = blockOffset_;
+        slot.length = length;
+        slot.write = true;
+        try {
+            submit(slot);
+        } catch (...) {
+            // the data stays in the current block
+            block_ = slot.block ? std::move(slot.block) : alignedBlock();
+            throw;
+        }
+        blockOffset_ += blockSize_;
+        blockSize_ = 0;
+        block_ = alignedBlock();
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
@@ -0,0 +1,269 @@
+#ifndef SERIALIZER_IO_BATCH_BUFFER_HPP
+#define SERIALIZER_IO_BATCH_BUFFER_HPP
+#include "../frame.hpp"
+#include "../tools/bytes.hpp"
+#include "../tools/frame.hpp"
+#include "../tools/stream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+/******************************************************************************/
+/*                                batch buffer                                */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Outgoing buffer shared by several producer threads. A producer
+///        reserves a region with one fetch_add on the write cursor (the size
+///        of the object is computed first), serializes the object directly in
+///        the region, and publishes its completion. The flusher (one thread)
+///        sends the contiguous prefix of completed regions, so the objects
+///        are neither copied nor serialized under a lock.
+///        The cursor stores the number of records (high 24 bits) and the
+///        number of bytes reserved (low 40 bits). When a reservation does not
+///        fit, the buffer is sealed: the following reservations fail too, and
+///        the buffer should be flushed and reset before being reused.
+class BatchBuffer {
+  public:
+    /// @brief Region reserved in the buffer (see tryReserve and commit).
+    struct Region {
+        size_t index = 0;          ///< index of the record
+        size_t offset = 0;         ///< position in the buffer
+        std::span<std::byte> data; ///< reserved bytes
+    };
+
+    /* constructors ***********************************************************/
+
+    /// @brief Constructor.
+    /// @param capacity Number of bytes of the buffer.
+    /// @param maxRecords Maximum number of records of the buffer.
+    /// @throw std::length_error when the capacity or the number of records
+    ///        cannot be stored in the cursor.
+    explicit BatchBuffer(size_t capacity, size_t maxRecords = 4096)
+        : buffer_(capacity, capacity), maxRecords_(maxRecords),
+          ends_(std::make_unique<std::atomic<std::uint64_t>[]>(maxRecords)) {
+        if (capacity > bytes_mask || maxRecords > (count_mask >> 1)) {
+            throw std::length_error("error: batch buffer too large.");
+        }
+    }
+
+    BatchBuffer(BatchBuffer const &) = delete;
+    BatchBuffer &operator=(BatchBuffer const &) = delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of bytes of the buffer.
+    size_t capacity() const { return buffer_.size(); }
+
+    /// @brief Maximum number of records of the buffer.
+    size_t maxRecords() const { return maxRecords_; }
+
+    /// @brief Number of bytes reserved (larger than the capacity when the
+    ///        buffer is sealed).
+    size_t reserved() const {
+        return cursor_.load(std::memory_order_relaxed) & bytes_mask;
+    }
+
+    /// @brief Number of bytes flushed (including the bytes of the abandoned
+    ///        records, which are not sent).
+    size_t flushed() const { return flushed_; }
+
+    /* producers **************************************************************/
+
+    /// @brief Reserve a region of nbBytes (lock-free).
+    /// @param nbBytes Size of the region.
+    /// @return The region, or nullopt when the buffer is sealed (the region
+    ///         does not fit).
+    /// @throw std::length_error when the region is larger than the buffer.
+    std::optional<Region> tryReserve(size_t nbBytes) {
+        if (nbBytes > capacity()) [[unlikely]] {
+            throw std::length_error("error: region larger than the buffer.");
+        }
+        std::uint64_t cursor = cursor_.load(std::memory_order_relaxed);
+
+        // the sealed buffer is not modified (no overflow of the cursor)
+        if ((cursor & bytes_mask) > capacity() ||
+            (cursor >> count_shift) >= maxRecords_) [[unlikely]] {
+            return std::nullopt;
+        }
+        cursor = cursor_.fetch_add(std::uint64_t(1) << count_shift | nbBytes,
+                                   std::memory_order_relaxed);
+        size_t index = cursor >> count_shift;
+        size_t offset = cursor & bytes_mask;
+
+        if (index >= maxRecords_) [[unlikely]] {
+            return std::nullopt;
+        }
+        if (offset + nbBytes > capacity()) [[unlikely]] {
+            // publish the failure, the flusher stops at this record
+            ends_[index].store(sealed_record, std::memory_order_release);
+            return std::nullopt;
+        }
+        return Region{index, offset,
+                      std::span<std::byte>(buffer_.data() + offset, nbBytes)};
+    }
+
+    /// @brief Publish a region that has been written.
+    void commit(Region const &region) {
+        ends_[region.index].store(region.offset + region.data.size() + 1,
+                                  std::memory_order_release);
+    }
+
+    /// @brief Publish a region that could not be written (the flusher skips
+    ///        its bytes, so the following records are not held back).
+    void abandon(Region const &region) {
+        ends_[region.index].store(
+            (region.offset + region.data.size() + 1) | abandoned_record,
+            std::memory_order_release);
+    }
+
+    /// @brief Serialize obj in a region of the buffer.
+    /// @param obj Object to serialize (should have a serialize method).
+    /// @return False when the buffer is sealed.
+    /// @throw std::length_error when the object is larger than the buffer.
+    ///        The exceptions of the serialization are rethrown (the region is
+    ///        abandoned).
+    bool tryAppend(auto const &obj) {
+        tools::ByteCounter counter;
+        obj.serialize(counter);
+        auto region = tryReserve(counter.size());
+        if (!region) {
+            return false;
+        }
+        try {
+            obj.serialize(region->data);
+        } catch (...) {
+            abandon(*region);
+            throw;
+        }
+        commit(*region);
+        return true;
+    }
+
+    /// @brief Serialize obj in a frame (see serializeFrame) in a region of
+    ///        the buffer.
+    /// @param obj Object to serialize (should have a serialize method).
+    /// @param type Type id of the payload.
+    /// @param flags Flags of the frame.
+    /// @return False when the buffer is sealed.
+    /// @throw std::length_error when the frame is larger than the buffer.
+    ///        The exceptions of the serialization are rethrown (the region is
+    ///        abandoned).
+    bool tryAppendFrame(auto const &obj, std::uint32_t type = 0,
+                        std::uint16_t flags = tools::frame_checksum) {
+        tools::ByteCounter counter;
+        obj.serialize(counter);
+        auto region = tryReserve(sizeof(tools::FrameHeader) + counter.size());
+        if (!region) {
+            return false;
+        }
+        try {
+            serializeFrame(region->data, 0, type, obj, flags);
+        } catch (...) {
+            abandon(*region);
+            throw;
+        }
+        commit(*region);
+        return true;
+    }
+
+    /* flusher ****************************************************************/
+
+    /// @brief Send the completed records that follow the last flush (only the
+    ///        contiguous prefix of completed records is sent, send is called
+    ///        once for each run of records between abandoned records).
+    /// @param send Function called with the bytes to send
+    ///             (std::span<std::byte const>).
+    /// @return Number of bytes sent.
+    size_t flush(auto &&send) {
+        size_t end = flushed_;
+        size_t nbBytes = 0;
+        auto sendRun = [&] {
+            if (end > flushed_) {
+                send(std::span<std::byte const>(buffer_.data() + flushed_,
+                                                end - flushed_));
+                nbBytes += end - flushed_;
+                flushed_ = end;
+            }
+        };
+
+        while (next_ < maxRecords_) {
+            std::uint64_t recordEnd =
+                ends_[next_].load(std::memory_order_acquire);
+            if (recordEnd == 0) {
+                break;
+            }
+            if (recordEnd == sealed_record) {
+                sealed_ = true;
+                break;
+            }
+            if (recordEnd & abandoned_record) {
+                sendRun();
+                flushed_ = end = (recordEnd & ~abandoned_record) - 1;
+            } else {
+                end = recordEnd - 1;
+            }
+            ++next_;
+        }
+        sendRun();
+        return nbBytes;
+    }
+
+    /// @brief True when a reservation has failed and all the records before
+    ///        it have been flushed (the buffer should be reset).
+    bool sealed() const { return sealed_ || next_ == maxRecords_; }
+
+    /// @brief True when all the records reserved have been flushed.
+    bool empty() const {
+        std::uint64_t cursor = cursor_.load(std::memory_order_acquire);
+        return sealed() || next_ == cursor >> count_shift;
+    }
+
+    /// @brief Reuse the buffer. No producer should use the buffer during the
+    ///        reset, including the producers which reservation failed.
+    void reset() {
+        size_t nbRecords =
+            std::min(size_t(cursor_.load(std::memory_order_relaxed) >>
+                            count_shift),
+                     maxRecords_);
+
+        for (size_t i = 0; i < nbRecords; ++i) {
+            ends_[i].store(0, std::memory_order_relaxed);
+        }
+        cursor_.store(0, std::memory_order_release);
+        next_ = 0;
+        flushed_ = 0;
+        sealed_ = false;
+    }
+
+  private:
+    static constexpr size_t count_shift = 40;
+    static constexpr std::uint64_t bytes_mask =
+        (std::uint64_t(1) << count_shift) - 1;
+    static constexpr std::uint64_t count_mask = ~std::uint64_t(0) >>
+                                                count_shift;
+    static constexpr std::uint64_t sealed_record = ~std::uint64_t(0);
+    static constexpr std::uint64_t abandoned_record = std::uint64_t(1) << 63;
+
+    tools::Bytes<std::byte> buffer_; ///< serialized records
+    size_t maxRecords_ = 0;          ///< maximum number of records
+    /// @brief End of each committed record + 1 (0 while the record is
+    ///        written, sealed_record when its reservation failed, with the
+    ///        abandoned_record bit when its serialization failed).
+    std::unique_ptr<std::atomic<std::uint64_t>[]> ends_;
+    alignas(64) std::atomic<std::uint64_t> cursor_ = 0; ///< records | bytes
+    alignas(64) size_t next_ = 0;                       ///< next record
+    size_t flushed_ = 0;                                ///< bytes sent
+    bool sealed_ = false;                               ///< failed reserve
+};
+
+} // end namespace serializer::io
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef SERIALIZER_IO_CHECKPOINT_HPP
+#define SERIALIZER_IO_CHECKPOINT_HPP
+#include "../exceptions/corrupt_frame.hpp"
+#include "../frame.hpp"
+#include "../serialize.hpp"
+#include "../tools/bytes.hpp"
+#include "../tools/frame.hpp"
+#include "../tools/macros.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************/
+/*                                 checkpoint                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Location of the last saved version of a block.
+struct CheckpointEntry {
+    std::uint64_t generation = 0; ///< snapshot that contains the block
+    std::uint64_t offset = 0;     ///< position of the frame in the file
+    std::uint64_t size = 0;       ///< size of the frame (0: never saved)
+};
+
+/// @brief Content of the manifest file: the location of every block.
+struct CheckpointManifest {
+    std::uint64_t generation = 0;         ///< last snapshot
+    std::vector<CheckpointEntry> entries; ///< location of the blocks
+    SERIALIZE(generation, entries);
+};
+
+/// @brief Options of the checkpoints.
+struct CheckpointOptions {
+    /// @brief A full snapshot is written when the snapshot files are larger
+    ///        than compactRatio times the size of the saved blocks.
+    double compactRatio = 2;
+    std::uint16_t flags = tools::frame_checksum; ///< flags of the frames
+};
+
+/// @brief Incremental checkpoints of a set of objects. Each registered object
+///        is a block identified by its registration number. The blocks are
+///        marked dirty when they change, and a snapshot only writes the dirty
+///        blocks (in frames which type is the block id) in a new file of the
+///        directory, followed by the manifest that gives the location of the
+///        last version of every block. A restore loads each block from the file
+///        of its last version (the base snapshot or one of the deltas). When
+///        the delta files become too large compared to the live data, a full
+///        snapshot is written and the older files are removed.
+///        The manifest is replaced atomically (rename), so a crash during a
+///        snapshot leaves the previous checkpoint intact.
+class Checkpoint {
+  public:
+    using bytes_type = tools::Bytes<std::byte>;
+
+    /* constructors ***********************************************************/
+
+    /// @brief Open (or create) the checkpoint directory and read its
+    ///        manifest (the objects are loaded by restore).
+    /// @param directory Directory of the snapshot files.
+    /// @param options Options.
+    /// @throw std::system_error when the directory cannot be created.
+    /// @throw exceptions::CorruptFrameError when the manifest is corrupt.
+    explicit Checkpoint(std::string directory, CheckpointOptions options = {})
+        : directory_(std::move(directory)), options_(options) {
+        if (::mkdir(directory_.c_str(), 0755) < 0 && errno != EEXIST) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot create " + directory_ +
+                                        ".");
+        }
+        loadManifest();
+    }
+
+    Checkpoint(Checkpoint const &) = delete;
+    Checkpoint &operator=(Checkpoint const &) = delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of registered blocks.
+    size_t size() const { return blocks_.size(); }
+
+    /// @brief Number of the last snapshot.
+    size_t generation() const { return manifest_.generation; }
+
+    /// @brief Size of the snapshot files referenced by the manifest.
+    size_t storedSize() const { return stored_; }
+
+    /// @brief Size of the last version of the blocks.
+    size_t liveSize() const { return live_; }
+
+    /// @brief True if the block has changed since the last snapshot.
+    bool dirty(size_t block) const { return blocks_.at(block).dirty; }
+
+    /* blocks *****************************************************************/
+
+    /// @brief Register an object as a new block (the block is dirty).
+    /// @tparam Ser Serializer used for the object.
+    /// @param obj Object (it should outlive the checkpoint).
+    /// @return Id of the block.
+    template <typename Ser = Serializer<bytes_type>> size_t add(auto &obj) {
+        using T = std::remove_reference_t<decltype(obj)>;
+        Block block;
+
+        block.obj = &obj;
+        block.serialize = [](void const *obj, bytes_type &mem, size_t pos) {
+            return serialize<Ser>(mem, pos, *static_cast<T const *>(obj));
+        };
+        block.deserialize = [](void *obj, bytes_type &mem, size_t pos) {
+            return deserialize<Ser>(mem, pos, *static_cast<T *>(obj));
+        };
+        ids_[&obj] = blocks_.size();
+        blocks_.push_back(block);
+        return blocks_.size() - 1;
+    }
+
+    /// @brief Mark a block as changed.
+    /// @param block Id of the block.
+    void markDirty(size_t block) { blocks_.at(block).dirty = true; }
+
+    /// @brief Mark the block of a registered object as changed.
+    /// @param obj Registered object.
+    /// @throw std::out_of_range when the object is not registered.
+    template <typename T>
+        requires(!std::is_integral_v<T>)
+    void markDirty(T const &obj) {
+        auto it = ids_.find(&obj);
+        if (it == ids_.end()) [[unlikely]] {
+            throw std::out_of_range("error: object not registered.");
+        }
+        blocks_[it->second].dirty = true;
+    }
+
+    /* snapshot ***************************************************************/
+
+    /// @brief Write the dirty blocks and the manifest (a full snapshot is
+    ///        written when the files should be compacted). Nothing is written
+    ///        when no block is dirty.
+    /// @return Number of blocks written.
+    /// @throw std::system_error when a write fails.
+    size_t snapshot() {
+        if (std::none_of(blocks_.begin(), blocks_.end(),
+                         [](Block const &block) { return block.dirty; })) {
+            return 0;
+        }
+        bool full = double(stored_) > options_.compactRatio * double(live_);
+        return write(full);
+    }
+
+    /// @brief Write all the blocks in a new base snapshot and remove the older
+    ///        files.
+    /// @return Number of blocks written.
+    /// @throw std::system_error when a write fails.
+    size_t compact() { return write(true); }
+
+    /// @brief Load the last saved version of the registered blocks (the
+    ///        blocks that have never been saved are not modified).
+    /// @return False when there is no checkpoint.
+    /// @throw std::system_error when a file cannot be read.
+    /// @throw exceptions::CorruptFrameError when a block is corrupt.
+    bool restore() {
+        if (manifest_.generation == 0) {
+            return false;
+        }
+        std::map<std::uint64_t, bytes_type> files;
+        for (size_t id = 0; id < blocks_.size(); ++id) {
+            if (id >= manifest_.entries.size()) {
+                break;
+            }
+            CheckpointEntry const &entry = manifest_.entries[id];
+            if (entry.size == 0) {
+                continue;
+            }
+            auto it = files.find(entry.generation);
+            if (it == files.end()) {
+                it = files.emplace(entry.generation,
+                                   readFile(fileName(entry.generation)))
+                         .first;
+            }
+            Frame frame = readFrame(it->second, entry.offset);
+            if (frame.header.type != id) [[unlikely]] {
+                throw exceptions::CorruptFrameError(entry.offset,
+                                                    "invalid block id");
+            }
+            if (blocks_[id].deserialize(blocks_[id].obj, it->second,
+                                        frame.pos) != frame.end()) {
+                throw exceptions::CorruptFrameError(entry.offset,
+                                                    "invalid payload");
+            }
+            blocks_[id].dirty = false;
+        }
+        return true;
+    }
+
+  private:
+    /// @brief Registered object.
+    struct Block {
+        void *obj = nullptr; ///< object
+        size_t (*serialize)(void const *, bytes_type &, size_t) = nullptr;
+        size_t (*deserialize)(void *, bytes_type &, size_t) = nullptr;
+        bool dirty = true; ///< changed since the last snapshot
+    };
+
+    std::string directory_;                           ///< snapshot files
+    CheckpointOptions options_;                       ///< options
+    std::vector<Block> blocks_;                       ///< registered objects
+    std::unordered_map<void const *, size_t> ids_;    ///< ids of the objects
+    CheckpointManifest manifest_;                     ///< saved blocks
+    std::map<std::uint64_t, size_t> files_;           ///< sizes of the files
+    size_t stored_ = 0;                               ///< size of the files
+    size_t live_ = 0;                                 ///< size of the blocks
+    bytes_type buffer_;                               ///< snapshot data
+
+    /// @brief Path of the file of a snapshot.
+    std::string fileName(std::uint64_t generation) const {
+        return directory_ + "/" + std::to_string(generation) + ".blocks";
+    }
+
+    /// @brief Path of the manifest.
+    std::string manifestName() const { return directory_ + "/manifest"; }
+
+    /// @brief Write the dirty blocks (or all the blocks) in a new snapshot
+    ///        file and replace the manifest.
+    size_t write(bool full) {
+        CheckpointManifest manifest = manifest_;
+        size_t count = 0;
+
+        manifest.generation += 1;
+        manifest.entries.resize(std::max(manifest.entries.size(),
+                                          blocks_.size()));
+        buffer_.clear();
+        for (size_t id = 0; id < blocks_.size(); ++id) {
+            if (!full && !blocks_[id].dirty) {
+                continue;
+            }
+            size_t pos = buffer_.size();
+            Serializer<bytes_type &> serializer(buffer_, pos);
+            serializer.append(tools::FrameHeader());
+            size_t end = blocks_[id].serialize(blocks_[id].obj, buffer_,
+                                               serializer.pos);
+            writeFrameHeader(buffer_, pos, std::uint32_t(id), end,
+                             options_.flags);
+            manifest.entries[id] = {manifest.generation, pos, end - pos};
+            ++count;
+        }
+        writeFile(fileName(manifest.generation), buffer_);
+
+        // the manifest is written in a frame
+        bytes_type mem;
+        serializeFrame(mem, 0, 0, manifest, options_.flags);
+        writeFile(manifestName() + ".tmp", mem);
+        if (::rename((manifestName() + ".tmp").c_str(),
+                     manifestName().c_str()) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot write the manifest.");
+        }
+        syncDirectory();
+        manifest_ = std::move(manifest);
+        for (auto &block : blocks_) {
+            block.dirty = false;
+        }
+        updateFiles(buffer_.size());
+        return count;
+    }
+
+    /// @brief Update the sizes and remove the files that do not contain any
+    ///        block anymore.
+    void updateFiles(size_t newFileSize) {
+        std::map<std::uint64_t, size_t> files;
+
+        live_ = 0;
+        for (auto const &entry : manifest_.entries) {
+            live_ += entry.size;
+            if (entry.size > 0) {
+                files[entry.generation] = 0;
+            }
+        }
+        files_[manifest_.generation] = newFileSize;
+        stored_ = 0;
+        for (auto const &[generation, size] : files_) {
+            if (files.contains(generation)) {
+                files[generation] = size;
+                stored_ += size;
+            } else {
+                ::unlink(fileName(generation).c_str());
+            }
+        }
+        files_ = std::move(files);
+    }
+
+    /// @brief Read the manifest of the directory (when it exists).
+    void loadManifest() {
+        struct stat st;
+
+        if (::stat(manifestName().c_str(), &st) < 0) {
+            return;
+        }
+        bytes_type mem = readFile(manifestName());
+        Frame frame = readFrame(mem, 0);
+        deserializeFrame(mem, frame, manifest_);
+        for (auto const &entry : manifest_.entries) {
+            if (entry.size > 0 && !files_.contains(entry.generation)) {
+                if (::stat(fileName(entry.generation).c_str(), &st) < 0) {
+                    throw std::system_error(errno, std::generic_category(),
+                                            "error: missing snapshot file.");
+                }
+                files_[entry.generation] = size_t(st.st_size);
+                stored_ += size_t(st.st_size);
+            }
+            live_ += entry.size;
+        }
+    }
+
+    /// @brief Read a whole file.
+    static bytes_type readFile(std::string const &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+
+        if (fd < 0 || fstat(fd, &st) < 0) {
+            int error = errno;
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::system_error(error, std::generic_category(),
+                                    "error: cannot read " + path + ".");
+        }
+        bytes_type mem(size_t(st.st_size), size_t(st.st_size));
+        size_t pos = 0;
+        while (pos < mem.size()) {
+            ssize_t count = ::pread(fd, mem.data() + pos, mem.size() - pos,
+                                    off_t(pos));
+            if (count <= 0) {
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                ::close(fd);
+                throw std::system_error(count < 0 ? errno : EIO,
+                                        std::generic_category(),
+                                        "error: cannot read " + path + ".");
+            }
+            pos += size_t(count);
+        }
+        ::close(fd);
+        return mem;
+    }
+
+    /// @brief Write and sync a whole file (the file is replaced).
+    static void writeFile(std::string const &path, bytes_type const &mem) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot open " + path + ".");
+        }
+        size_t pos = 0;
+        while (pos < mem.size()) {
+            ssize_t count = ::write(fd, mem.data() + pos, mem.size() - pos);
+            if (count < 0) [[unlikely]] {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ::close(fd);
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot write " + path + ".");
+            }
+            pos += size_t(count);
+        }
+        if (fdatasync(fd) < 0) {
+            ::close(fd);
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot sync " + path + ".");
+        }
+        ::close(fd);
+    }
+
+    /// @brief Write the directory entries to the disk (rename).
+    void syncDirectory() const {
+        int fd = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef SERIALIZER_IO_PIPELINED_SENDER_HPP
+#define SERIALIZER_IO_PIPELINED_SENDER_HPP
+#include "../tools/frame.hpp"
+#include "../tools/stream.hpp"
+#include "batch_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/******************************************************************************/
+/*                              pipelined sender                              */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Options of the pipelined senders. The flush policy is given by the
+///        size and latency budgets: the current batch is sent when it holds
+///        batchBytes bytes, or when its first message is older than maxDelay.
+///        With batchBytes = 0, the batch is sealed after each message.
+struct PipelineOptions {
+    size_t nbBuffers = 2;                    ///< rotating buffers (>= 2)
+    size_t bufferSize = 1 << 20;             ///< size of the buffers
+    size_t maxRecords = 4096;                ///< messages per buffer
+    size_t batchBytes = 64 << 10;            ///< size budget of a batch
+    std::chrono::microseconds maxDelay{100}; ///< latency budget of a batch
+};
+
+/// @brief Sender that overlaps the serialization of the messages with their
+///        transmission. The messages are serialized in place in the current
+///        buffer of a ring of batch buffers (see BatchBuffer, several threads
+///        can post concurrently), and a transmission thread writes the sealed
+///        buffers to the sink while the next messages are serialized in the
+///        next buffer. The small messages are coalesced in batches according
+///        to the size and latency budgets of the options. When all the
+///        buffers are in flight, the producers wait for the transmission.
+/// @tparam Sink Destination of the bytes (write(std::byte const *, size_t)),
+///         only used by the transmission thread.
+template <typename Sink> class PipelinedSender {
+  public:
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor (starts the transmission thread).
+    /// @param sink Destination of the bytes.
+    /// @param options Buffers and flush policy.
+    explicit PipelinedSender(Sink sink, PipelineOptions options = {})
+        : sink_(std::move(sink)), options_(options) {
+        options_.nbBuffers = std::max(options_.nbBuffers, size_t(2));
+        for (size_t i = 0; i < options_.nbBuffers; ++i) {
+            slots_.push_back(std::make_unique<Slot>(options_.bufferSize,
+                                                    options_.maxRecords));
+            free_.push_back(slots_.back().get());
+        }
+        active_ = free_.front();
+        free_.pop_front();
+        thread_ = std::thread([this] { run(); });
+    }
+
+    PipelinedSender(PipelinedSender const &) = delete;
+    PipelinedSender &operator=(PipelinedSender const &) = delete;
+
+    /// @brief Destructor (the pending messages are sent, the errors are
+    ///        ignored, call flush to handle them).
+    ~PipelinedSender() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_.notify_all();
+        thread_.join();
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of batches written to the sink.
+    size_t nbBatches() const { return nbBatches_; }
+
+    /// @brief Number of bytes written to the sink.
+    size_t nbBytes() const { return nbBytes_; }
+
+    /* producers **************************************************************/
+
+    /// @brief Serialize obj in the current batch.
+    /// @param obj Object to send (should have a serialize method).
+    /// @throw std::length_error when obj does not fit in a buffer.
+    /// @throw The error of the transmission thread.
+    void post(auto const &obj) {
+        tools::ByteCounter counter;
+        obj.serialize(counter);
+        post(counter.size(), [&](std::span<std::byte> data) {
+            obj.serialize(data);
+        });
+    }
+
+    /// @brief Serialize obj in a frame (see serializeFrame) in the current
+    ///        batch.
+    /// @param obj Object to send (should have a serialize method).
+    /// @param type Type id of the payload.
+    /// @param flags Flags of the frame.
+    /// @throw std::length_error when obj does not fit in a buffer.
+    /// @throw The error of the transmission thread.
+    void postFrame(auto const &obj, std::uint32_t type = 0,
+                   std::uint16_t flags = tools::frame_checksum) {
+        tools::ByteCounter counter;
+        obj.serialize(counter);
+        post(sizeof(tools::FrameHeader) + counter.size(),
+             [&](std::span<std::byte> data) {
+                 serializeFrame(data, 0, type, obj, flags);
+             });
+    }
+
+    /// @brief Send the current batch and wait for the transmission of all
+    ///        the messages posted before the call.
+    /// @throw The error of the transmission thread.
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (active_.load()->batch.reserved() > 0) {
+            seal(lock, active_.load());
+        }
+        size_t target = nbSealed_;
+        done_.wait(lock, [&] { return nbSent_ >= target || error_; });
+        rethrow();
+    }
+
+  private:
+    /// @brief Buffer of the ring.
+    struct Slot {
+        Slot(size_t bufferSize, size_t maxRecords)
+            : batch(bufferSize, maxRecords) {}
+
+        BatchBuffer batch;               ///< serialized messages
+        std::atomic<size_t> writers = 0; ///< producers using the buffer
+        /// @brief Time of the first message (nanoseconds, steady clock).
+        std::atomic<std::int64_t> first = 0;
+    };
+
+    Sink sink_;                                ///< destination
+    PipelineOptions options_;                  ///< options
+    std::vector<std::unique_ptr<Slot>> slots_; ///< ring of buffers
+    std::atomic<Slot *> active_ = nullptr;     ///< buffer of the producers
+    std::deque<Slot *> sealed_;                ///< buffers to send
+    std::deque<Slot *> free_;                  ///< buffers sent
+    std::mutex mutex_;                         ///< protects the queues
+    std::condition_variable work_;             ///< work for the thread
+    std::condition_variable done_;             ///< buffer sent or error
+    size_t nbSealed_ = 0;                      ///< buffers sealed
+    size_t nbSent_ = 0;                        ///< buffers sent
+    std::atomic<size_t> nbBatches_ = 0;        ///< batches written
+    std::atomic<size_t> nbBytes_ = 0;          ///< bytes written
+    std::exception_ptr error_;                 ///< error of the thread
+    bool stop_ = false;                        ///< destruction
+    std::thread thread_;                       ///< transmission thread
+
+    static std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /// @brief Throw the error of the transmission thread (locked).
+    void rethrow() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    /// @brief Register the calling thread as a writer of the active buffer.
+    ///        The active buffer is checked again after the registration, so
+    ///        a buffer is never written after it has been sealed and its
+    ///        writers have left.
+    Slot *enter() {
+        while (true) {
+            Slot *slot = active_.load();
+            slot->writers.fetch_add(1);
+            if (active_.load() == slot) {
+                return slot;
+            }
+            slot->writers.fetch_sub(1);
+        }
+    }
+
+    /// @brief Reserve nbBytes in the active buffer and serialize the message
+    ///        with write(std::span<std::byte>).
+    void post(size_t nbBytes, auto &&write) {
+        if (nbBytes > options_.bufferSize) [[unlikely]] {
+            throw std::length_error("error: message larger than the buffers.");
+        }
+        while (true) {
+            Slot *slot = enter();
+            auto region = slot->batch.tryReserve(nbBytes);
+            if (region) {
+                try {
+                    write(region->data);
+                } catch (...) {
+                    // the region is skipped, the batch is still sent
+                    slot->batch.abandon(*region);
+                    if (region->offset == 0) {
+                        slot->first.store(now());
+                    }
+                    slot->writers.fetch_sub(1);
+                    throw;
+                }
+                slot->batch.commit(*region);
+                if (region->offset == 0) {
+                    slot->first.store(now());
+                }
+                slot->writers.fetch_sub(1);
+                size_t end = region->offset + nbBytes;
+                bool full = end >= options_.batchBytes &&
+                            (region->offset == 0 ||
+                             region->offset < options_.batchBytes);
+                if (full) {
+                    // the message that reaches the size budget seals the batch
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    rethrow();
+                    if (active_.load() == slot) {
+                        seal(lock, slot);
+                    }
+                } else if (region->offset == 0) {
+                    // first message: start the latency budget
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    rethrow();
+                    work_.notify_one();
+                }
+                return;
+            }
+            slot->writers.fetch_sub(1);
+            std::unique_lock<std::mutex> lock(mutex_);
+            rethrow();
+            if (active_.load() == slot) {
+                seal(lock, slot);
+            }
+        }
+    }
+
+    /// @brief Replace the active buffer by a free one and queue it for the
+    ///        transmission thread (locked, waits for a free buffer).
+    void seal(std::unique_lock<std::mutex> &lock, Slot *slot) {
+        done_.wait(lock, [&] {
+            return !free_.empty() || active_.load() != slot || error_;
+        });
+        rethrow();
+        if (active_.load() != slot) {
+            return;
+        }
+        active_.store(free_.front());
+        free_.pop_front();
+        sealed_.push_back(slot);
+        ++nbSealed_;
+        work_.notify_one();
+    }
+
+    /// @brief Write a sealed buffer to the sink (once its writers left).
+    void transmit(Slot *slot) {
+        while (slot->writers.load() > 0) {
+            std::this_thread::yield();
+        }
+        slot->batch.flush([&](std::span<std::byte const> bytes) {
+            sink_.write(bytes.data(), bytes.size());
+            nbBytes_ += bytes.size();
+        });
+        ++nbBatches_;
+        slot->batch.reset();
+        slot->first.store(0);
+    }
+
+    /// @brief Loop of the transmission thread.
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true) {
+            if (!sealed_.empty()) {
+                Slot *slot = sealed_.front();
+                sealed_.pop_front();
+                lock.unlock();
+                try {
+                    transmit(slot);
+                } catch (...) {
+                    lock.lock();
+                    error_ = std::current_exception();
+                    done_.notify_all();
+                    return;
+                }
+                lock.lock();
+                free_.push_back(slot);
+                ++nbSent_;
+                done_.notify_all();
+                continue;
+            }
+            Slot *active = active_.load();
+            size_t reserved = active->batch.reserved();
+            std::int64_t first = active->first.load();
+            auto deadline =
+                first + std::chrono::nanoseconds(options_.maxDelay).count();
+            if (reserved > 0 &&
+                (stop_ || reserved >= options_.batchBytes ||
+                 (first != 0 && now() >= deadline))) {
+                seal(lock, active);
+                continue;
+            }
+            if (stop_) {
+                return;
+            }
+            if (first != 0) {
+                work_.wait_until(lock, std::chrono::steady_clock::time_point(
+                                           std::chrono::nanoseconds(deadline)));
+            } else if (reserved > 0) {
+                // the first message is being written
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            } else {
+                work_.wait(lock);
+            }
+        }
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
@@ -0,0 +1,396 @@
+#ifndef SERIALIZER_IO_RECORD_LOG_HPP
+#define SERIALIZER_IO_RECORD_LOG_HPP
+#include "../exceptions/corrupt_frame.hpp"
+#include "../frame.hpp"
+#include "../tools/bytes.hpp"
+#include "../tools/frame.hpp"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+/******************************************************************************/
+/*                                 record log                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Value stored in the trailer of the index file ("LOGINDEX").
+inline constexpr std::uint64_t record_index_magic = 0x5845444e49474f4c;
+
+/// @brief Trailer written after the offsets in the index file by each
+///        checkpoint. It describes the part of the log that is covered by the
+///        index.
+struct RecordIndexTrailer {
+    std::uint64_t magic = record_index_magic; ///< trailer marker
+    std::uint64_t count = 0;                  ///< number of offsets
+    std::uint64_t dataSize = 0;               ///< size of the data file
+    std::uint32_t offsetsChecksum = 0;        ///< crc32 of the offsets
+    std::uint32_t checksum = 0;               ///< crc32 of the previous fields
+};
+
+/// @brief Options of the record logs.
+struct RecordLogOptions {
+    size_t bufferSize = 1 << 20;                 ///< size of the write blocks
+    std::uint16_t flags = tools::frame_checksum; ///< flags of the frames
+};
+
+/// @brief Append-only log of serialized records. Each record is stored in a
+///        frame (see serializeFrame) at the end of the data file, and the
+///        offsets of the records are kept in memory so the record i is found
+///        in O(1). The data file is mapped in memory for reading (the mapping
+///        grows geometrically, so it is rarely updated by the appends).
+///        The offsets are saved in the index file (path + ".index") by
+///        checkpoint, followed by a trailer. When the log is opened, the
+///        records appended after the last checkpoint are recovered by reading
+///        the frames that follow it, and the data file is truncated after the
+///        last valid frame (partial writes are dropped). Without a valid
+///        trailer, all the frames are read again.
+///        The log should be used by a single thread.
+class RecordLog {
+  public:
+    using byte_type = std::byte;
+    using view_type = std::span<std::byte const>;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Open (or create) a log and recover the records appended after
+    ///        the last checkpoint.
+    /// @param path Path to the data file.
+    /// @param options Options.
+    /// @throw std::system_error when a file cannot be opened.
+    /// @throw The errors of the recovery (the files are closed).
+    explicit RecordLog(std::string const &path, RecordLogOptions options = {})
+        : options_(options), buffer_(options.bufferSize) {
+        dataFd_ = openFile(path);
+        try {
+            indexFd_ = openFile(path + ".index");
+            recover();
+        } catch (...) {
+            // the destructor is not called
+            unmap();
+            if (indexFd_ >= 0) {
+                ::close(indexFd_);
+            }
+            ::close(dataFd_);
+            throw;
+        }
+    }
+
+    RecordLog(RecordLog const &) = delete;
+    RecordLog &operator=(RecordLog const &) = delete;
+
+    /// @brief Destructor (checkpoint and close, the errors are ignored, call
+    ///        checkpoint to handle them).
+    ~RecordLog() {
+        try {
+            checkpoint();
+        } catch (...) {
+        }
+        unmap();
+        ::close(dataFd_);
+        ::close(indexFd_);
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of records.
+    size_t size() const { return offsets_.size(); }
+
+    /// @brief Number of records recovered by reading the frames when the log
+    ///        was opened (records appended after the last checkpoint).
+    size_t recovered() const { return recovered_; }
+
+    /// @brief Size of the data (written or buffered).
+    size_t dataSize() const { return written_ + buffer_.size(); }
+
+    /* append *****************************************************************/
+
+    /// @brief Serialize an object at the end of the log.
+    /// @param obj Object to serialize (should have a serialize method).
+    /// @param type Type id stored in the frame of the record.
+    /// @return Number of the record.
+    size_t append(auto const &obj, std::uint32_t type = 0) {
+        size_t pos = buffer_.size();
+
+        offsets_.push_back(written_ + pos);
+        serializeFrame(buffer_, pos, type, obj, options_.flags);
+        if (buffer_.size() >= options_.bufferSize) {
+            flush();
+        }
+        return offsets_.size() - 1;
+    }
+
+    /* read *******************************************************************/
+
+    /// @brief Read the frame of the record idx.
+    /// @param idx Number of the record.
+    /// @return Frame (the positions are relative to view()).
+    /// @throw std::out_of_range when idx is not a valid record number.
+    /// @throw exceptions::CorruptFrameError when the record is corrupt.
+    Frame frame(size_t idx) {
+        if (idx >= offsets_.size()) [[unlikely]] {
+            throw std::out_of_range("error: record index out of range.");
+        }
+        return readFrame(view(offsets_[idx]), offsets_[idx]);
+    }
+
+    /// @brief Access to the serialized payload of the record idx.
+    /// @param idx Number of the record.
+    view_type payload(size_t idx) {
+        Frame frame = this->frame(idx);
+        return framePayload(mapped_, frame);
+    }
+
+    /// @brief Deserialize the record idx into obj.
+    /// @param idx Number of the record.
+    /// @param obj Object to deserialize (should have a deserialize method).
+    /// @return Type id of the record.
+    std::uint32_t read(size_t idx, auto &obj) {
+        Frame frame = this->frame(idx);
+        deserializeFrame(mapped_, frame, obj);
+        return frame.header.type;
+    }
+
+    /// @brief View on the data file that contains the position pos (the
+    ///        buffered data is written and the mapping is extended when
+    ///        required). The view is invalidated by the next append.
+    view_type view(size_t pos = 0) {
+        if (pos >= written_) {
+            flush();
+        }
+        if (mapped_.size() < written_) {
+            if (mappingSize_ < written_) {
+                map(std::max(written_, 2 * mappingSize_));
+            }
+            mapped_ = view_type(mapped_.data(), written_);
+        }
+        return mapped_;
+    }
+
+    /* persistence ************************************************************/
+
+    /// @brief Write the buffered records to the data file.
+    /// @throw std::system_error when the write fails.
+    void flush() {
+        writeAll(dataFd_, buffer_.data(), buffer_.size(), written_);
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    /// @brief Write the data to the disk and save the offsets in the index
+    ///        file, followed by the trailer.
+    /// @throw std::system_error when the write fails.
+    void checkpoint() {
+        flush();
+        if (indexed_ == offsets_.size() && indexedSize_ == written_) {
+            return;
+        }
+        sync(dataFd_);
+        auto bytes = std::bit_cast<std::byte const *>(offsets_.data()) +
+                     indexed_ * sizeof(std::uint64_t);
+        size_t nbBytes = (offsets_.size() - indexed_) * sizeof(std::uint64_t);
+        RecordIndexTrailer trailer;
+
+        offsetsChecksum_ = tools::crc32(bytes, nbBytes, offsetsChecksum_);
+        trailer.count = offsets_.size();
+        trailer.dataSize = written_;
+        trailer.offsetsChecksum = offsetsChecksum_;
+        trailer.checksum = trailerChecksum(trailer);
+        writeAll(indexFd_, bytes, nbBytes, indexed_ * sizeof(std::uint64_t));
+        writeAll(indexFd_, &trailer, sizeof(trailer),
+                 offsets_.size() * sizeof(std::uint64_t));
+        // the index file is shorter than before when it has been rebuilt
+        if (ftruncate(indexFd_, off_t(offsets_.size() * sizeof(std::uint64_t) +
+                                      sizeof(trailer))) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot truncate the index.");
+        }
+        sync(indexFd_);
+        indexed_ = offsets_.size();
+        indexedSize_ = written_;
+    }
+
+  private:
+    RecordLogOptions options_;           ///< options
+    tools::Bytes<std::byte> buffer_;     ///< records not written yet
+    int dataFd_ = -1;                    ///< data file
+    int indexFd_ = -1;                   ///< index file
+    std::vector<std::uint64_t> offsets_; ///< positions of the records
+    size_t written_ = 0;                 ///< size of the data file
+    view_type mapped_;                   ///< mapped data (written)
+    size_t mappingSize_ = 0;             ///< size of the mapping
+    size_t indexed_ = 0;                 ///< offsets in the index file
+    size_t indexedSize_ = 0;             ///< data covered by the index
+    std::uint32_t offsetsChecksum_ = 0;  ///< crc32 of the saved offsets
+    size_t recovered_ = 0;               ///< records recovered on open
+
+    /// @brief Open or create a file.
+    static int openFile(std::string const &path) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot open " + path + ".");
+        }
+        return fd;
+    }
+
+    /// @brief Size of a file.
+    static size_t fileSize(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot stat the log.");
+        }
+        return size_t(st.st_size);
+    }
+
+    /// @brief Write all the bytes at the given offset.
+    static void writeAll(int fd, void const *bytes, size_t nbBytes,
+                         size_t offset) {
+        auto ptr = static_cast<std::byte const *>(bytes);
+        while (nbBytes > 0) {
+            ssize_t count = ::pwrite(fd, ptr, nbBytes, off_t(offset));
+            if (count < 0) [[unlikely]] {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot write the log.");
+            }
+            ptr += count;
+            nbBytes -= size_t(count);
+            offset += size_t(count);
+        }
+    }
+
+    /// @brief Write the data of a file to the disk.
+    static void sync(int fd) {
+        if (fdatasync(fd) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot sync the log.");
+        }
+    }
+
+    /// @brief Compute the checksum of the fields of a trailer that precede it.
+    static std::uint32_t trailerChecksum(RecordIndexTrailer const &trailer) {
+        return tools::crc32(std::bit_cast<std::byte const *>(&trailer),
+                            offsetof(RecordIndexTrailer, checksum));
+    }
+
+    /// @brief Map (or extend the mapping to) the first nbBytes of the data
+    ///        file. The mapping can be larger than the file, the part that
+    ///        follows the written data is not accessed until it is written.
+    void map(size_t nbBytes) {
+        if (nbBytes == 0) {
+            unmap();
+            return;
+        }
+        void *mapping = const_cast<std::byte *>(mapped_.data());
+        void *ptr = mappingSize_ > 0
+                        ? mremap(mapping, mappingSize_, nbBytes, MREMAP_MAYMOVE)
+                        : mmap(nullptr, nbBytes, PROT_READ, MAP_SHARED,
+                               dataFd_, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot map the log.");
+        }
+        mappingSize_ = nbBytes;
+        mapped_ = view_type(static_cast<std::byte const *>(ptr),
+                            std::min(nbBytes, written_));
+    }
+
+    /// @brief Remove the mapping of the data file.
+    void unmap() {
+        if (mappingSize_ > 0) {
+            munmap(const_cast<std::byte *>(mapped_.data()), mappingSize_);
+            mapped_ = view_type();
+            mappingSize_ = 0;
+        }
+    }
+
+    /// @brief Load the index saved by the last checkpoint (when it is valid)
+    ///        and read the frames that follow it.
+    void recover() {
+        size_t indexSize = fileSize(indexFd_);
+        size_t dataSize = fileSize(dataFd_);
+        RecordIndexTrailer trailer;
+
+        if (indexSize >= sizeof(trailer)) {
+            ssize_t count = ::pread(indexFd_, &trailer, sizeof(trailer),
+                                    off_t(indexSize - sizeof(trailer)));
+            if (count == ssize_t(sizeof(trailer)) &&
+                trailer.magic == record_index_magic &&
+                trailer.checksum == trailerChecksum(trailer) &&
+                trailer.dataSize <= dataSize &&
+                (indexSize - sizeof(trailer)) / sizeof(std::uint64_t) ==
+                    trailer.count) {
+                loadIndex(trailer);
+            }
+        }
+        size_t pos = indexedSize_;
+        written_ = dataSize;
+        map(dataSize);
+        while (pos < dataSize) {
+            try {
+                Frame frame = readFrame(mapped_, pos);
+                offsets_.push_back(pos);
+                pos = frame.end();
+                ++recovered_;
+            } catch (exceptions::CorruptFrameError const &) {
+                break;
+            }
+        }
+        if (pos < dataSize) {
+            // partial write: the data after the last valid frame is dropped
+            unmap();
+            if (ftruncate(dataFd_, off_t(pos)) < 0) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot truncate the log.");
+            }
+            written_ = pos;
+            map(pos);
+        }
+        checkpoint();
+    }
+
+    /// @brief Read the offsets of the index file (they are ignored when they
+    ///        are not increasing or not in the data covered by the index).
+    void loadIndex(RecordIndexTrailer const &trailer) {
+        std::vector<std::uint64_t> offsets(trailer.count);
+        size_t nbBytes = trailer.count * sizeof(std::uint64_t);
+        ssize_t count = ::pread(indexFd_, offsets.data(), nbBytes, 0);
+
+        if (count != ssize_t(nbBytes) ||
+            tools::crc32(std::bit_cast<std::byte const *>(offsets.data()),
+                         nbBytes) != trailer.offsetsChecksum) {
+            return;
+        }
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            if (offsets[i] >= trailer.dataSize ||
+                (i > 0 && offsets[i] <= offsets[i - 1])) {
+                return;
+            }
+        }
+        offsets_ = std::move(offsets);
+        indexed_ = offsets_.size();
+        indexedSize_ = trailer.dataSize;
+        offsetsChecksum_ = trailer.offsetsChecksum;
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
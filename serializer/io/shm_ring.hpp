@@ -0,0 +1,394 @@
+#ifndef SERIALIZER_IO_SHM_RING_HPP
+#define SERIALIZER_IO_SHM_RING_HPP
+#include "../tools/stream.hpp"
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+/******************************************************************************/
+/*                             shared memory ring                             */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Value stored in the header of the rings ("SHMRING").
+inline constexpr std::uint64_t shm_ring_magic = 0x474e49524d4853;
+
+/// @brief Header of the shared memory rings (at the beginning of the shared
+///        memory, followed by the data). The positions only grow, the
+///        position of a record in the data is position % capacity.
+struct ShmRingHeader {
+    std::uint64_t magic = shm_ring_magic;        ///< ring marker
+    std::uint64_t capacity = 0;                  ///< size of the data
+    alignas(64) std::atomic<std::uint64_t> head; ///< consumer position
+    alignas(64) std::atomic<std::uint64_t> tail; ///< producer position
+};
+
+/// @brief Header of the records stored in the ring (records are aligned on
+///        8 bytes, so the payloads are aligned too).
+struct ShmRecordHeader {
+    std::atomic<std::uint32_t> state; ///< see shm_record_*
+    std::uint32_t length;             ///< number of bytes of the payload
+};
+
+/// @brief States of the records.
+inline constexpr std::uint32_t shm_record_empty = 0;     ///< not written
+inline constexpr std::uint32_t shm_record_committed = 1; ///< readable
+inline constexpr std::uint32_t shm_record_padding = 2;   ///< end of the data
+
+/// @brief Lock-free ring buffer of variable size records that lives in shared
+///        memory, used to transfer serialized objects between processes (or
+///        threads) of the same host. Objects are serialized directly into a
+///        slot reserved in the ring, and the consumer deserializes them from
+///        the slot in place (there is no intermediate buffer and no copy).
+///        The ring has one consumer. With MultiProducer, several producers
+///        can reserve slots concurrently (the slots are committed in any
+///        order, the consumer waits for the oldest one).
+/// @tparam MultiProducer True for multiple producers (MPSC), false for a
+///         single producer (SPSC).
+template <bool MultiProducer> class ShmRing {
+  public:
+    /// @brief Slot reserved in the ring (see tryReserve and commit).
+    struct Slot {
+        ShmRecordHeader *header = nullptr; ///< header of the record
+        std::span<std::byte> data;         ///< payload
+    };
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Create a ring in a named shared memory object (shm_open).
+    /// @param name Name of the shared memory object (ex: "/ring").
+    /// @param capacity Size of the data (power of 2).
+    /// @return Ring (owner of the shared memory object, it is unlinked when
+    ///         the ring is destroyed).
+    /// @throw std::system_error when the shared memory cannot be created.
+    static ShmRing create(std::string const &name, size_t capacity) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot create " + name + ".");
+        }
+        size_t size = sizeof(ShmRingHeader) + capacity;
+        if (ftruncate(fd, off_t(size)) < 0) {
+            int error = errno;
+            ::close(fd);
+            shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(),
+                                    "error: cannot resize " + name + ".");
+        }
+        ShmRing ring(map(fd, size), size, true);
+        ::close(fd);
+        ring.name_ = name;
+        return ring;
+    }
+
+    /// @brief Open a ring created by another process.
+    /// @param name Name of the shared memory object.
+    /// @throw std::system_error when the shared memory cannot be opened or
+    ///        does not contain a valid ring.
+    static ShmRing open(std::string const &name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot open " + name + ".");
+        }
+        std::uint64_t header[2]; // magic and capacity
+        struct stat st;
+        ssize_t count = ::pread(fd, header, sizeof(header), 0);
+        // the capacity is checked before mapping the object, so a corrupted
+        // header cannot map more than the object
+        if (count != ssize_t(sizeof(header)) || fstat(fd, &st) < 0 ||
+            header[0] != shm_ring_magic || !std::has_single_bit(header[1]) ||
+            header[1] < 64 ||
+            size_t(st.st_size) != sizeof(ShmRingHeader) + header[1]) {
+            ::close(fd);
+            throw std::system_error(EINVAL, std::generic_category(),
+                                    "error: invalid ring " + name + ".");
+        }
+        size_t size = sizeof(ShmRingHeader) + header[1];
+        ShmRing ring(map(fd, size), size, false);
+        ::close(fd);
+        return ring;
+    }
+
+    /// @brief Create a ring in an anonymous shared mapping (it is shared
+    ///        with the processes created by fork).
+    /// @param capacity Size of the data (power of 2).
+    static ShmRing anonymous(size_t capacity) {
+        size_t size = sizeof(ShmRingHeader) + capacity;
+        void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot map the ring.");
+        }
+        return ShmRing(mem, size, true);
+    }
+
+    ShmRing(ShmRing const &) = delete;
+    ShmRing &operator=(ShmRing const &) = delete;
+
+    ShmRing(ShmRing &&other) noexcept
+        : mem_(std::exchange(other.mem_, nullptr)),
+          size_(std::exchange(other.size_, 0)), header_(other.header_),
+          data_(other.data_), mask_(other.mask_),
+          name_(std::move(other.name_)) {
+        other.name_.clear();
+    }
+
+    /// @brief Destructor (unmap the ring and unlink the shared memory object
+    ///        created by this ring).
+    ~ShmRing() {
+        if (mem_ != nullptr) {
+            munmap(mem_, size_);
+        }
+        if (!name_.empty()) {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Size of the data.
+    size_t capacity() const { return mask_ + 1; }
+
+    /// @brief Number of bytes used by the records that are not consumed.
+    size_t used() const {
+        return size_t(header_->tail.load(std::memory_order_acquire) -
+                      header_->head.load(std::memory_order_acquire));
+    }
+
+    /* producer ***************************************************************/
+
+    /// @brief Reserve a slot of nbBytes (the slot must be committed).
+    /// @param nbBytes Size of the payload.
+    /// @return Slot, or nothing when the ring is full.
+    /// @throw std::length_error when the record is larger than the ring.
+    std::optional<Slot> tryReserve(size_t nbBytes) {
+        size_t recordSize = recordSize_(nbBytes);
+        if (recordSize > capacity()) [[unlikely]] {
+            throw std::length_error("error: record larger than the ring.");
+        }
+        auto &tail = header_->tail;
+        std::uint64_t pos = tail.load(std::memory_order_relaxed);
+        size_t padding = 0;
+
+        while (true) {
+            size_t offset = size_t(pos & mask_);
+            padding = offset + recordSize > capacity() ? capacity() - offset
+                                                       : 0;
+            std::uint64_t head =
+                header_->head.load(std::memory_order_acquire);
+            if (pos + padding + recordSize - head > capacity()) {
+                return std::nullopt;
+            }
+            if constexpr (MultiProducer) {
+                if (tail.compare_exchange_weak(pos,
+                                               pos + padding + recordSize,
+                                               std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                break;
+            }
+        }
+        if (padding > 0) {
+            recordHeader(pos)->length = std::uint32_t(padding);
+            recordHeader(pos)->state.store(shm_record_padding,
+                                           std::memory_order_release);
+            pos += padding;
+        }
+        ShmRecordHeader *header = recordHeader(pos);
+        header->length = std::uint32_t(nbBytes);
+        if constexpr (!MultiProducer) {
+            reserved_ = pos + recordSize;
+        }
+        return Slot{header,
+                    std::span(reinterpret_cast<std::byte *>(header + 1),
+                              nbBytes)};
+    }
+
+    /// @brief Make a reserved slot readable by the consumer.
+    void commit(Slot const &slot) {
+        slot.header->state.store(shm_record_committed,
+                                 std::memory_order_release);
+        if constexpr (!MultiProducer) {
+            header_->tail.store(reserved_, std::memory_order_release);
+        }
+    }
+
+    /// @brief Serialize obj directly in a slot of the ring (the object is
+    ///        measured first).
+    /// @param obj Object to serialize (should have a serialize method).
+    /// @return False when the ring is full.
+    bool trySend(auto const &obj) {
+        tools::ByteCounter counter;
+        obj.serialize(counter);
+        auto slot = tryReserve(counter.size());
+        if (!slot) {
+            return false;
+        }
+        obj.serialize(slot->data);
+        commit(*slot);
+        return true;
+    }
+
+    /// @brief Serialize obj in the ring (wait while the ring is full).
+    /// @param obj Object to serialize (should have a serialize method).
+    void send(auto const &obj) {
+        while (!trySend(obj)) {
+            std::this_thread::yield();
+        }
+    }
+
+    /* consumer ***************************************************************/
+
+    /// @brief Call fun on the payload of the next record (in place), and
+    ///        release the record when fun returns.
+    /// @param fun Function called with the payload (std::span<std::byte
+    ///            const>).
+    /// @return False when there is no record to read.
+    bool tryConsume(auto &&fun) {
+        auto &head = header_->head;
+        std::uint64_t pos = head.load(std::memory_order_relaxed);
+
+        while (true) {
+            ShmRecordHeader *header = recordHeader(pos);
+            if constexpr (MultiProducer) {
+                std::uint32_t state =
+                    header->state.load(std::memory_order_acquire);
+                if (state == shm_record_empty) {
+                    return false;
+                }
+                if (state == shm_record_padding) {
+                    size_t padding = header->length;
+                    std::memset(static_cast<void *>(header), 0, padding);
+                    pos += padding;
+                    head.store(pos, std::memory_order_release);
+                    continue;
+                }
+            } else {
+                if (pos == header_->tail.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                if (header->state.load(std::memory_order_relaxed) ==
+                    shm_record_padding) {
+                    pos += header->length;
+                    continue;
+                }
+            }
+            size_t recordSize = recordSize_(header->length);
+            fun(std::span<std::byte const>(
+                reinterpret_cast<std::byte const *>(header + 1),
+                header->length));
+            if constexpr (MultiProducer) {
+                // the headers of the next records are found in the data, so
+                // it is cleared before being reused
+                std::memset(static_cast<void *>(header), 0, recordSize);
+            }
+            head.store(pos + recordSize, std::memory_order_release);
+            return true;
+        }
+    }
+
+    /// @brief Deserialize the next record into obj (from the slot in place).
+    /// @param obj Object to deserialize (should have a deserialize method).
+    /// @return False when there is no record to read.
+    bool tryReceive(auto &obj) {
+        return tryConsume([&obj](std::span<std::byte const> payload) {
+            obj.deserialize(payload);
+        });
+    }
+
+    /// @brief Deserialize the next record into obj (wait while the ring is
+    ///        empty).
+    /// @param obj Object to deserialize (should have a deserialize method).
+    void receive(auto &obj) {
+        while (!tryReceive(obj)) {
+            std::this_thread::yield();
+        }
+    }
+
+  private:
+    void *mem_ = nullptr;             ///< shared memory
+    size_t size_ = 0;                 ///< size of the shared memory
+    ShmRingHeader *header_ = nullptr; ///< header of the ring
+    std::byte *data_ = nullptr;       ///< data of the ring
+    size_t mask_ = 0;                 ///< capacity - 1
+    std::uint64_t reserved_ = 0;      ///< end of the reserved slot (SPSC)
+    std::string name_;                ///< name of the created shm object
+
+    /// @brief Constructor from a shared memory mapping.
+    /// @param mem Shared memory.
+    /// @param size Size of the shared memory.
+    /// @param init True if the header is initialized.
+    ShmRing(void *mem, size_t size, bool init) : mem_(mem), size_(size) {
+        header_ = static_cast<ShmRingHeader *>(mem);
+        data_ = static_cast<std::byte *>(mem) + sizeof(ShmRingHeader);
+        if (init) {
+            size_t capacity = size - sizeof(ShmRingHeader);
+            if (!std::has_single_bit(capacity) || capacity < 64) {
+                munmap(mem, size);
+                throw std::invalid_argument(
+                    "error: the capacity should be a power of 2.");
+            }
+            new (header_) ShmRingHeader();
+            header_->capacity = capacity;
+            header_->head.store(0);
+            header_->tail.store(0);
+        } else if (header_->magic != shm_ring_magic) {
+            munmap(mem, size);
+            throw std::invalid_argument("error: invalid ring.");
+        }
+        mask_ = header_->capacity - 1;
+    }
+
+    /// @brief Map a shared memory object.
+    static void *map(int fd, size_t size) {
+        void *mem =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "error: cannot map the ring.");
+        }
+        return mem;
+    }
+
+    /// @brief Size of a record (header and payload, aligned on 8 bytes).
+    static size_t recordSize_(size_t nbBytes) {
+        return (sizeof(ShmRecordHeader) + nbBytes + 7) & ~size_t(7);
+    }
+
+    /// @brief Header of the record at pos.
+    ShmRecordHeader *recordHeader(std::uint64_t pos) const {
+        return reinterpret_cast<ShmRecordHeader *>(data_ + (pos & mask_));
+    }
+};
+
+/// @brief Single producer single consumer shared memory ring.
+using SpscRing = ShmRing<false>;
+
+/// @brief Multiple producers single consumer shared memory ring.
+using MpscRing = ShmRing<true>;
+
+} // end namespace serializer::io
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef SERIALIZER_IO_UNIX_SOCKET_HPP
+#define SERIALIZER_IO_UNIX_SOCKET_HPP
+#include "../exceptions/corrupt_frame.hpp"
+#include "../frame.hpp"
+#include "../tools/bytes.hpp"
+#include "../tools/bytes_pool.hpp"
+#include "../tools/frame.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                             unix domain socket                             */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Stream socket of the AF_UNIX domain (local processes).
+class UnixSocket {
+  public:
+    using bytes_type = tools::Bytes<std::byte>;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor from a socket file descriptor (closed by the
+    ///        socket).
+    explicit UnixSocket(int fd = -1) : fd_(fd) {}
+
+    UnixSocket(UnixSocket const &) = delete;
+    UnixSocket &operator=(UnixSocket const &) = delete;
+    UnixSocket(UnixSocket &&other) noexcept
+        : fd_(std::exchange(other.fd_, -1)) {}
+    UnixSocket &operator=(UnixSocket &&other) noexcept {
+        std::swap(fd_, other.fd_);
+        return *this;
+    }
+
+    /// @brief Destructor (close the socket).
+    ~UnixSocket() { close(); }
+
+    /// @brief Create a pair of connected sockets (shared with the processes
+    ///        created by fork).
+    /// @throw std::system_error when the sockets cannot be created.
+    static std::pair<UnixSocket, UnixSocket> pair() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot create the sockets.");
+        }
+        return {UnixSocket(fds[0]), UnixSocket(fds[1])};
+    }
+
+    /// @brief Connect to a socket bound to path (see UnixListener).
+    /// @throw std::system_error when the connection fails.
+    static UnixSocket connect(std::string const &path) {
+        UnixSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+        sockaddr_un addr = address(path);
+
+        if (socket.fd_ < 0 ||
+            ::connect(socket.fd_, reinterpret_cast<sockaddr *>(&addr),
+                      sizeof(addr)) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot connect to " + path + ".");
+        }
+        return socket;
+    }
+
+    /// @brief Address of a socket file.
+    static sockaddr_un address(std::string const &path) {
+        sockaddr_un addr = {};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::length_error("error: socket path too long.");
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief File descriptor.
+    int fd() const { return fd_; }
+
+    /// @brief Close the socket (the peer reads the end of the data when all
+    ///        the processes have closed it).
+    void close() {
+        if (fd_ >= 0) {
+            ::close(std::exchange(fd_, -1));
+        }
+    }
+
+    /// @brief Signal the end of the data to the peer (reads return 0).
+    void shutdownWrite() { ::shutdown(fd_, SHUT_WR); }
+
+    /* send *******************************************************************/
+
+    /// @brief Send a list of segments with sendmsg (scatter-gather, the
+    ///        segments are not copied into one buffer).
+    /// @param segments Buffers of bytes.
+    /// @throw std::system_error when the send fails.
+    void send(std::vector<bytes_type> const &segments) {
+        std::vector<iovec> iov;
+        iov.reserve(segments.size());
+        for (auto const &segment : segments) {
+            if (segment.size() > 0) {
+                iov.push_back({const_cast<std::byte *>(segment.data()),
+                               segment.size()});
+            }
+        }
+        send(iov.data(), iov.size());
+    }
+
+    /// @brief Send all the bytes of an iovec list (partial sends are
+    ///        resumed).
+    void send(iovec *iov, size_t nbIov) {
+        while (nbIov > 0) {
+            msghdr msg = {};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = std::min(nbIov, size_t(IOV_MAX));
+            ssize_t count = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+            if (count < 0) [[unlikely]] {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot send to the socket.");
+            }
+            size_t sent = size_t(count);
+            while (nbIov > 0 && sent >= iov->iov_len) {
+                sent -= iov->iov_len;
+                ++iov;
+                --nbIov;
+            }
+            if (nbIov > 0) {
+                iov->iov_base = static_cast<std::byte *>(iov->iov_base) + sent;
+                iov->iov_len -= sent;
+            }
+        }
+    }
+
+    /* receive ****************************************************************/
+
+    /// @brief Read at most nbBytes (blocks until some data is available).
+    /// @return Number of bytes read (0 at the end of the data).
+    /// @throw std::system_error when the read fails.
+    size_t read(std::byte *bytes, size_t nbBytes) {
+        while (true) {
+            ssize_t count = ::read(fd_, bytes, nbBytes);
+            if (count >= 0) [[likely]] {
+                return size_t(count);
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot read the socket.");
+            }
+        }
+    }
+
+  private:
+    int fd_ = -1; ///< socket
+};
+
+/// @brief Socket bound to a path that accepts connections.
+class UnixListener {
+  public:
+    /// @brief Bind a socket to path and listen (an existing file is
+    ///        replaced).
+    /// @throw std::system_error when the socket cannot be bound.
+    explicit UnixListener(std::string path, int backlog = 16)
+        : socket_(::socket(AF_UNIX, SOCK_STREAM, 0)), path_(std::move(path)) {
+        sockaddr_un addr = UnixSocket::address(path_);
+
+        ::unlink(path_.c_str());
+        if (socket_.fd() < 0 ||
+            ::bind(socket_.fd(), reinterpret_cast<sockaddr *>(&addr),
+                   sizeof(addr)) < 0 ||
+            ::listen(socket_.fd(), backlog) < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot listen on " + path_ + ".");
+        }
+    }
+
+    UnixListener(UnixListener const &) = delete;
+    UnixListener &operator=(UnixListener const &) = delete;
+
+    /// @brief Destructor (remove the socket file).
+    ~UnixListener() { ::unlink(path_.c_str()); }
+
+    /// @brief Wait for a connection.
+    /// @throw std::system_error when accept fails.
+    UnixSocket accept() {
+        int fd = ::accept(socket_.fd(), nullptr, nullptr);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: cannot accept a connection.");
+        }
+        return UnixSocket(fd);
+    }
+
+  private:
+    UnixSocket socket_; ///< listening socket
+    std::string path_;  ///< path of the socket file
+};
+
+/* frames *********************************************************************/
+
+/// @brief Send serialized objects in frames (see serializeFrame) over a
+///        socket. Each object is serialized in its own pooled buffer, and the
+///        buffers of a batch are sent with one sendmsg (scatter-gather).
+class FrameSender {
+  public:
+    using bytes_type = tools::Bytes<std::byte>;
+
+    /// @brief Constructor.
+    /// @param socket Socket (it should outlive the sender).
+    /// @param batchSize Number of bytes that triggers a send.
+    explicit FrameSender(UnixSocket &socket, size_t batchSize = 64 << 10)
+        : socket_(socket), batchSize_(batchSize) {}
+
+    FrameSender(FrameSender const &) = delete;
+    FrameSender &operator=(FrameSender const &) = delete;
+
+    /// @brief Destructor (the remaining frames are sent, the errors are
+    ///        ignored, call flush to handle them).
+    ~FrameSender() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    /// @brief Serialize obj in a frame that is sent with the batch.
+    /// @param obj Object to send (should have a serialize method).
+    /// @param type Type id stored in the frame.
+    /// @param flags Flags of the frame.
+    void post(auto const &obj, std::uint32_t type = 0,
+              std::uint16_t flags = tools::frame_checksum) {
+        bytes_type buffer = pool_.acquire();
+        serializeFrame(buffer, 0, type, obj, flags);
+        post(std::move(buffer));
+    }
+
+    /// @brief Add a buffer that contains complete frames to the batch.
+    /// @param buffer Frames (returned to the pool when sent).
+    void post(bytes_type &&buffer) {
+        pending_ += buffer.size();
+        segments_.push_back(std::move(buffer));
+        if (pending_ >= batchSize_) {
+            flush();
+        }
+    }
+
+    /// @brief Send the frames of the batch.
+    /// @throw std::system_error when the send fails.
+    void flush() {
+        if (segments_.empty()) {
+            return;
+        }
+        socket_.send(segments_);
+        for (auto &segment : segments_) {
+            pool_.release(std::move(segment));
+        }
+        segments_.clear();
+        pending_ = 0;
+    }
+
+  private:
+    UnixSocket &socket_;              ///< destination
+    size_t batchSize_ = 0;            ///< size that triggers a send
+    size_t pending_ = 0;              ///< size of the batch
+    std::vector<bytes_type> segments_; ///< batch
+    tools::BytesPool<std::byte> pool_; ///< buffers
+};
+
+/// @brief Receive the frames sent by a FrameSender. The data is read by
+///        large blocks into pooled buffers, and split in frames.
+class FrameReceiver {
+  public:
+    using bytes_type = tools::Bytes<std::byte>;
+
+    /// @brief Constructor.
+    /// @param socket Socket (it should outlive the receiver).
+    /// @param bufferSize Size of the reads.
+    explicit FrameReceiver(UnixSocket &socket, size_t bufferSize = 1 << 20)
+        : socket_(socket), bufferSize_(bufferSize),
+          buffer_(pool_.acquire(bufferSize)) {}
+
+    /// @brief Read the available data and call fun(mem, frame) for each
+    ///        complete frame (mem is only valid during the call).
+    /// @param fun Function called for each frame.
+    /// @return False at the end of the data.
+    /// @throw exceptions::CorruptFrameError when a frame is invalid or when
+    ///        the data ends inside a frame.
+    bool receive(auto &&fun) {
+        if (buffer_.capacity() - buffer_.size() < bufferSize_ / 2) {
+            buffer_.upsize(buffer_.size() + bufferSize_);
+        }
+        size_t count = socket_.read(buffer_.data() + buffer_.size(),
+                                    buffer_.capacity() - buffer_.size());
+        if (count == 0) {
+            if (buffer_.size() > 0) {
+                throw exceptions::CorruptFrameError(0, "truncated frame");
+            }
+            return false;
+        }
+        buffer_.resize(buffer_.size() + count);
+        size_t pos = 0;
+        while (true) {
+            size_t end = frameEnd(pos);
+            if (end == 0) {
+                break;
+            }
+            Frame frame = readFrame(buffer_, pos);
+            fun(buffer_, frame);
+            pos = end;
+        }
+        if (pos == 0) {
+            return true;
+        }
+        // the partial frame is moved to a new buffer
+        bytes_type next =
+            pool_.acquire(std::max(bufferSize_, frameEnd(pos, true) - pos));
+        next.append(0, buffer_.data() + pos, buffer_.size() - pos);
+        pool_.release(std::exchange(buffer_, std::move(next)));
+        return true;
+    }
+
+  private:
+    UnixSocket &socket_;               ///< source
+    size_t bufferSize_ = 0;            ///< size of the reads
+    tools::BytesPool<std::byte> pool_; ///< buffers
+    bytes_type buffer_;                ///< received data
+
+    /// @brief Position of the end of the frame at pos.
+    /// @param pos Position of the frame in the buffer.
+    /// @param partial Return the end of partial frames.
+    /// @return End of the frame, or 0 when the frame is not complete.
+    size_t frameEnd(size_t pos, bool partial = false) const {
+        tools::FrameHeader header;
+
+        if (buffer_.size() - pos < sizeof(header)) {
+            return partial ? pos + sizeof(header) : 0;
+        }
+        std::memcpy(&header, buffer_.data() + pos, sizeof(header));
+        if (header.magic != tools::frame_magic ||
+            header.headerChecksum != frameHeaderChecksum(header)) {
+            throw exceptions::CorruptFrameError(pos, "invalid header");
+        }
+        size_t end = pos + sizeof(header) + size_t(header.length);
+        return partial || end <= buffer_.size() ? end : 0;
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
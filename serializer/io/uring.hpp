@@ -0,0 +1,175 @@
+#ifndef SERIALIZER_IO_URING_HPP
+#define SERIALIZER_IO_URING_HPP
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+/******************************************************************************/
+/*                                  io_uring                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer io backends
+namespace serializer::io {
+
+/// @brief Minimal io_uring instance (submission and completion queues) that
+///        uses the system calls directly. The instance should be used by a
+///        single thread.
+class Uring {
+  public:
+    /* constructor & destructor ***********************************************/
+
+    /// @brief Create the rings.
+    /// @param entries Number of entries of the submission queue.
+    /// @throw std::system_error when io_uring is not available.
+    explicit Uring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        fd_ = int(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "error: io_uring_setup failed.");
+        }
+        sqRingSize_ =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = map(sqRingSize_, IORING_OFF_SQ_RING);
+        cqRing_ = (params.features & IORING_FEAT_SINGLE_MMAP)
+                      ? sqRing_
+                      : map(cqRingSize_, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(map(sqesSize_, IORING_OFF_SQES));
+
+        auto sq = static_cast<char *>(sqRing_);
+        auto cq = static_cast<char *>(cqRing_);
+        sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        entries_ = params.sq_entries;
+        tail_ = *sqTail_;
+    }
+
+    Uring(Uring const &) = delete;
+    Uring &operator=(Uring const &) = delete;
+
+    /// @brief Destructor (unmap the rings and close the instance).
+    ~Uring() { release(); }
+
+    /* submission *************************************************************/
+
+    /// @brief Number of entries of the submission queue.
+    unsigned entries() const { return entries_; }
+
+    /// @brief Get a free submission entry (zeroed).
+    /// @return Pointer to the entry, or nullptr when the queue is full.
+    io_uring_sqe *sqe() {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (tail_ - head >= entries_) {
+            return nullptr;
+        }
+        unsigned idx = tail_ & sqMask_;
+        sqArray_[idx] = idx;
+        ++tail_;
+        std::memset(&sqes_[idx], 0, sizeof(io_uring_sqe));
+        return &sqes_[idx];
+    }
+
+    /// @brief Submit the prepared entries.
+    /// @param waitNr Number of completions to wait for.
+    /// @throw std::system_error when io_uring_enter fails.
+    void submit(unsigned waitNr = 0) {
+        unsigned toSubmit = tail_ - *sqTail_;
+        __atomic_store_n(sqTail_, tail_, __ATOMIC_RELEASE);
+        while (syscall(__NR_io_uring_enter, fd_, toSubmit, waitNr,
+                       waitNr > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr,
+                       0) < 0) {
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: io_uring_enter failed.");
+            }
+            toSubmit = 0;
+        }
+    }
+
+    /* completion *************************************************************/
+
+    /// @brief Pop a completion entry if one is available.
+    /// @param cqe Completion entry.
+    /// @return True if an entry has been popped.
+    bool pop(io_uring_cqe &cqe) {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        cqe = cqes_[head & cqMask_];
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+  private:
+    int fd_ = -1;                  ///< io_uring file descriptor
+    void *sqRing_ = nullptr;       ///< submission ring
+    void *cqRing_ = nullptr;       ///< completion ring
+    io_uring_sqe *sqes_ = nullptr; ///< submission entries
+    size_t sqRingSize_ = 0;        ///< size of the submission ring
+    size_t cqRingSize_ = 0;        ///< size of the completion ring
+    size_t sqesSize_ = 0;          ///< size of the submission entries
+    unsigned *sqHead_ = nullptr;   ///< submission head (kernel)
+    unsigned *sqTail_ = nullptr;   ///< submission tail (shared)
+    unsigned *sqArray_ = nullptr;  ///< submission indices
+    unsigned sqMask_ = 0;          ///< submission ring mask
+    unsigned *cqHead_ = nullptr;   ///< completion head (shared)
+    unsigned *cqTail_ = nullptr;   ///< completion tail (kernel)
+    io_uring_cqe *cqes_ = nullptr; ///< completion entries
+    unsigned cqMask_ = 0;          ///< completion ring mask
+    unsigned entries_ = 0;         ///< number of submission entries
+    unsigned tail_ = 0;            ///< local submission tail
+
+    /// @brief Unmap the regions that are mapped and close the instance.
+    void release() {
+        if (sqes_ != nullptr) {
+            munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+            munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_ != nullptr) {
+            munmap(sqRing_, sqRingSize_);
+        }
+        close(fd_);
+    }
+
+    /// @brief Map a region of the io_uring instance.
+    /// @throw std::system_error when mmap fails (the regions already mapped
+    ///        are released, the destructor is not called).
+    void *map(size_t size, off_t offset) {
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd_, offset);
+        if (ptr == MAP_FAILED) {
+            int error = errno;
+            release();
+            throw std::system_error(error, std::generic_category(),
+                                    "error: cannot map the io_uring rings.");
+        }
+        return ptr;
+    }
+};
+
+} // end namespace serializer::io
+
+#endif
@@ -75,6 +75,28 @@ concept Clearable = requires(mtf::clean_t<T> obj) { obj.clear(); };
 template <typename T>
 concept Resizeable = requires(mtf::clean_t<T> obj) { obj.resize(1); };
 
+/// @brief Memory buffers that implement append (bytes are appended at a given
+///        position).
+template <typename T>
+concept Appendable = requires(mtf::clean_t<T> mem) {
+    mem.append(size_t(0), nullptr, size_t(0));
+};
+
+/// @brief Memory buffers that can only be appended to (no random access).
+///        The size of the data can be computed before writing it using
+///        measure.
+template <typename T>
+concept Stream =
+    Appendable<T> && requires(mtf::clean_t<T> mem) { mem.measure([] {}); };
+
+/// @brief Memory buffers that are read through a window (no random access,
+///        the positions only move forward).
+template <typename T>
+concept Readable = requires(mtf::clean_t<T> mem, std::byte *bytes) {
+    mem.read(size_t(0), bytes, size_t(0));
+    mem.peek(size_t(0), bytes, size_t(0));
+};
+
 /// @brief Contiguous resizeable containers
 template <typename T>
 concept ContiguousResizeable =
@@ -143,6 +165,12 @@ template <typename Container, typename T>
 concept PushBackable =
     requires(Container obj) { obj.push_back(std::declval<T>()); };
 
+/// @brief Used to detect whether a container supports insert with a hint.
+template <typename Container, typename T>
+concept HintInsertable = requires(Container obj) {
+    obj.insert(obj.end(), std::declval<T>());
+};
+
 }; // namespace serializer::concepts
 
 /// @brief Serializer function type. It should be a concepts but compilers
@@ -0,0 +1,131 @@
+#ifndef SERIALIZER_FIXED_SIZE_H
+#define SERIALIZER_FIXED_SIZE_H
+#include "../serializer/serialize.hpp"
+#include "concepts.hpp"
+#include "members.hpp"
+#include "serializer_meta.hpp"
+#include "type_check.hpp"
+#include "type_transform.hpp"
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @brief serializer meta-functions namespace
+namespace serializer::mtf {
+
+/// @brief Value of fixed_serialized_size for the types that do not always
+///        serialize to the same number of bytes.
+inline constexpr size_t dynamic_size = std::numeric_limits<size_t>::max();
+
+template <typename T, typename Ser> constexpr size_t fixedSize();
+
+/// @brief Sum the fixed serialized sizes of the elements of a tuple type.
+/// @tparam Tuple Tuple type.
+/// @tparam Ser Serializer type.
+/// @tparam Idx Indicies of the tuple elements.
+/// @return Sum of the sizes or dynamic_size if one element is dynamic.
+template <typename Tuple, typename Ser, size_t... Idx>
+constexpr size_t fixedSizeTuple_(std::index_sequence<Idx...>) {
+    constexpr size_t sizes[] = {
+        0, fixedSize<std::tuple_element_t<Idx, Tuple>, Ser>()...};
+    size_t total = 0;
+
+    for (size_t size : sizes) {
+        if (size == dynamic_size) {
+            return dynamic_size;
+        }
+        total += size;
+    }
+    return total;
+}
+
+/// @brief Sum the fixed serialized sizes of the elements of a tuple type.
+/// @tparam Tuple Tuple type.
+/// @tparam Ser Serializer type.
+template <typename Tuple, typename Ser> constexpr size_t fixedSizeTuple() {
+    return fixedSizeTuple_<Tuple, Ser>(
+        std::make_index_sequence<std::tuple_size_v<Tuple>>());
+}
+
+/// @brief Compute the number of bytes used to serialize T with the serializer
+///        Ser, when this number does not depend on the value.
+///        Note: the cases follow the overloads of the Serializer.
+/// @tparam T Serialized type.
+/// @tparam Ser Serializer type.
+/// @return Number of bytes, or dynamic_size.
+template <typename T, typename Ser> constexpr size_t fixedSize() {
+    using Type = clean_t<T>;
+    using MemT = typename Ser::mem_type;
+
+    if constexpr (std::is_base_of_v<Serialize<Type>, Ser>) {
+        // custom serialize function
+        return dynamic_size;
+    } else if constexpr (is_deserialization_function_v<Type>) {
+        return 0;
+    } else if constexpr (requires(Type fun, Ser ser) {
+                             fun(tools::Context<tools::Phases::Serialization,
+                                                Ser>(ser));
+                         }) {
+        // serialization function (SER_FUN), it can write anything
+        return dynamic_size;
+    } else if constexpr (concepts::Serializable<Type, MemT>) {
+        if constexpr (!std::is_polymorphic_v<Type> &&
+                      has_members_v<Type, MemT>) {
+            constexpr size_t size =
+                fixedSizeTuple<members_t<Type, MemT>, Ser>();
+            if constexpr (has_table_v<Type, MemT>) {
+                return size == dynamic_size
+                           ? dynamic_size
+                           : size + table_size_v<Type, MemT> * sizeof(size_t);
+            } else {
+                return size;
+            }
+        } else {
+            return dynamic_size;
+        }
+    } else if constexpr (concepts::Trivial<Type> || concepts::Enum<Type>) {
+        return sizeof(Type);
+    } else if constexpr (concepts::StaticArray<Type>) {
+        constexpr size_t size = fixedSize<std::remove_extent_t<Type>, Ser>();
+        return size == dynamic_size ? dynamic_size
+                                    : size * std::extent_v<Type>;
+    } else if constexpr (concepts::Array<Type>) {
+        using size_type = decltype(std::declval<Type>().size());
+        constexpr size_t size = fixedSize<typename Type::value_type, Ser>();
+        return size == dynamic_size
+                   ? dynamic_size
+                   : sizeof(size_type) + size * std::tuple_size_v<Type>;
+    } else if constexpr (concepts::TupleLike<Type>) {
+        return fixedSizeTuple<Type, Ser>();
+    } else {
+        return dynamic_size;
+    }
+}
+
+/// @brief Number of bytes used to serialize T with the serializer Ser. The
+///        value is dynamic_size when it depends on the serialized value
+///        (strings, containers, pointers, custom functions, ...).
+/// @tparam T Serialized type.
+/// @tparam Ser Serializer type.
+template <typename T, typename Ser>
+struct fixed_serialized_size
+    : std::integral_constant<size_t, fixedSize<T, Ser>()> {};
+
+/// @brief Shorthand for fixed_serialized_size.
+template <typename T, typename Ser>
+constexpr size_t fixed_serialized_size_v =
+    fixed_serialized_size<T, Ser>::value;
+
+} // end namespace serializer::mtf
+
+/// @brief namespace serializer concepts
+namespace serializer::concepts {
+
+/// @brief Types that always serialize to the same number of bytes.
+template <typename T, typename Ser>
+concept FixedSize = mtf::fixed_serialized_size_v<T, Ser> != mtf::dynamic_size;
+
+} // end namespace serializer::concepts
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef SERIALIZER_MEMBERS_H
+#define SERIALIZER_MEMBERS_H
+#include "concepts.hpp"
+#include "type_check.hpp"
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @file This file contains the meta-functions used to inspect the members
+///       described by the SERIALIZE macros.
+
+/// @brief serializer meta-functions namespace
+namespace serializer::mtf {
+
+/// @brief Type of the tuple returned by the `serializerMembers` function
+///        generated by the SERIALIZE macros (the id when required followed by
+///        the members).
+template <typename T, typename MemT>
+using members_t = clean_t<decltype(std::declval<clean_t<T> &>()
+                                       .serializerMembers(
+                                           std::declval<clean_t<MemT> &>()))>;
+
+/// @brief True if the members of T can be inspected (SERIALIZE macros).
+template <typename T, typename MemT>
+constexpr bool has_members_v = requires { typename members_t<T, MemT>; };
+
+/// @brief Type returned by the `serializerTable` function generated by the
+///        SERIALIZE_TABLE macros (integral constant that holds the number of
+///        entries in the offset table).
+template <typename T, typename MemT>
+using table_layout_t =
+    clean_t<decltype(std::declval<clean_t<T> &>().serializerTable(
+        std::declval<clean_t<MemT> &>()))>;
+
+/// @brief True if T is serialized with an offset table (SERIALIZE_TABLE).
+template <typename T, typename MemT>
+constexpr bool has_table_v = requires { typename table_layout_t<T, MemT>; };
+
+/// @brief Number of entries in the offset table of T.
+template <typename T, typename MemT>
+constexpr size_t table_size_v = table_layout_t<T, MemT>::value;
+
+/// @brief True if T is serialized as a block of bytes (SERIALIZE_STRUCT).
+template <typename T, typename MemT>
+constexpr bool is_raw_struct_v = [] {
+    if constexpr (has_members_v<T, MemT>) {
+        return std::is_same_v<members_t<T, MemT>,
+                              std::tuple<std::byte (&)[sizeof(clean_t<T>)]>>;
+    } else {
+        return false;
+    }
+}();
+
+/// @brief True if T is stored in the buffer as a copy of its object
+///        representation (SERIALIZE_STRUCT or trivial non serializable type).
+template <typename T, typename MemT>
+constexpr bool is_raw_v =
+    is_raw_struct_v<T, MemT> ||
+    (concepts::Trivial<T> && !concepts::Serializable<T, MemT>);
+
+/// @brief Serializer used by the functions generated by the SERIALIZE macros
+///        of T for a memory buffer of type MemT.
+template <typename T, typename MemT>
+using serializer_type_t =
+    typename clean_t<decltype(clean_t<T>::serializerType(
+        std::declval<clean_t<MemT> &>()))>::type;
+
+/// @brief True if the objects of type T (or the objects pointed by T) can be
+///        serialized in a memory buffer of type MemT (false when the
+///        SERIALIZE_CUSTOM macro of T uses a serializer which memory type is
+///        fixed, for instance Serializer<Bytes>).
+template <typename T, typename MemT>
+constexpr bool accepts_memory_v = [] {
+    if constexpr (concepts::ConcretePtr<T>) {
+        return accepts_memory_v<
+            typename std::pointer_traits<clean_t<T>>::element_type, MemT>;
+    } else if constexpr (requires { typename serializer_type_t<T, MemT>; }) {
+        return std::is_constructible_v<serializer_type_t<T, MemT>,
+                                       clean_t<MemT> &, size_t>;
+    } else {
+        return true;
+    }
+}();
+
+} // end namespace serializer::mtf
+
+#endif
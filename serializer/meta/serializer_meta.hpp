@@ -1,6 +1,10 @@
 #ifndef SERIALIZER_SERIALIZER_META_H
 #define SERIALIZER_SERIALIZER_META_H
+#include "../tools/context.hpp"
 #include "../tools/dynamic_array.hpp"
+#include "../tools/indexed.hpp"
+#include "../tools/parallel.hpp"
+#include "../tools/super.hpp"
 #include "concepts.hpp"
 #include "type_check.hpp"
 #include "type_transform.hpp"
@@ -24,6 +28,58 @@ struct is_dynamic_array<tools::DynamicArray<T, Sizes...>> : std::true_type {};
 template <typename T>
 constexpr bool is_dynamic_array_v = is_dynamic_array<clean_t<T>>::value;
 
+/// @brief True if T is an Indexed container wrapper, false otherwise
+template <typename T> struct is_indexed : std::false_type {};
+
+template <typename C, size_t Threshold>
+struct is_indexed<tools::Indexed<C, Threshold>> : std::true_type {};
+
+/// @brief True if T is an Indexed container wrapper, false otherwise
+template <typename T>
+constexpr bool is_indexed_v = is_indexed<clean_t<T>>::value;
+
+/// @brief True if T is a Parallel container wrapper, false otherwise
+template <typename T> struct is_parallel : std::false_type {};
+
+template <typename C>
+struct is_parallel<tools::Parallel<C>> : std::true_type {};
+
+/// @brief True if T is a Parallel container wrapper, false otherwise
+template <typename T>
+constexpr bool is_parallel_v = is_parallel<clean_t<T>>::value;
+
+/// @brief True if T is a Chunked container wrapper, false otherwise
+template <typename T> struct is_chunked : std::false_type {};
+
+template <typename C> struct is_chunked<tools::Chunked<C>> : std::true_type {};
+
+/// @brief True if T is a Chunked container wrapper, false otherwise
+template <typename T>
+constexpr bool is_chunked_v = is_chunked<clean_t<T>>::value;
+
+/// @brief True if T is a Super wrapper, false otherwise
+template <typename T> struct is_super : std::false_type {};
+
+template <typename T> struct is_super<tools::Super<T>> : std::true_type {};
+
+/// @brief True if T is a Super wrapper, false otherwise
+template <typename T> constexpr bool is_super_v = is_super<clean_t<T>>::value;
+
+/// @brief True if T is a function that is only executed during the
+///        deserialization (SER_DFUN), false otherwise
+template <typename T>
+struct is_deserialization_function : std::false_type {};
+
+template <typename F>
+struct is_deserialization_function<tools::DeserializationFunction<F>>
+    : std::true_type {};
+
+/// @brief True if T is a function that is only executed during the
+///        deserialization (SER_DFUN), false otherwise
+template <typename T>
+constexpr bool is_deserialization_function_v =
+    is_deserialization_function<clean_t<T>>::value;
+
 } // end namespace mtf
 
 /// @brief namespace concepts
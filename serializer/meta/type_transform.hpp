@@ -4,6 +4,7 @@
 #include <array>
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 
 /// @brief serializer meta-functions namespace
 namespace serializer::mtf {
@@ -88,6 +89,27 @@ struct base<std::unique_ptr<T>> {
 template <typename T>
 using base_t = typename base<mtf::clean_t<T>>::type;
 
+/// @brief Type used to store an argument in a tuple of members: references
+///        are kept for lvalues and temporaries are stored by value.
+template <typename T>
+using member_t = std::conditional_t<std::is_lvalue_reference_v<T>, T,
+                                    std::remove_cvref_t<T>>;
+
+/// @brief Type of the bytes of a memory buffer (MemT::byte_type, or the type
+///        of its elements when byte_type is not defined).
+template <typename MemT> struct byte_type {
+    using type = std::remove_cvref_t<decltype(std::declval<MemT &>()[0])>;
+};
+
+template <typename MemT>
+    requires requires { typename clean_t<MemT>::byte_type; }
+struct byte_type<MemT> {
+    using type = typename clean_t<MemT>::byte_type;
+};
+
+/// @brief Shorthand for byte_type.
+template <typename MemT> using byte_type_t = typename byte_type<MemT>::type;
+
 } // end namespace serializer::mtf
 
 #endif
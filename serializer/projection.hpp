@@ -0,0 +1,142 @@
+#ifndef SERIALIZER_PROJECTION_H
+#define SERIALIZER_PROJECTION_H
+#include "meta/members.hpp"
+#include "serialize.hpp"
+#include "skip.hpp"
+#include "tools/tools.hpp"
+#include "view.hpp"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @brief serializer namespace
+namespace serializer {
+
+/// @brief Create a field that associates the index of a member in the
+///        SERIALIZE list with an accessor (see deserializeProjection).
+/// @tparam Idx Index of the member in the SERIALIZE list (the id is not
+///             counted).
+/// @param accessor Accessor to the attribute (or the attribute itself).
+template <size_t Idx> constexpr inline auto field(auto &&accessor) {
+    return tools::Field<Idx, std::remove_cvref_t<decltype(accessor)>>{
+        accessor};
+}
+
+/// @brief Deserialize the member `Idx` if it is selected by one of the fields
+///        and skip it otherwise.
+/// @tparam Ser Serializer type.
+/// @tparam Members Tuple of the serialized members.
+/// @tparam Idx Index of the member in the tuple of members.
+/// @tparam Offset Number of elements serialized before the members (id).
+/// @param mem Buffer of bytes containing the serialized data.
+/// @param pos Position of the member in the buffer.
+/// @param obj Object to deserialize.
+/// @param fields Selected fields.
+/// @return Position of the next member in the buffer.
+template <typename Ser, typename Members, size_t Idx, size_t Offset>
+constexpr inline size_t projectMember(auto &mem, size_t pos, auto &obj,
+                                      auto const &...fields) {
+    constexpr bool selected =
+        Idx >= Offset &&
+        ((std::remove_cvref_t<decltype(fields)>::index == Idx - Offset) ||
+         ...);
+
+    if constexpr (selected) {
+        Ser serializer(mem, pos);
+        (
+            [&] {
+                if constexpr (std::remove_cvref_t<decltype(fields)>::index ==
+                              Idx - Offset) {
+                    tools::deserializerAccessor(serializer, obj,
+                                                fields.accessor);
+                }
+            }(),
+            ...);
+        return serializer.pos;
+    } else {
+        return skip<Ser, std::tuple_element_t<Idx, Members>>(mem, pos);
+    }
+}
+
+/// @brief Walk the members, deserializing the selected ones and skipping the
+///        others.
+/// @tparam Ser Serializer type.
+/// @tparam Members Tuple of the serialized members.
+/// @tparam Offset Number of elements serialized before the members (id).
+/// @tparam Idx Indicies of the members.
+/// @param mem Buffer of bytes containing the serialized data.
+/// @param pos Position of the object in the buffer.
+/// @param obj Object to deserialize.
+/// @param fields Selected fields.
+/// @return Position of the end of the object in the buffer.
+template <typename Ser, typename Members, size_t Offset, size_t... Idx>
+constexpr inline size_t projectMembers(auto &mem, size_t pos, auto &obj,
+                                       std::index_sequence<Idx...>,
+                                       auto const &...fields) {
+    ((pos = projectMember<Ser, Members, Idx, Offset>(mem, pos, obj,
+                                                      fields...)),
+     ...);
+    return pos;
+}
+
+/// @brief Deserialize only the selected members of an object. The other
+///        members are skipped at the encoding level (see skip), so they are
+///        never materialized. When the object uses the offset table layout,
+///        the selected members are accessed directly.
+///        Note: Ser should be the serializer used by the object (for the id).
+/// @tparam Ser Serializer type.
+/// @param mem Buffer of bytes containing the serialized data.
+/// @param pos Position of the object in the buffer.
+/// @param obj Object to deserialize.
+/// @param fields Selected fields (see field).
+/// @return Position of the end of the object in the buffer.
+template <typename Ser>
+constexpr inline size_t deserializeProjection(auto &mem, size_t pos,
+                                              auto &obj,
+                                              auto const &...fields) {
+    using T = std::remove_cvref_t<decltype(obj)>;
+    using MemT = typename Ser::mem_type;
+    using Members = mtf::members_t<T, MemT>;
+    constexpr size_t offset =
+        tools::has_type_v<T, typename Ser::type_table> ? 1 : 0;
+    static_assert(((std::remove_cvref_t<decltype(fields)>::index <
+                    std::tuple_size_v<Members> - offset) &&
+                   ...),
+                  "error: field index out of range (the index of a field "
+                  "should be lower than the number of serialized members).");
+
+    if constexpr (mtf::has_table_v<T, MemT>) {
+        View<T, std::remove_cvref_t<decltype(mem)>, Ser> view(mem, pos);
+        (
+            [&] {
+                Ser serializer(
+                    mem, view.template position<std::remove_cvref_t<
+                             decltype(fields)>::index>());
+                tools::deserializerAccessor(serializer, obj, fields.accessor);
+            }(),
+            ...);
+        return view.end();
+    } else {
+        return projectMembers<Ser, Members, offset>(
+            mem, pos, obj,
+            std::make_index_sequence<std::tuple_size_v<Members>>(),
+            fields...);
+    }
+}
+
+/// @brief Create a function for deserializing the selected members of the
+///        given object.
+/// @param obj    Object to deserialize.
+/// @param fields Selected fields (see field).
+/// @return Function (size_t(auto bytes, size_t pos = 0)) that deserialize the
+///         selected members.
+template <typename Ser>
+constexpr inline auto bindProjection(auto &obj, auto &&...fields) {
+    return [=, &obj](auto &mem, size_t pos = 0) {
+        return deserializeProjection<Ser>(mem, pos, obj, fields...);
+    };
+}
+
+} // end namespace serializer
+
+#endif
@@ -1,8 +1,16 @@
 #ifndef SERIALIZER_SERIALIZE_H
 #define SERIALIZER_SERIALIZE_H
 #include "meta/concepts.hpp"
+#include "meta/members.hpp"
 #include "serializer/serializer.hpp"
+#include "tools/access.hpp"
 #include "tools/context.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
 
 /// @brief serializer namespace
 namespace serializer {
@@ -73,12 +81,19 @@ inline constexpr size_t deserialize(auto &mem, size_t pos, auto &&...args) {
 ///        present in the type table, the id is not serialized).
 /// @tparam Ser Serializer type.
 /// @tparam T Type serialize (used for the id).
+/// @tparam Stats Record the statistics of T (see tools::StatsPolicy).
 /// @param mem Buffer of bytes that will contain the serialized data.
 /// @param pos Position in mem.
 /// @param args Elements that are serialized.
-template <typename Ser, typename T>
+template <typename Ser, typename T,
+          bool Stats = tools::serializer_stats_t<Ser>::stats_enabled>
 constexpr inline size_t serializeWithId(auto &mem, size_t pos, auto &&...args) {
-    if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+    if constexpr (Stats) {
+        return tools::recordStats<Ser, mtf::base_t<T>>(
+            tools::StatsOperation::Serialization, pos, [&] {
+                return serializeWithId<Ser, T, false>(mem, pos, args...);
+            });
+    } else if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
         return serialize<Ser>(
             mem, pos, tools::getId<T>(typename Ser::type_table()), args...);
     } else {
@@ -90,13 +105,20 @@ constexpr inline size_t serializeWithId(auto &mem, size_t pos, auto &&...args) {
 ///        present in the type table, the id is not serialized).
 /// @tparam Ser Serializer type.
 /// @tparam T Type serialize (used for the id).
+/// @tparam Stats Record the statistics of T (see tools::StatsPolicy).
 /// @param mem Buffer of bytes that contains the serialized data.
 /// @param pos Position in mem.
 /// @param args Elements that are deserialized.
-template <typename Ser, typename T>
+template <typename Ser, typename T,
+          bool Stats = tools::serializer_stats_t<Ser>::stats_enabled>
 constexpr inline size_t deserializeWithId(auto &mem, size_t pos,
                                           auto &&...args) {
-    if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+    if constexpr (Stats) {
+        return tools::recordStats<Ser, mtf::base_t<T>>(
+            tools::StatsOperation::Deserialization, pos, [&] {
+                return deserializeWithId<Ser, T, false>(mem, pos, args...);
+            });
+    } else if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
         return deserialize<Ser>(
             mem, pos, tools::getId<T>(typename Ser::type_table()), args...);
     } else {
@@ -104,6 +126,134 @@ constexpr inline size_t deserializeWithId(auto &mem, size_t pos,
     }
 }
 
+/// @brief Create a tuple that holds the elements serialized by
+///        serializeWithId (the id when required followed by the members).
+///        Members are stored by reference, and temporaries by value. It is used
+///        by the SERIALIZE macros to describe the serialized members of a
+///        class.
+/// @tparam Ser Serializer type.
+/// @tparam T Type serialize (used for the id).
+/// @param args Elements that are serialized.
+/// @return Tuple of members.
+template <typename Ser, typename T>
+constexpr inline auto membersWithId(auto &&...args) {
+    if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+        return std::tuple<typename Ser::id_type,
+                          mtf::member_t<decltype(args)>...>(
+            tools::getId<T>(typename Ser::type_table()),
+            std::forward<decltype(args)>(args)...);
+    } else {
+        return std::tuple<mtf::member_t<decltype(args)>...>(
+            std::forward<decltype(args)>(args)...);
+    }
+}
+
+/******************************************************************************/
+/*                       serialize / deserialize table                        */
+/******************************************************************************/
+
+/// @brief Serialize the members using the offset table layout: the id (if
+///        required) is followed by a table that contains the end position of
+///        each member (relative to the beginning of the table), and then by the
+///        members. The table allows accessing any member without reading the
+///        others (see View).
+/// @tparam Ser Serializer type.
+/// @tparam T Type serialize (used for the id).
+/// @tparam Stats Record the statistics of T (see tools::StatsPolicy).
+/// @param mem Buffer of bytes that will contain the serialized data.
+/// @param pos Position in mem.
+/// @param args Elements that are serialized.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename T,
+          bool Stats = tools::serializer_stats_t<Ser>::stats_enabled>
+constexpr inline size_t serializeTable(auto &mem, size_t pos, auto &&...args) {
+    if constexpr (Stats) {
+        return tools::recordStats<Ser, mtf::base_t<T>>(
+            tools::StatsOperation::Serialization, pos, [&] {
+                return serializeTable<Ser, T, false>(mem, pos, args...);
+            });
+    } else {
+        using mem_t = decltype(mem);
+        using byte_type = mtf::byte_type_t<mem_t>;
+        [[maybe_unused]] bool first_level = pos == 0;
+        std::array<size_t, sizeof...(args)> table = {};
+        size_t tablePos = pos;
+        size_t idx = 0;
+
+        if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+            tablePos = serialize<Ser>(
+                mem, pos, tools::getId<T>(typename Ser::type_table()));
+        }
+        if constexpr (concepts::Stream<mem_t>) {
+            // streams cannot be overwritten, so the members are measured first
+            size_t end = sizeof(table);
+            (
+                [&] {
+                    end += mem.measure(
+                        [&] { serialize<Ser>(mem, mem.size(), args); });
+                    table[idx++] = end;
+                }(),
+                ...);
+        }
+        Ser serializer(mem, tablePos);
+        serializer.append(std::bit_cast<const byte_type *>(table.data()),
+                          sizeof(table));
+        pos = serializer.pos;
+        if constexpr (concepts::Stream<mem_t>) {
+            ((pos = serialize<Ser>(mem, pos, args)), ...);
+        } else {
+            (
+                [&] {
+                    pos = serialize<Ser>(mem, pos, args);
+                    table[idx++] = pos - tablePos;
+                }(),
+                ...);
+            std::memcpy(mem.data() + tablePos, table.data(), sizeof(table));
+        }
+        if constexpr (!mtf::is_serializer_bytes_v<mem_t> &&
+                      concepts::Resizeable<mem_t>) {
+            if (first_level) [[unlikely]] {
+                mem.resize(pos);
+            }
+        }
+        return pos;
+    }
+}
+
+/// @brief Deserialize the members serialized with serializeTable.
+/// @tparam Ser Serializer type.
+/// @tparam T Type serialize (used for the id).
+/// @tparam Stats Record the statistics of T (see tools::StatsPolicy).
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position in mem.
+/// @param args Elements that are deserialized.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename T,
+          bool Stats = tools::serializer_stats_t<Ser>::stats_enabled>
+constexpr inline size_t deserializeTable(auto &mem, size_t pos,
+                                         auto &&...args) {
+    if constexpr (Stats) {
+        return tools::recordStats<Ser, mtf::base_t<T>>(
+            tools::StatsOperation::Deserialization, pos, [&] {
+                return deserializeTable<Ser, T, false>(mem, pos, args...);
+            });
+    } else {
+        if constexpr (tools::has_type_v<T, typename Ser::type_table>) {
+            pos = deserialize<Ser>(mem, pos,
+                                   tools::getId<T>(typename Ser::type_table()));
+        }
+        return deserialize<Ser>(mem, pos + sizeof(size_t) * sizeof...(args),
+                                args...);
+    }
+}
+
+/// @brief Describe the offset table used by serializeTable.
+/// @param args Elements that are serialized.
+/// @return Integral constant that holds the number of entries of the table.
+constexpr inline auto tableLayout(auto &&...args) {
+    return std::integral_constant<size_t, sizeof...(args)>();
+}
+
 /******************************************************************************/
 /*                       serialize / deserialize struct                       */
 /******************************************************************************/
@@ -120,12 +270,13 @@ template <typename T>
 inline constexpr size_t serializeStruct(auto &mem, size_t pos, T const *obj) {
     constexpr size_t nb_bytes = sizeof(*obj);
     Serializer<decltype(mem)> serializer(mem, pos);
-    using byte_type = std::remove_cvref_t<decltype(mem[0])>;
+    using byte_type = mtf::byte_type_t<decltype(mem)>;
     serializer.append(std::bit_cast<const byte_type *>(obj), nb_bytes);
     return serializer.pos;
 }
 
-/// @brief Deserialize obj from mem at pos using a bit_cast.
+/// @brief Deserialize obj from mem at pos using a memcpy (the struct may not
+///        be aligned in the buffer, or may be read from a stream).
 /// @tparam T Object type (this).
 /// @param mem Buffer in which the serialized data is be stored.
 /// @param pos Start position in the buffer for deserializing the data.
@@ -133,8 +284,143 @@ inline constexpr size_t serializeStruct(auto &mem, size_t pos, T const *obj) {
 /// @return Position of the next element in the buffer.
 template <typename T>
 inline constexpr size_t deserializeStruct(auto &mem, size_t pos, T *obj) {
-    *obj = *std::bit_cast<const decltype(obj)>(mem.data() + pos);
-    return pos + sizeof(*obj);
+    Serializer<decltype(mem)> serializer(mem, pos);
+    serializer.read(obj, sizeof(*obj));
+    return serializer.pos;
+}
+
+/// @brief Describe the members of a struct serialized with serializeStruct
+///        (the struct is serialized as a block of bytes).
+/// @tparam T Object type (this).
+/// @param obj Pointer to the object.
+/// @return Tuple that holds a reference to the bytes of the object.
+template <typename T> inline constexpr auto structMembers(T *obj) {
+    using byte_array = std::conditional_t<std::is_const_v<T>, std::byte const,
+                                          std::byte>[sizeof(T)];
+    return std::tuple<byte_array &>(*reinterpret_cast<byte_array *>(obj));
+}
+
+/// @brief Access a raw struct (SERIALIZE_STRUCT or trivial type) serialized
+///        in mem at pos without deserializing it. The returned object points
+///        directly into the buffer when the position is correctly aligned for
+///        T, otherwise it holds a copy. The buffer should outlive the result.
+/// @tparam T Type of the struct.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the struct in mem.
+/// @return Access to the struct (see tools::Access).
+/// @throw std::out_of_range when the struct is not in the buffer.
+template <typename T>
+inline tools::Access<T> access(auto const &mem, size_t pos) {
+    static_assert(mtf::is_raw_v<T, std::remove_cvref_t<decltype(mem)>>,
+                  "error: the type should be serialized as a raw struct.");
+
+    if (pos > mem.size() || mem.size() - pos < sizeof(T)) [[unlikely]] {
+        throw std::out_of_range("error: the struct is outside the buffer.");
+    }
+    auto ptr = mem.data() + pos;
+
+    if (std::bit_cast<std::uintptr_t>(ptr) % alignof(T) == 0) {
+        return tools::Access<T>(std::bit_cast<T const *>(ptr));
+    }
+    std::array<std::byte, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), ptr, sizeof(T));
+    return tools::Access<T>(std::bit_cast<T>(bytes));
+}
+
+/// @brief Access the elements of a contiguous container of raw structs (ex:
+///        std::vector<T>) serialized in mem at pos without deserializing
+///        them. The elements are accessed in place when the position of the
+///        first element is correctly aligned for T, otherwise they are copied.
+///        The buffer should outlive the result.
+/// @tparam T Type of the elements.
+/// @tparam SizeType Type used to serialize the size of the container.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the container in mem.
+/// @return Access to the elements (see tools::AccessSpan).
+/// @throw std::out_of_range when the elements are not in the buffer.
+template <typename T, typename SizeType = size_t>
+inline tools::AccessSpan<T> accessArray(auto const &mem, size_t pos) {
+    static_assert(mtf::is_raw_v<T, std::remove_cvref_t<decltype(mem)>>,
+                  "error: the type should be serialized as a raw struct.");
+
+    if (pos > mem.size() || mem.size() - pos < sizeof(SizeType)) [[unlikely]] {
+        throw std::out_of_range("error: the array is outside the buffer.");
+    }
+    SizeType size;
+    std::memcpy(&size, mem.data() + pos, sizeof(SizeType));
+    pos += sizeof(SizeType);
+    if ((mem.size() - pos) / sizeof(T) < size) [[unlikely]] {
+        throw std::out_of_range("error: the array is outside the buffer.");
+    }
+    auto ptr = mem.data() + pos;
+
+    if (std::bit_cast<std::uintptr_t>(ptr) % alignof(T) == 0) {
+        return tools::AccessSpan<T>(
+            std::span<T const>(std::bit_cast<T const *>(ptr), size));
+    }
+    std::vector<T> copy;
+    std::array<std::byte, sizeof(T)> bytes;
+    copy.reserve(size);
+    for (SizeType i = 0; i < size; ++i) {
+        std::memcpy(bytes.data(), ptr + i * sizeof(T), sizeof(T));
+        copy.push_back(std::bit_cast<T>(bytes));
+    }
+    return tools::AccessSpan<T>(std::move(copy));
+}
+
+/******************************************************************************/
+/*                               element access                               */
+/******************************************************************************/
+
+/// @brief Compute the position of the element `idx` in a serialized container
+///        (or static array) of type C which elements have a fixed serialized
+///        size. The preceding elements are not read.
+/// @tparam Ser Serializer type.
+/// @tparam C Type of the serialized container.
+/// @param mem Buffer of bytes that contains the serialized container.
+/// @param pos Position of the container in mem.
+/// @param idx Index of the element.
+/// @return Position of the element in mem.
+/// @throw std::out_of_range when idx is not a valid index.
+template <typename Ser, typename C>
+inline constexpr size_t elementPos(auto const &mem, size_t pos, size_t idx) {
+    using Type = mtf::clean_t<C>;
+
+    if constexpr (concepts::StaticArray<Type>) {
+        using ValueType = std::remove_extent_t<Type>;
+        static_assert(concepts::FixedSize<ValueType, Ser>,
+                      "error: the elements should have a fixed size.");
+        if (idx >= std::extent_v<Type>) [[unlikely]] {
+            throw std::out_of_range("error: element index out of range.");
+        }
+        return pos + idx * mtf::fixed_serialized_size_v<ValueType, Ser>;
+    } else {
+        using ValueType = mtf::remove_const_t<mtf::iter_value_t<Type>>;
+        using size_type = decltype(std::size(std::declval<Type>()));
+        static_assert(concepts::FixedSize<ValueType, Ser>,
+                      "error: the elements should have a fixed size.");
+        auto size = *std::bit_cast<const size_type *>(mem.data() + pos);
+        if (idx >= size) [[unlikely]] {
+            throw std::out_of_range("error: element index out of range.");
+        }
+        return pos + sizeof(size_type) +
+               idx * mtf::fixed_serialized_size_v<ValueType, Ser>;
+    }
+}
+
+/// @brief Deserialize the element `idx` of a serialized container (or static
+///        array) of type C which elements have a fixed serialized size.
+/// @tparam Ser Serializer type.
+/// @tparam C Type of the serialized container.
+/// @param mem Buffer of bytes that contains the serialized container.
+/// @param pos Position of the container in mem.
+/// @param idx Index of the element.
+/// @param elt Element that is deserialized.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename C>
+inline constexpr size_t deserializeElement(auto &mem, size_t pos, size_t idx,
+                                           auto &&elt) {
+    return deserialize<Ser>(mem, elementPos<Ser, C>(mem, pos, idx), elt);
 }
 
 /******************************************************************************/
@@ -6,9 +6,16 @@
 #include "tools/bytes.hpp"
 #include "tools/context.hpp"
 #include "tools/dynamic_array.hpp"
+#include "tools/stream.hpp"
 #include "serializer/serialize.hpp"
 #include "serializer/serializer.hpp"
+#include "coroutine.hpp"
+#include "frame.hpp"
+#include "dispatch.hpp"
+#include "projection.hpp"
 #include "serialize.hpp"
+#include "skip.hpp"
+#include "view.hpp"
 
 /// Useful alias:
 
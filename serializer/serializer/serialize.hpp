@@ -1,5 +1,6 @@
 #ifndef SERIALIZER_SERIALIZER_SERIALIZE_HPP
 #define SERIALIZER_SERIALIZER_SERIALIZE_HPP
+#include "../tools/stats.hpp"
 
 namespace serializer {
 
@@ -12,6 +13,10 @@ template <typename T> struct Serialize {
     constexpr virtual void deserialize(T &) = 0;
 };
 
+/// @brief The statistics policies given with the additional types do not add
+///        any behavior (see tools::StatsPolicy).
+template <tools::StatsPolicy T> struct Serialize<T> {};
+
 }
 
 #endif // SERIALIZER_SERIALIZER_SERIALIZE_HPP
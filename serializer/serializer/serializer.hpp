@@ -1,10 +1,14 @@
 #ifndef SERIALIZER_SERIALIZER_SERIALIZER_HPP
 #define SERIALIZER_SERIALIZER_SERIALIZER_HPP
 #include "../exceptions/unsupported_type.hpp"
+#include "../meta/fixed_size.hpp"
 #include "../meta/serializer_meta.hpp"
 #include "../meta/type_check.hpp"
 #include "../meta/type_transform.hpp"
 #include "../tools/dynamic_array.hpp"
+#include "../tools/indexed.hpp"
+#include "../tools/parallel.hpp"
+#include "../tools/stream.hpp"
 #include "../tools/tools.hpp"
 #include "../tools/type_table.hpp"
 #include "serialize.hpp"
@@ -12,10 +16,15 @@
 #include <algorithm>
 #include <bit>
 #include <cstring>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 /// @brief namespace serializer
 namespace serializer {
@@ -25,7 +34,8 @@ namespace serializer {
 ///        convert behavior for additional types so the user can add its own
 ///        functions.
 /// @tparam MemT Type of the memory buffer.
-/// @tparam AdditionalTypes External types for which the user can add support.
+/// @tparam AdditionalTypes External types for which the user can add support,
+///         and optionally a statistics policy (see tools::StatsPolicy).
 template <typename MemT, typename TypeTable = tools::TypeTable<>,
           typename... AdditionalTypes>
 struct Serializer : Serialize<AdditionalTypes>... {
@@ -33,10 +43,10 @@ struct Serializer : Serialize<AdditionalTypes>... {
     size_t pos = 0; ///< position in the memory buffer.
 
     using type_table = TypeTable;
+    using stats_type = tools::stats_policy_t<AdditionalTypes...>;
     using id_type = typename TypeTable::id_type;
     using mem_type = MemT; ///< alias to the type of the momory buffer
-    using byte_type =
-        std::remove_cvref_t<decltype(mem[0])>; ///< alias to the byte type
+    using byte_type = mtf::byte_type_t<MemT>; ///< alias to the byte type
 
     /* Constructor ************************************************************/
 
@@ -52,7 +62,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @param nbBytes Size of the buffer.
     inline constexpr void append(const byte_type *bytes, size_t nbBytes) {
         if constexpr (!std::is_const_v<MemT>) {
-            if constexpr (mtf::is_serializer_bytes_v<mtf::clean_t<mem_type>>) {
+            if constexpr (concepts::Appendable<mem_type>) {
                 mem.append(pos, bytes, nbBytes);
                 pos += nbBytes;
             } else {
@@ -77,12 +87,71 @@ struct Serializer : Serialize<AdditionalTypes>... {
         append(std::bit_cast<const byte_type *>(&elt), sizeof(elt));
     }
 
+    /// @brief Overwrite bytes that have already been appended (used to write
+    ///        sizes that are known after serializing the data).
+    /// @param position Position of the bytes in the memory buffer.
+    /// @param bytes Buffer of bytes.
+    /// @param nbBytes Size of the buffer.
+    inline constexpr void write(size_t position, const byte_type *bytes,
+                                size_t nbBytes) {
+        static_assert(!concepts::Stream<mem_type>,
+                      "error: the data of a stream cannot be overwritten.");
+        if constexpr (!std::is_const_v<MemT>) {
+            std::memcpy(mem.data() + position, bytes, nbBytes);
+        }
+    }
+
+    /// @brief Make sure that `nbBytes` can be appended at pos without
+    ///        growing the memory buffer again.
+    /// @param nbBytes Number of bytes that will be appended.
+    inline constexpr void reserve(size_t nbBytes) {
+        if constexpr (!std::is_const_v<MemT>) {
+            if constexpr (mtf::is_serializer_bytes_v<mtf::clean_t<mem_type>>) {
+                mem.upsize(pos + nbBytes);
+            } else if constexpr (concepts::Resizeable<mem_type>) {
+                if (mem.size() < pos + nbBytes) {
+                    mem.resize(pos + nbBytes);
+                }
+            }
+        }
+    }
+
+    /// @brief Compute the number of bytes used to serialize elt without
+    ///        writing anything (streams only, see tools::OutputStream).
+    /// @param elt Element that is measured.
+    /// @return Number of bytes.
+    inline constexpr size_t measure(auto &&elt) {
+        using T = mtf::clean_t<decltype(elt)>;
+
+        if constexpr (concepts::FixedSize<T, Serializer>) {
+            return mtf::fixed_serialized_size_v<T, Serializer>;
+        } else {
+            size_t begin = pos;
+            mem.measure([&] { select_serialize(elt); });
+            return std::exchange(pos, begin) - begin;
+        }
+    }
+
+    /// @brief Copy bytes from the memory buffer at pos (pos is changed).
+    ///        Input streams are read through their window (see
+    ///        tools::InputStream).
+    /// @param bytes Destination buffer.
+    /// @param nbBytes Number of bytes to read.
+    inline constexpr void read(void *bytes, size_t nbBytes) {
+        if constexpr (concepts::Readable<mem_type>) {
+            mem.read(pos, bytes, nbBytes);
+        } else {
+            std::memcpy(bytes, mem.data() + pos, nbBytes);
+        }
+        pos += nbBytes;
+    }
+
     /// @brief Helper function for deserializing the size of containers.
     /// @tparam Type of the size
     /// @return Deserialized size.
     template <typename T> inline constexpr T deserializeSize() {
-        auto size = *std::bit_cast<const T *>(mem.data() + pos);
-        pos += sizeof(T);
+        T size;
+        read(&size, sizeof(T));
         return size;
     }
 
@@ -90,7 +159,12 @@ struct Serializer : Serialize<AdditionalTypes>... {
     /// @param elt Element that is deserialized.
     /// @return id
     inline constexpr id_type readId() {
-        auto id = *std::bit_cast<const id_type *>(mem.data() + pos);
+        id_type id;
+        if constexpr (concepts::Readable<mem_type>) {
+            mem.peek(pos, &id, sizeof(id));
+        } else {
+            std::memcpy(&id, mem.data() + pos, sizeof(id));
+        }
         return id;
     }
 
@@ -165,8 +239,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     template <serializer::concepts::Trivial T>
         requires(!concepts::Deserializable<T, MemT>)
     inline constexpr void deserialize_(T &&elt) {
-        elt = *std::bit_cast<const mtf::clean_t<T> *>(mem.data() + pos);
-        pos += sizeof(T);
+        read(std::addressof(elt), sizeof(elt));
     }
 
     /* pointers ***************************************************************/
@@ -196,7 +269,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     template <serializer::concepts::Pointer T>
         requires(!mtf::contains_v<T, AdditionalTypes...>)
     inline constexpr void deserialize_(T &&elt) {
-        bool ptrValid = char(mem[pos++]) == 'v';
+        bool ptrValid = deserializeSize<char>() == 'v';
 
         if (!ptrValid) {
             elt = nullptr;
@@ -217,6 +290,11 @@ struct Serializer : Serialize<AdditionalTypes>... {
                 } else if constexpr (concepts::Pointer<T>) {
                     elt = new Type();
                 }
+#ifdef SERIALIZER_ALLOC_STATS
+                if (!std::is_constant_evaluated()) {
+                    tools::countCreate<std::remove_cvref_t<decltype(*elt)>>();
+                }
+#endif
             }
         } else if constexpr (tools::has_type_v<T, TypeTable>) {
             if (elt == nullptr) {
@@ -287,8 +365,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
         requires(!concepts::Trivial<T>)
     inline constexpr void deserialize_(T &&elt) {
         using Type = std::underlying_type_t<mtf::clean_t<T>>;
-        elt = (mtf::clean_t<T>)*std::bit_cast<const Type *>(mem.data() + pos);
-        pos += sizeof(Type);
+        elt = (mtf::clean_t<T>)deserializeSize<Type>();
     }
 
     /* strings ****************************************************************/
@@ -310,8 +387,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
         using size_type = typename mtf::clean_t<T>::size_type;
         size_type size = deserializeSize<size_type>();
         str.resize(size);
-        std::memcpy(str.data(), mem.data() + pos, size);
-        pos += size;
+        read(str.data(), size);
     }
 
     /* iterable containers ****************************************************/
@@ -334,6 +410,11 @@ struct Serializer : Serialize<AdditionalTypes>... {
                 std::bit_cast<const byte_type *>(std::to_address(elts.begin())),
                 sizeof(ValueType) * std::size(elts));
         } else {
+            if constexpr (concepts::FixedSize<ValueType, Serializer>) {
+                // the output size is known, so the buffer is grown only once
+                reserve(mtf::fixed_serialized_size_v<ValueType, Serializer> *
+                        size);
+            }
             for (auto &elt : elts) {
                 select_serialize(elt);
             }
@@ -346,10 +427,17 @@ struct Serializer : Serialize<AdditionalTypes>... {
         requires(!concepts::Trivial<T> && !concepts::Deserializable<T, MemT>)
     inline constexpr void deserialize_(T &&elts) {
         using size_type = decltype(std::size(std::declval<T>()));
+        deserializeElements(elts, deserializeSize<size_type>());
+    }
+
+    /// @brief Deserialize the elements of a container.
+    /// @param elts Container that is deserialized.
+    /// @param size Number of elements.
+    template <typename T>
+    inline constexpr void deserializeElements(T &&elts, size_t size) {
         using ValueType =
             mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<T>>>;
         using IterType = decltype(elts.begin());
-        size_type size = deserializeSize<size_type>();
 
         if constexpr (concepts::ContiguousResizeable<T>) {
             elts.resize(size);
@@ -358,10 +446,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
         }
 
         if constexpr (concepts::ContiguousTrivial<T, MemT>) {
-            std::memcpy(
-                std::bit_cast<byte_type *>(std::to_address(elts.begin())),
-                mem.data() + pos, sizeof(ValueType) * size);
-            pos += sizeof(ValueType) * size;
+            read(std::to_address(elts.begin()), sizeof(ValueType) * size);
         } else if constexpr (std::contiguous_iterator<IterType>) {
             for (auto &elt : elts) {
                 select_deserialize(elt);
@@ -381,6 +466,401 @@ struct Serializer : Serialize<AdditionalTypes>... {
         }
     }
 
+    /* indexed containers *****************************************************/
+
+    /// @brief Serialize function for containers wrapped in Indexed. The offset
+    ///        index is appended after the elements when the container is large
+    ///        enough (tools::index_present_flag is set in the number of
+    ///        bytes).
+    /// @param elt Element that is serialized.
+    template <typename T, size_t Threshold>
+    inline constexpr void serialize_(tools::Indexed<T, Threshold> elt) {
+        auto size = std::size(elt.container);
+        size_t nbBytes = 0;
+        size_t flag = size >= Threshold ? tools::index_present_flag : 0;
+
+        append(std::bit_cast<const byte_type *>(&size), sizeof(size));
+        if constexpr (concepts::Stream<MemT>) {
+            // streams cannot be overwritten, so the elements are measured
+            // before being serialized
+            std::vector<tools::index_delta_type> deltas;
+            if (size >= Threshold) {
+                deltas.reserve(size);
+            }
+            for (auto &e : elt.container) {
+                size_t eltSize = measure(e);
+                if (size >= Threshold) {
+                    deltas.push_back(indexDelta(eltSize));
+                }
+                nbBytes += eltSize;
+            }
+            nbBytes |= flag;
+            append(std::bit_cast<const byte_type *>(&nbBytes),
+                   sizeof(nbBytes));
+            for (auto &e : elt.container) {
+                select_serialize(e);
+            }
+            append(std::bit_cast<const byte_type *>(deltas.data()),
+                   deltas.size() * sizeof(tools::index_delta_type));
+        } else {
+            size_t nbBytesPos = pos;
+            append(std::bit_cast<const byte_type *>(&nbBytes),
+                   sizeof(nbBytes));
+            size_t begin = pos;
+
+            if (size >= Threshold) {
+                std::vector<tools::index_delta_type> deltas;
+                deltas.reserve(size);
+                for (auto &e : elt.container) {
+                    size_t eltPos = pos;
+                    select_serialize(e);
+                    deltas.push_back(indexDelta(pos - eltPos));
+                }
+                nbBytes = pos - begin;
+                append(std::bit_cast<const byte_type *>(deltas.data()),
+                       deltas.size() * sizeof(tools::index_delta_type));
+            } else {
+                for (auto &e : elt.container) {
+                    select_serialize(e);
+                }
+                nbBytes = pos - begin;
+            }
+            nbBytes |= flag;
+            write(nbBytesPos, std::bit_cast<const byte_type *>(&nbBytes),
+                  sizeof(nbBytes));
+        }
+    }
+
+    /// @brief Convert the size of an element of an Indexed container to an
+    ///        entry of the index.
+    /// @param nbBytes Size of the element.
+    /// @throw std::length_error when the size does not fit in an entry.
+    inline constexpr tools::index_delta_type indexDelta(size_t nbBytes) {
+        constexpr size_t max_delta =
+            std::numeric_limits<tools::index_delta_type>::max();
+        if (nbBytes > max_delta) [[unlikely]] {
+            throw std::length_error("error: indexed element too large.");
+        }
+        return tools::index_delta_type(nbBytes);
+    }
+
+    /// @brief Deserialize function for containers wrapped in Indexed (the
+    ///        index is not required to deserialize the whole container, it is
+    ///        skipped when the flag is set, whatever the threshold).
+    /// @param elt Element that is deserialized.
+    /// @throw std::out_of_range when the elements do not match their number
+    ///        of bytes.
+    template <typename T, size_t Threshold>
+    inline constexpr void deserialize_(tools::Indexed<T, Threshold> elt) {
+        using size_type = decltype(std::size(elt.container));
+        size_type size = deserializeSize<size_type>();
+        size_t nbBytes = deserializeSize<size_t>();
+        size_t begin = pos;
+
+        deserializeElements(elt.container, size);
+        if (pos - begin != (nbBytes & ~tools::index_present_flag))
+            [[unlikely]] {
+            throw std::out_of_range("error: invalid indexed container.");
+        }
+        if (nbBytes & tools::index_present_flag) {
+            pos += size * sizeof(tools::index_delta_type);
+        }
+    }
+
+    /* parallel containers ****************************************************/
+
+    /// @brief True when the chunks of a container of type C can be
+    ///        serialized concurrently in the memory buffer (the elements
+    ///        should accept the memory types of the chunks, otherwise the
+    ///        container is serialized sequentially).
+    template <typename C>
+    static constexpr bool parallel_serialization =
+        !concepts::Stream<MemT> && !std::is_const_v<MemT> &&
+        !concepts::ContiguousTrivial<C, MemT> &&
+        std::ranges::random_access_range<mtf::clean_t<C>> &&
+        mtf::accepts_memory_v<mtf::iter_value_t<C>, std::span<byte_type>> &&
+        mtf::accepts_memory_v<mtf::iter_value_t<C>, tools::ByteCounter>;
+
+    /// @brief True when the chunks of a container of type C can be
+    ///        deserialized concurrently from the memory buffer (the elements
+    ///        should accept the memory type of the chunks, otherwise the
+    ///        container is deserialized sequentially).
+    template <typename C>
+    static constexpr bool parallel_deserialization =
+        !concepts::Readable<MemT> && !concepts::ContiguousTrivial<C, MemT> &&
+        mtf::accepts_memory_v<mtf::iter_value_t<C>,
+                              std::span<const byte_type>>;
+
+    /// @brief Serialize the elements of a container by chunks on a thread
+    ///        pool. The chunks are measured, the buffer is grown once, then
+    ///        the chunks are serialized concurrently at their final position
+    ///        (see parallel_serialization).
+    /// @param elts Container.
+    /// @param pool Thread pool.
+    /// @param chunkSize Number of elements of the chunks.
+    /// @return Positions of the ends of the chunks relative to the first
+    ///         element.
+    template <typename C>
+    inline std::vector<size_t> serializeChunks(C &elts, tools::ThreadPool &pool,
+                                               size_t chunkSize) {
+        using ValueType = mtf::remove_const_t<mtf::iter_value_t<C>>;
+        using ChunkSerializer =
+            Serializer<std::span<byte_type>, TypeTable, AdditionalTypes...>;
+        using CounterSerializer =
+            Serializer<tools::ByteCounter, TypeTable, AdditionalTypes...>;
+        constexpr size_t value_size =
+            mtf::fixed_serialized_size_v<ValueType, Serializer>;
+        size_t size = size_t(std::size(elts));
+        size_t nbChunks = (size + chunkSize - 1) / chunkSize;
+        auto begin = std::ranges::begin(elts);
+        auto chunkEnd = [&](size_t chunk) {
+            return std::min((chunk + 1) * chunkSize, size);
+        };
+        std::vector<size_t> ends(nbChunks, 0);
+
+        // positions of the chunks (prefix sum of the sizes)
+        if constexpr (value_size != mtf::dynamic_size) {
+            for (size_t chunk = 0; chunk < nbChunks; ++chunk) {
+                ends[chunk] = chunkEnd(chunk) * value_size;
+            }
+        } else {
+            pool.parallelFor(nbChunks, [&](size_t chunk) {
+                tools::ByteCounter counter;
+                CounterSerializer serializer(counter, 0);
+                for (size_t i = chunk * chunkSize; i < chunkEnd(chunk); ++i) {
+                    serializer.select_serialize(begin[i]);
+                }
+                ends[chunk] = serializer.pos;
+            });
+            for (size_t chunk = 1; chunk < nbChunks; ++chunk) {
+                ends[chunk] += ends[chunk - 1];
+            }
+        }
+
+        // the buffer is grown once, then the chunks are serialized at their
+        // position
+        size_t first = pos;
+        size_t end = pos + (nbChunks > 0 ? ends.back() : 0);
+        if constexpr (mtf::is_serializer_bytes_v<mtf::clean_t<MemT>>) {
+            mem.upsize(end);
+        } else if constexpr (concepts::Resizeable<MemT>) {
+            if (mem.size() < end) {
+                mem.resize(end);
+            }
+        } else if (mem.size() < end) {
+            throw std::out_of_range(
+                "error: the serialization array is too small.");
+        }
+        std::span<byte_type> view(mem.data(), end);
+        pool.parallelFor(nbChunks, [&](size_t chunk) {
+            ChunkSerializer serializer(
+                view, first + (chunk > 0 ? ends[chunk - 1] : 0));
+            for (size_t i = chunk * chunkSize; i < chunkEnd(chunk); ++i) {
+                serializer.select_serialize(begin[i]);
+            }
+        });
+        if constexpr (mtf::is_serializer_bytes_v<mtf::clean_t<MemT>>) {
+            mem.resize(end);
+        }
+        pos = end;
+        return ends;
+    }
+
+    /// @brief Serialize function for containers wrapped in Parallel (the data
+    ///        is the same as the one of the container).
+    /// @param elt Element that is serialized.
+    template <typename T> inline void serialize_(tools::Parallel<T> elt) {
+        if constexpr (parallel_serialization<T>) {
+            auto size = std::size(elt.container);
+            if (size_t(size) >= 2 * elt.chunkSize && elt.pool.size() > 1) {
+                append(std::bit_cast<const byte_type *>(&size), sizeof(size));
+                serializeChunks(elt.container, elt.pool, elt.chunkSize);
+                return;
+            }
+        }
+        select_serialize(elt.container);
+    }
+
+    /// @brief Deserialize function for containers wrapped in Parallel (same
+    ///        data as the container).
+    /// @param elt Element that is deserialized.
+    template <typename T> inline void deserialize_(tools::Parallel<T> elt) {
+        select_deserialize(elt.container);
+    }
+
+    /// @brief Serialize function for containers wrapped in Chunked. The
+    ///        positions of the ends of the chunks are appended after the
+    ///        elements.
+    /// @param elt Element that is serialized.
+    template <typename T> inline void serialize_(tools::Chunked<T> elt) {
+        using ValueType =
+            mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<T>>>;
+        auto size = std::size(elt.container);
+        size_t chunkSize = elt.chunkSize;
+        size_t nbChunks = (size_t(size) + chunkSize - 1) / chunkSize;
+        std::vector<size_t> ends;
+        size_t nbBytes = 0;
+
+        append(std::bit_cast<const byte_type *>(&size), sizeof(size));
+        append(std::bit_cast<const byte_type *>(&chunkSize), sizeof(chunkSize));
+        ends.reserve(nbChunks);
+        if constexpr (concepts::Stream<MemT>) {
+            // streams cannot be overwritten, so the elements are measured
+            // before being serialized
+            size_t i = 0;
+            for (auto &e : elt.container) {
+                nbBytes += measure(e);
+                if (++i % chunkSize == 0 || i == size_t(size)) {
+                    ends.push_back(nbBytes);
+                }
+            }
+            append(std::bit_cast<const byte_type *>(&nbBytes),
+                   sizeof(nbBytes));
+            for (auto &e : elt.container) {
+                select_serialize(e);
+            }
+        } else {
+            size_t nbBytesPos = pos;
+            append(std::bit_cast<const byte_type *>(&nbBytes),
+                   sizeof(nbBytes));
+            size_t begin = pos;
+
+            if constexpr (concepts::ContiguousTrivial<T, MemT>) {
+                append(std::bit_cast<const byte_type *>(
+                           std::to_address(elt.container.begin())),
+                       sizeof(ValueType) * size_t(size));
+                for (size_t chunk = 0; chunk < nbChunks; ++chunk) {
+                    ends.push_back(
+                        std::min((chunk + 1) * chunkSize, size_t(size)) *
+                        sizeof(ValueType));
+                }
+            } else {
+                bool parallel = false;
+                if constexpr (parallel_serialization<T>) {
+                    parallel = nbChunks >= 2 && elt.pool.size() > 1;
+                    if (parallel) {
+                        ends = serializeChunks(elt.container, elt.pool,
+                                               chunkSize);
+                    }
+                }
+                if (!parallel) {
+                    size_t i = 0;
+                    for (auto &e : elt.container) {
+                        select_serialize(e);
+                        if (++i % chunkSize == 0 || i == size_t(size)) {
+                            ends.push_back(pos - begin);
+                        }
+                    }
+                }
+            }
+            nbBytes = pos - begin;
+            write(nbBytesPos, std::bit_cast<const byte_type *>(&nbBytes),
+                  sizeof(nbBytes));
+        }
+        static_assert(sizeof(size_t) == sizeof(std::uint64_t));
+        append(std::bit_cast<const byte_type *>(ends.data()),
+               ends.size() * sizeof(size_t));
+    }
+
+    /// @brief Deserialize function for containers wrapped in Chunked. The
+    ///        chunks are deserialized concurrently: contiguous containers are
+    ///        resized once and the chunks are deserialized in place, the other
+    ///        containers are built from runs of elements deserialized by the
+    ///        threads that are inserted in order (with the end() hint when the
+    ///        container supports it).
+    /// @param elt Element that is deserialized.
+    /// @throw std::out_of_range when the chunks do not match the data.
+    template <typename T> inline void deserialize_(tools::Chunked<T> elt) {
+        using C = mtf::clean_t<T>;
+        using ValueType = mtf::remove_const_t<mtf::iter_value_t<C>>;
+        using size_type = decltype(std::size(elt.container));
+        using ChunkSerializer = Serializer<std::span<const byte_type>,
+                                           TypeTable, AdditionalTypes...>;
+        size_type size = deserializeSize<size_type>();
+        size_t chunkSize = deserializeSize<size_t>();
+        size_t nbBytes = deserializeSize<size_t>();
+        size_t begin = pos;
+        size_t nbChunks =
+            chunkSize == 0 ? 0 : (size_t(size) + chunkSize - 1) / chunkSize;
+
+        if (chunkSize == 0 && size > 0) [[unlikely]] {
+            throw std::out_of_range("error: invalid chunk size.");
+        }
+        if constexpr (parallel_deserialization<T>) {
+            if (nbChunks >= 2 && elt.pool.size() > 1) {
+                std::vector<size_t> ends(nbChunks);
+                pos = begin + nbBytes;
+                read(ends.data(), nbChunks * sizeof(size_t));
+                if (!std::ranges::is_sorted(ends) || ends.back() != nbBytes)
+                    [[unlikely]] {
+                    throw std::out_of_range("error: invalid chunk.");
+                }
+                std::span<const byte_type> view(mem.data(), pos);
+                auto chunk = [&](size_t c, auto &&fun) {
+                    size_t first = c * chunkSize;
+                    size_t last = std::min(first + chunkSize, size_t(size));
+                    ChunkSerializer serializer(
+                        view, begin + (c > 0 ? ends[c - 1] : 0));
+                    fun(serializer, first, last);
+                    if (serializer.pos != begin + ends[c]) [[unlikely]] {
+                        throw std::out_of_range("error: invalid chunk.");
+                    }
+                };
+
+                if constexpr (concepts::ContiguousResizeable<C>) {
+                    elt.container.resize(size);
+                    auto values = std::ranges::begin(elt.container);
+                    elt.pool.parallelFor(nbChunks, [&](size_t c) {
+                        chunk(c, [&](auto &serializer, size_t first,
+                                     size_t last) {
+                            for (size_t i = first; i < last; ++i) {
+                                serializer.select_deserialize(values[i]);
+                            }
+                        });
+                    });
+                } else {
+                    std::vector<std::vector<ValueType>> runs(nbChunks);
+                    elt.pool.parallelFor(nbChunks, [&](size_t c) {
+                        chunk(c, [&](auto &serializer, size_t first,
+                                     size_t last) {
+                            runs[c].resize(last - first);
+                            for (auto &value : runs[c]) {
+                                serializer.select_deserialize(value);
+                            }
+                        });
+                    });
+                    if constexpr (concepts::Clearable<C>) {
+                        elt.container.clear();
+                    }
+                    size_t i = 0;
+                    for (auto &run : runs) {
+                        for (auto &value : run) {
+                            if constexpr (concepts::HintInsertable<C,
+                                                                   ValueType>) {
+                                tools::insertBack(elt.container,
+                                                  std::move(value));
+                            } else if constexpr (
+                                concepts::Insertable<C, ValueType> ||
+                                concepts::PushBackable<C, ValueType>) {
+                                tools::insert(elt.container, std::move(value));
+                            } else {
+                                tools::insert(elt.container, std::move(value),
+                                              i);
+                            }
+                            ++i;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        deserializeElements(elt.container, size);
+        if (pos != begin + nbBytes) [[unlikely]] {
+            throw std::out_of_range("error: invalid chunk.");
+        }
+        pos += nbChunks * sizeof(size_t);
+    }
+
     /* static array ***********************************************************/
 
     /// @brief Serialize function for static arrays.
@@ -393,6 +873,10 @@ struct Serializer : Serialize<AdditionalTypes>... {
             append(std::bit_cast<const byte_type *>(std::to_address(elt)),
                    sizeof(elt[0]) * size);
         } else {
+            using ST = std::remove_extent_t<mtf::clean_t<T>>;
+            if constexpr (concepts::FixedSize<ST, Serializer>) {
+                reserve(mtf::fixed_serialized_size_v<ST, Serializer> * size);
+            }
             for (size_t i = 0; i < size; ++i) {
                 select_serialize(elt[i]);
             }
@@ -407,9 +891,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
         size_t size = std::extent_v<mtf::clean_t<T>>;
 
         if constexpr (concepts::TrivialyDeserializableStaticArray<T, MemT>) {
-            std::memcpy(std::to_address(elt), mem.data() + pos,
-                        sizeof(ST) * size);
-            pos += sizeof(ST) * size;
+            read(std::to_address(elt), sizeof(ST) * size);
         } else {
             for (size_t i = 0; i < size; ++i) {
                 select_deserialize(elt[i]);
@@ -460,7 +942,7 @@ struct Serializer : Serialize<AdditionalTypes>... {
     template <concepts::Pointer T, typename DT, typename... DTs>
     inline constexpr void deserialize_(tools::DynamicArray<T, DT, DTs...> elt) {
         using ST = std::remove_pointer_t<mtf::clean_t<T>>;
-        bool ptrValid = char(mem[pos++]) == 'v';
+        bool ptrValid = deserializeSize<char>() == 'v';
 
         if (!ptrValid) {
             elt.mem = nullptr;
@@ -471,6 +953,11 @@ struct Serializer : Serialize<AdditionalTypes>... {
             size_t size = (size_t)std::get<0>(elt.dimensions);
             if (elt.mem == nullptr) {
                 elt.mem = new ST[size]();
+#ifdef SERIALIZER_ALLOC_STATS
+                if (!std::is_constant_evaluated()) {
+                    tools::countCreate<ST>(size);
+                }
+#endif
             }
             for (size_t i = 0; i < size; ++i) {
                 select_deserialize(tools::DynamicArray(
@@ -480,11 +967,15 @@ struct Serializer : Serialize<AdditionalTypes>... {
             size_t size = tools::tupleProd<size_t>(elt.dimensions);
             if (elt.mem == nullptr) {
                 elt.mem = new ST[size]();
+#ifdef SERIALIZER_ALLOC_STATS
+                if (!std::is_constant_evaluated()) {
+                    tools::countCreate<ST>(size);
+                }
+#endif
             }
             if constexpr (concepts::Trivial<ST> &&
                           !concepts::Deserializable<ST, MemT>) {
-                std::memcpy(elt.mem, mem.data() + pos, size * sizeof(ST));
-                pos += size * sizeof(ST);
+                read(elt.mem, size * sizeof(ST));
             } else {
                 for (size_t i = 0; i < size; ++i) {
                     select_deserialize(elt.mem[i]);
@@ -0,0 +1,193 @@
+#ifndef SERIALIZER_SKIP_H
+#define SERIALIZER_SKIP_H
+#include "exceptions/unsupported_type.hpp"
+#include "meta/fixed_size.hpp"
+#include "meta/members.hpp"
+#include "meta/serializer_meta.hpp"
+#include "serializer/serializer.hpp"
+#include "tools/type_table.hpp"
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// @brief serializer namespace
+namespace serializer {
+
+template <typename Ser, typename T>
+inline constexpr size_t skip(auto const &mem, size_t pos);
+
+/// @brief Read a value of type U at pos (the values of the buffer are not
+///        aligned, so they are copied).
+/// @tparam U Type of the value.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the value in mem.
+/// @return Value.
+template <typename U> inline U readUnaligned_(auto const &mem, size_t pos) {
+    U value;
+    std::memcpy(&value, mem.data() + pos, sizeof(U));
+    return value;
+}
+
+/// @brief Skip the elements of a tuple type.
+/// @tparam Ser Serializer type.
+/// @tparam Tuple Tuple type.
+/// @tparam Idx Indicies of the tuple elements.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the tuple in mem.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename Tuple, size_t... Idx>
+inline constexpr size_t skipTuple_(auto const &mem, size_t pos,
+                                   std::index_sequence<Idx...>) {
+    ((pos = skip<Ser, std::tuple_element_t<Idx, Tuple>>(mem, pos)), ...);
+    return pos;
+}
+
+/// @brief Skip the elements of a tuple type.
+/// @tparam Ser Serializer type.
+/// @tparam Tuple Tuple type.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the tuple in mem.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename Tuple>
+inline constexpr size_t skipTuple(auto const &mem, size_t pos) {
+    return skipTuple_<Ser, Tuple>(
+        mem, pos, std::make_index_sequence<std::tuple_size_v<Tuple>>());
+}
+
+/// @brief Skip an object serialized with the offset table layout (the end of
+///        the object is stored in the last entry of the table).
+/// @tparam Ser Serializer type.
+/// @tparam T Type of the object.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the object in mem.
+/// @return Position of the next element in the buffer.
+template <typename Ser, typename T>
+inline constexpr size_t skipTable(auto const &mem, size_t pos) {
+    using MemT = typename Ser::mem_type;
+    using Members = mtf::members_t<T, MemT>;
+    constexpr size_t size = mtf::table_size_v<T, MemT>;
+
+    if constexpr (std::tuple_size_v<Members> != size) {
+        pos += sizeof(std::tuple_element_t<0, Members>); // id
+    }
+    if constexpr (size == 0) {
+        return pos;
+    } else {
+        return pos + readUnaligned_<size_t>(mem,
+                                            pos + (size - 1) * sizeof(size_t));
+    }
+}
+
+/// @brief Advance over a serialized value of type T without deserializing it
+///        (nothing is allocated or constructed). Fixed size types, contiguous
+///        containers of trivial types, offset tables, indexed and chunked
+///        containers are skipped in O(1).
+///        Note: the serializer functions (except SER_DFUN), the custom
+///        serialize functions and the dynamic arrays (the dimensions are not
+///        serialized) cannot be skipped.
+/// @tparam Ser Serializer type.
+/// @tparam T Type of the serialized value.
+/// @param mem Buffer of bytes that contains the serialized data.
+/// @param pos Position of the value in mem.
+/// @return Position of the next element in the buffer.
+/// @throw UnsupportedTypeError when the type cannot be skipped.
+template <typename Ser, typename T>
+inline constexpr size_t skip(auto const &mem, size_t pos) {
+    using Type = mtf::clean_t<T>;
+    using MemT = typename Ser::mem_type;
+    using TypeTable = typename Ser::type_table;
+
+    if constexpr (concepts::FixedSize<Type, Ser>) {
+        return pos + mtf::fixed_serialized_size_v<Type, Ser>;
+    } else if constexpr (mtf::is_deserialization_function_v<Type>) {
+        return pos;
+    } else if constexpr (mtf::is_super_v<Type>) {
+        return skip<Ser, mtf::clean_t<decltype(*std::declval<Type>().obj)>>(
+            mem, pos);
+    } else if constexpr (std::is_base_of_v<Serialize<Type>, Ser>) {
+        throw exceptions::UnsupportedTypeError<T>();
+    } else if constexpr (concepts::Serializable<Type, MemT>) {
+        if constexpr (mtf::has_table_v<Type, MemT>) {
+            return skipTable<Ser, Type>(mem, pos);
+        } else if constexpr (mtf::has_members_v<Type, MemT>) {
+            return skipTuple<Ser, mtf::members_t<Type, MemT>>(mem, pos);
+        } else {
+            throw exceptions::UnsupportedTypeError<T>();
+        }
+    } else if constexpr (concepts::Pointer<Type>) {
+        if (char(mem[pos++]) != 'v') {
+            return pos;
+        }
+        if constexpr (concepts::ConcretePtr<Type>) {
+            return skip<Ser, mtf::base_t<Type>>(mem, pos);
+        } else if constexpr (tools::has_type_v<Type, TypeTable>) {
+            // the id is serialized by the pointed object
+            auto id =
+                readUnaligned_<typename TypeTable::id_type>(mem, pos);
+            tools::applyId(id, TypeTable(), [&]<typename U>() {
+                pos = skip<Ser, U>(mem, pos);
+            });
+            return pos;
+        } else {
+            throw exceptions::UnsupportedTypeError<T>();
+        }
+    } else if constexpr (concepts::String<Type>) {
+        using size_type = typename Type::size_type;
+        auto size = readUnaligned_<size_type>(mem, pos);
+        return pos + sizeof(size_type) + size;
+    } else if constexpr (mtf::is_parallel_v<Type>) {
+        // same data as the container
+        return skip<Ser, decltype(std::declval<Type>().container)>(mem, pos);
+    } else if constexpr (mtf::is_chunked_v<Type>) {
+        using size_type = decltype(std::size(std::declval<Type>().container));
+        auto size = readUnaligned_<size_type>(mem, pos);
+        pos += sizeof(size_type);
+        auto chunkSize = readUnaligned_<size_t>(mem, pos);
+        pos += sizeof(size_t);
+        pos += sizeof(size_t) + readUnaligned_<size_t>(mem, pos);
+        if (chunkSize > 0) {
+            pos += (size_t(size) + chunkSize - 1) / chunkSize * sizeof(size_t);
+        }
+        return pos;
+    } else if constexpr (mtf::is_indexed_v<Type>) {
+        using size_type = decltype(std::size(std::declval<Type>().container));
+        auto size = readUnaligned_<size_type>(mem, pos);
+        pos += sizeof(size_type);
+        size_t nbBytes = readUnaligned_<size_t>(mem, pos);
+        pos += sizeof(size_t) + (nbBytes & ~tools::index_present_flag);
+        if (nbBytes & tools::index_present_flag) {
+            pos += size * sizeof(tools::index_delta_type);
+        }
+        return pos;
+    } else if constexpr (concepts::Container<Type>) {
+        using size_type = decltype(std::size(std::declval<Type>()));
+        using ValueType = mtf::remove_const_t<mtf::iter_value_t<Type>>;
+        auto size = readUnaligned_<size_type>(mem, pos);
+        pos += sizeof(size_type);
+
+        if constexpr (concepts::ContiguousTrivial<Type, MemT>) {
+            return pos + size * sizeof(ValueType);
+        } else if constexpr (concepts::FixedSize<ValueType, Ser>) {
+            return pos + size * mtf::fixed_serialized_size_v<ValueType, Ser>;
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                pos = skip<Ser, ValueType>(mem, pos);
+            }
+            return pos;
+        }
+    } else if constexpr (concepts::StaticArray<Type>) {
+        for (size_t i = 0; i < std::extent_v<Type>; ++i) {
+            pos = skip<Ser, std::remove_extent_t<Type>>(mem, pos);
+        }
+        return pos;
+    } else if constexpr (concepts::TupleLike<Type>) {
+        return skipTuple<Ser, Type>(mem, pos);
+    } else {
+        throw exceptions::UnsupportedTypeError<T>();
+    }
+}
+
+} // end namespace serializer
+
+#endif
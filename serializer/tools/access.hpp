@@ -0,0 +1,84 @@
+#ifndef SERIALIZER_ACCESS_HPP
+#define SERIALIZER_ACCESS_HPP
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                   Access                                   */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Read only access to a raw struct stored in a memory buffer (see
+///        serializer::access). The struct is accessed in place when the
+///        buffer is correctly aligned, otherwise it holds a copy.
+/// @tparam T Type of the struct.
+template <typename T> class Access {
+  public:
+    /// @brief Constructor for an in place access.
+    /// @param ptr Pointer to the struct in the buffer.
+    constexpr explicit Access(T const *ptr) : ptr_(ptr) {}
+
+    /// @brief Constructor for a copy (misaligned buffer).
+    /// @param copy Copy of the struct.
+    constexpr explicit Access(T const &copy) : copy_(copy) {}
+
+    /// @brief Pointer to the struct.
+    constexpr T const *get() const { return ptr_ ? ptr_ : &*copy_; }
+
+    /// @brief True if the struct is accessed in place (no copy).
+    constexpr bool inPlace() const { return ptr_ != nullptr; }
+
+    constexpr T const &operator*() const { return *get(); }
+    constexpr T const *operator->() const { return get(); }
+
+  private:
+    T const *ptr_ = nullptr; ///< pointer into the buffer
+    std::optional<T> copy_;  ///< copy used when the buffer is misaligned
+};
+
+/// @brief Read only access to an array of raw structs stored in a memory
+///        buffer (see serializer::accessArray). The elements are accessed in
+///        place when the buffer is correctly aligned, otherwise they are
+///        copied.
+/// @tparam T Type of the elements.
+template <typename T> class AccessSpan {
+  public:
+    /// @brief Constructor for an in place access.
+    /// @param span Elements in the buffer.
+    constexpr explicit AccessSpan(std::span<T const> span) : span_(span) {}
+
+    /// @brief Constructor for a copy (misaligned buffer).
+    /// @param copy Copy of the elements.
+    constexpr explicit AccessSpan(std::vector<T> &&copy)
+        : copy_(std::move(copy)), span_(copy_), inPlace_(false) {}
+
+    AccessSpan(AccessSpan const &) = delete;
+    AccessSpan &operator=(AccessSpan const &) = delete;
+    AccessSpan(AccessSpan &&) = default; // the buffer of copy_ is kept
+    AccessSpan &operator=(AccessSpan &&) = default;
+
+    /// @brief Span over the elements.
+    constexpr std::span<T const> span() const { return span_; }
+
+    /// @brief True if the elements are accessed in place (no copy).
+    constexpr bool inPlace() const { return inPlace_; }
+
+    constexpr size_t size() const { return span_.size(); }
+    constexpr T const &operator[](size_t idx) const { return span_[idx]; }
+    constexpr auto begin() const { return span_.begin(); }
+    constexpr auto end() const { return span_.end(); }
+
+  private:
+    std::vector<T> copy_;     ///< copy used when the buffer is misaligned
+    std::span<T const> span_; ///< elements
+    bool inPlace_ = true;     ///< true if span_ points into the buffer
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef SERIALIZER_ALLOC_STATS_HPP
+#define SERIALIZER_ALLOC_STATS_HPP
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                alloc stats                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Number of allocations and bytes allocated.
+struct AllocStats {
+    size_t allocations = 0; ///< number of allocations
+    size_t bytes = 0;       ///< bytes allocated
+
+    constexpr AllocStats &operator+=(AllocStats const &other) {
+        allocations += other.allocations;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    constexpr AllocStats operator-(AllocStats const &other) const {
+        return {allocations - other.allocations, bytes - other.bytes};
+    }
+
+    constexpr bool operator==(AllocStats const &) const = default;
+};
+
+/// @brief Allocation counters of a thread. The heap counters are updated by
+///        the operator new hooks (see SERIALIZER_ALLOC_HOOKS), the other ones
+///        by the serializer when SERIALIZER_ALLOC_STATS is defined.
+struct AllocCounters {
+    AllocStats heap;    ///< operator new (all the allocations)
+    AllocStats buffers; ///< reallocations of the Bytes buffers (alloc)
+    AllocStats objects; ///< objects created by the deserialization (create)
+};
+
+/// @brief Objects created by the deserialization for one type (nodes of a
+///        per-thread list, so the accounting does not allocate).
+struct TypeAllocStats {
+    std::type_info const *type = nullptr; ///< created type
+    AllocStats stats;                     ///< created objects
+    TypeAllocStats *next = nullptr;       ///< next type of the thread
+    bool registered = false;              ///< in the list of the thread
+};
+
+/// @brief Counters of the calling thread.
+inline thread_local AllocCounters allocCounters;
+
+/// @brief Types created by the calling thread (most recent first).
+inline thread_local TypeAllocStats *allocTypes = nullptr;
+
+/// @brief Counters of the type T for the calling thread.
+template <typename T> inline thread_local TypeAllocStats typeAllocStats;
+
+/// @brief Count the creation of objects of type T by the deserialization
+///        (called by the serializer when SERIALIZER_ALLOC_STATS is defined).
+/// @param count Number of objects created with one allocation (arrays).
+template <typename T> inline void countCreate(size_t count = 1) {
+    TypeAllocStats &node = typeAllocStats<T>;
+
+    if (!node.registered) [[unlikely]] {
+        node.type = &typeid(T);
+        node.next = std::exchange(allocTypes, &node);
+        node.registered = true;
+    }
+    node.stats += {1, count * sizeof(T)};
+    allocCounters.objects += {1, count * sizeof(T)};
+}
+
+/// @brief Allocations of a function call (see countAllocations).
+struct AllocReport {
+    AllocStats heap;    ///< operator new
+    AllocStats buffers; ///< reallocations of the Bytes buffers
+    AllocStats objects; ///< objects created by the deserialization
+    /// @brief Objects created for each type (most recent type first).
+    std::vector<std::pair<std::type_info const *, AllocStats>> types;
+};
+
+/// @brief Count the allocations made by the calling thread during the
+///        execution of fun (for instance, a top-level deserialize call). The
+///        report does not include its own allocations.
+/// @param fun Function to run.
+/// @return Allocations of fun.
+inline AllocReport countAllocations(auto &&fun) {
+    std::vector<AllocStats> before;
+    AllocReport report;
+
+    for (TypeAllocStats *node = allocTypes; node; node = node->next) {
+        before.push_back(node->stats);
+    }
+    report.types.reserve(before.size());
+    TypeAllocStats *head = allocTypes;
+    AllocCounters counters = allocCounters;
+    fun();
+    report.heap = allocCounters.heap - counters.heap;
+    report.buffers = allocCounters.buffers - counters.buffers;
+    report.objects = allocCounters.objects - counters.objects;
+
+    // the types created for the first time are at the head of the list
+    size_t idx = 0;
+    bool known = false;
+    for (TypeAllocStats *node = allocTypes; node; node = node->next) {
+        known = known || node == head;
+        AllocStats stats = known ? node->stats - before[idx++] : node->stats;
+        if (stats.allocations > 0) {
+            report.types.emplace_back(node->type, stats);
+        }
+    }
+    return report;
+}
+
+} // end namespace serializer::tools
+
+#endif
+
+/* hooks **********************************************************************/
+
+// The global operator new and operator delete are replaced in the translation
+// unit that defines SERIALIZER_ALLOC_HOOKS before including this file (only
+// one translation unit of the program should define it).
+#if defined(SERIALIZER_ALLOC_HOOKS) && !defined(SERIALIZER_ALLOC_HOOKS_DEFINED)
+#define SERIALIZER_ALLOC_HOOKS_DEFINED
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Counted allocation of the operator new hooks (nullptr on failure).
+/// @param size Number of bytes.
+/// @param alignment Alignment (0 for the default alignment of malloc).
+inline void *hookAllocate(std::size_t size, std::size_t alignment) noexcept {
+    allocCounters.heap += {1, size};
+    if (alignment == 0) {
+        return std::malloc(size == 0 ? 1 : size);
+    }
+    size = (size + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, size ? size : alignment);
+}
+
+/// @brief Deallocation of the operator delete hooks. All the variants of
+///        operator new use hookAllocate, so all the variants of operator
+///        delete use free (not inlined, so the compiler does not pair free
+///        with the library operator new).
+[[gnu::noinline]] inline void hookDeallocate(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+} // end namespace serializer::tools
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept {
+    return serializer::tools::hookAllocate(size, 0);
+}
+
+void *operator new(std::size_t size, std::align_val_t align,
+                   std::nothrow_t const &) noexcept {
+    return serializer::tools::hookAllocate(size,
+                                           static_cast<std::size_t>(align));
+}
+
+void *operator new(std::size_t size) {
+    if (void *ptr = serializer::tools::hookAllocate(size, 0)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    if (void *ptr = serializer::tools::hookAllocate(
+            size, static_cast<std::size_t>(align))) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align,
+                     std::nothrow_t const &) noexcept {
+    return operator new(size, align, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete(void *ptr, std::nothrow_t const &) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t,
+                     std::nothrow_t const &) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t,
+                       std::nothrow_t const &) noexcept {
+    serializer::tools::hookDeallocate(ptr);
+}
+
+#endif
@@ -4,6 +4,10 @@
 #include <bit>
 #include <cstddef>
 #include <cstring>
+#include <type_traits>
+#ifdef SERIALIZER_ALLOC_STATS
+#include "alloc_stats.hpp"
+#endif
 
 /******************************************************************************/
 /*                                   bytes                                    */
@@ -129,6 +133,11 @@ class Bytes {
     /// @brief Reallocate memory and change the capacity.
     /// @param newCapacity New capacity of the the buffer.
     constexpr void alloc(size_t newCapacity) {
+#ifdef SERIALIZER_ALLOC_STATS
+        if (!std::is_constant_evaluated()) {
+            allocCounters.buffers += {1, newCapacity * sizeof(T)};
+        }
+#endif
         capacity_ = newCapacity;
         T *tmp = mem_;
         mem_ = new T[capacity_];
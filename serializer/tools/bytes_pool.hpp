@@ -0,0 +1,376 @@
+#ifndef SERIALIZER_BYTES_POOL_HPP
+#define SERIALIZER_BYTES_POOL_HPP
+#include "bytes.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                                 bytes pool                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Pool of reusable memory buffers. The buffers released to the pool
+///        keep their capacity, so the serialization of the next batch does
+///        not allocate.
+/// @tparam T Byte type.
+template <typename T> class BytesPool {
+  public:
+    /// @brief Constructor.
+    /// @param maxBuffers Maximum number of buffers kept in the pool.
+    explicit BytesPool(size_t maxBuffers = 64) : maxBuffers_(maxBuffers) {}
+
+    /// @brief Get an empty buffer with at least the given capacity.
+    /// @param capacity Minimum capacity of the buffer.
+    Bytes<T> acquire(size_t capacity = 0) {
+        if (buffers_.empty()) {
+            return Bytes<T>(capacity);
+        }
+        Bytes<T> buffer = std::move(buffers_.back());
+        buffers_.pop_back();
+        buffer.clear();
+        buffer.upsize(capacity);
+        return buffer;
+    }
+
+    /// @brief Give a buffer back to the pool (it is freed when the pool is
+    ///        full).
+    /// @param buffer Released buffer.
+    void release(Bytes<T> &&buffer) {
+        if (buffers_.size() < maxBuffers_ && buffer.data() != nullptr) {
+            buffers_.push_back(std::move(buffer));
+        }
+    }
+
+    /// @brief Number of buffers available in the pool.
+    size_t size() const { return buffers_.size(); }
+
+  private:
+    std::vector<Bytes<T>> buffers_; ///< available buffers
+    size_t maxBuffers_ = 0;         ///< maximum number of buffers
+};
+
+/******************************************************************************/
+/*                              shared bytes pool                             */
+/******************************************************************************/
+
+/// @brief Statistics of a shared bytes pool.
+struct BytesPoolStats {
+    size_t hits = 0;          ///< buffers found in a thread cache
+    size_t sharedHits = 0;    ///< buffers found in the shared lists
+    size_t misses = 0;        ///< buffers allocated
+    size_t dropped = 0;       ///< released buffers freed (pool full)
+    size_t cachedBuffers = 0; ///< buffers kept by the pool
+    size_t cachedBytes = 0;   ///< capacity of the buffers kept by the pool
+};
+
+/// @brief Global pool of reusable memory buffers that can be used by any
+///        thread. The buffers are sorted in size classes (powers of two).
+///        Each thread keeps a few buffers of each class in a cache, and the
+///        other buffers are stored in lock-free lists shared by the threads
+///        (the buffers of a thread cache are moved to the shared lists when
+///        the thread exits). The released buffers keep their capacity, so
+///        once the pool is warm, acquiring a buffer and serializing in it
+///        does not allocate.
+/// @tparam T Byte type.
+template <typename T> class SharedBytesPool {
+  public:
+    /// @brief Capacity of the buffers of the smallest class.
+    static constexpr size_t min_capacity = 64;
+    /// @brief Number of size classes (the largest class holds the buffers of
+    ///        at least 256MB).
+    static constexpr size_t nb_classes = 23;
+    /// @brief Number of buffers of each class kept by a thread.
+    static constexpr size_t cache_size = 4;
+    /// @brief Number of buffers of each class kept in the shared lists.
+    static constexpr size_t shared_size = 64;
+
+    SharedBytesPool(SharedBytesPool const &) = delete;
+    SharedBytesPool &operator=(SharedBytesPool const &) = delete;
+
+    /// @brief Destructor (frees the buffers of the shared lists).
+    ~SharedBytesPool() { trim(); }
+
+    /// @brief Returns the pool of the program.
+    static SharedBytesPool &global() {
+        static SharedBytesPool pool;
+        return pool;
+    }
+
+    /// @brief Get an empty buffer with at least the given capacity. The buffer
+    ///        is taken from the cache of the thread, then from the shared
+    ///        lists, and it is allocated when there is no buffer large enough
+    ///        (its capacity is rounded up to the size class).
+    /// @param capacity Minimum capacity of the buffer.
+    Bytes<T> acquire(size_t capacity = 0) {
+        size_t cls = acquireClass(capacity);
+        Cache &cache = threadCache();
+
+        for (size_t c = cls; c < nb_classes; ++c) {
+            if (cache.counts[c] > 0) {
+                size_t idx = --cache.counts[c];
+                Bytes<T> buffer = std::move(cache.buffers[c][idx]);
+                add(cache.hits, 1);
+                sub(cache.nbBuffers, 1);
+                sub(cache.nbBytes, buffer.capacity());
+                return buffer;
+            }
+        }
+        for (size_t c = cls; c < nb_classes; ++c) {
+            Bytes<T> buffer;
+            if (pop(c, buffer)) {
+                sharedHits_.fetch_add(1, std::memory_order_relaxed);
+                return buffer;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return Bytes<T>(cls < nb_classes ? min_capacity << cls : capacity);
+    }
+
+    /// @brief Give a buffer back to the pool. The buffer is stored in the
+    ///        cache of the thread, then in the shared lists, and it is freed
+    ///        when the pool is full or when its capacity is out of the size
+    ///        classes.
+    /// @param buffer Released buffer.
+    void release(Bytes<T> &&buffer) {
+        if (buffer.data() == nullptr || buffer.capacity() < min_capacity) {
+            return;
+        }
+        size_t cls = releaseClass(buffer.capacity());
+        Cache &cache = threadCache();
+
+        buffer.clear();
+        if (cache.counts[cls] < cache_size) {
+            add(cache.nbBuffers, 1);
+            add(cache.nbBytes, buffer.capacity());
+            cache.buffers[cls][cache.counts[cls]++] = std::move(buffer);
+        } else if (!push(cls, std::move(buffer))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            buffer = Bytes<T>();
+        }
+    }
+
+    /// @brief Free the buffers of the shared lists (the thread caches are
+    ///        kept).
+    void trim() {
+        for (size_t c = 0; c < nb_classes; ++c) {
+            Bytes<T> buffer;
+            while (pop(c, buffer)) {
+                buffer = Bytes<T>();
+            }
+        }
+    }
+
+    /// @brief Returns the statistics of the pool (the counters of the thread
+    ///        caches are summed).
+    BytesPoolStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        BytesPoolStats result = {
+            .hits = retiredHits_,
+            .sharedHits = sharedHits_.load(std::memory_order_relaxed),
+            .misses = misses_.load(std::memory_order_relaxed),
+            .dropped = dropped_.load(std::memory_order_relaxed),
+            .cachedBuffers = sharedBuffers_.load(std::memory_order_relaxed),
+            .cachedBytes = sharedBytes_.load(std::memory_order_relaxed),
+        };
+        for (Cache const *cache : caches_) {
+            result.hits += cache->hits.load();
+            result.cachedBuffers += cache->nbBuffers.load();
+            result.cachedBytes += cache->nbBytes.load();
+        }
+        return result;
+    }
+
+  private:
+    static constexpr std::uint32_t nil = ~std::uint32_t(0);
+
+    /// @brief Element of the shared lists.
+    struct Node {
+        Bytes<T> buffer;                 ///< stored buffer
+        std::atomic<std::uint32_t> next; ///< next node of the list
+    };
+
+    /// @brief Lock-free stack of nodes. The head stores the index of the
+    ///        first node and a tag that is incremented by each operation (ABA
+    ///        problem). The nodes are never freed, so reading the next node
+    ///        of a head that has been popped concurrently is valid.
+    struct Stack {
+        std::atomic<std::uint64_t> head = nil; ///< tag | index of the head
+    };
+
+    /// @brief Shared lists of a size class: the nodes that store a buffer and
+    ///        the empty nodes.
+    struct Class {
+        std::array<Node, shared_size> nodes; ///< nodes
+        Stack full;                          ///< nodes with a buffer
+        Stack empty;                         ///< nodes without buffer
+    };
+
+    /// @brief Cache of a thread. The counters are only written by the thread
+    ///        (no atomic read-modify-write), and read by stats.
+    struct Cache {
+        ~Cache() {
+            if (pool) {
+                pool->retire(*this);
+            }
+        }
+
+        SharedBytesPool *pool = nullptr; ///< owner
+        /// @brief Buffers of each class.
+        std::array<std::array<Bytes<T>, cache_size>, nb_classes> buffers;
+        std::array<size_t, nb_classes> counts = {}; ///< number of buffers
+        std::atomic<size_t> hits = 0;               ///< hits
+        std::atomic<size_t> nbBuffers = 0;          ///< buffers in the cache
+        std::atomic<size_t> nbBytes = 0;            ///< capacity of the cache
+    };
+
+    std::array<Class, nb_classes> classes_; ///< shared lists
+    std::atomic<size_t> sharedHits_ = 0;    ///< shared lists hits
+    std::atomic<size_t> misses_ = 0;        ///< allocations
+    std::atomic<size_t> dropped_ = 0;       ///< freed buffers
+    std::atomic<size_t> sharedBuffers_ = 0; ///< buffers in the shared lists
+    std::atomic<size_t> sharedBytes_ = 0;   ///< capacity of the shared lists
+    mutable std::mutex mutex_;              ///< protects the caches list
+    std::vector<Cache *> caches_;           ///< caches of the threads
+    size_t retiredHits_ = 0;                ///< hits of the exited threads
+
+    SharedBytesPool() {
+        for (Class &cls : classes_) {
+            for (std::uint32_t i = 0; i < shared_size; ++i) {
+                push(cls.empty, cls, i);
+            }
+        }
+    }
+
+    /// @brief Cache of the calling thread.
+    Cache &threadCache() {
+        static thread_local Cache cache;
+        if (cache.pool == nullptr) [[unlikely]] {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache.pool = this;
+            caches_.push_back(&cache);
+        }
+        return cache;
+    }
+
+    /// @brief Move the buffers of the cache of an exiting thread to the
+    ///        shared lists and keep its counters.
+    void retire(Cache &cache) {
+        for (size_t c = 0; c < nb_classes; ++c) {
+            while (cache.counts[c] > 0) {
+                Bytes<T> &buffer = cache.buffers[c][--cache.counts[c]];
+                if (!push(c, std::move(buffer))) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        retiredHits_ += cache.hits;
+        std::erase(caches_, &cache);
+    }
+
+    /// @brief Smallest class which buffers have at least the given capacity
+    ///        (nb_classes if there is none).
+    static size_t acquireClass(size_t capacity) {
+        if (capacity <= min_capacity) {
+            return 0;
+        }
+        size_t cls = std::bit_width(capacity - 1) -
+                     std::bit_width(min_capacity - 1);
+        return std::min(cls, nb_classes);
+    }
+
+    /// @brief Class of a buffer (the largest class which capacity is lower or
+    ///        equal to the capacity of the buffer).
+    static size_t releaseClass(size_t capacity) {
+        size_t cls = std::bit_width(capacity) - std::bit_width(min_capacity);
+        return std::min(cls, nb_classes - 1);
+    }
+
+    /// @brief Add to a counter of a thread cache (single writer).
+    static void add(std::atomic<size_t> &counter, size_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    /// @brief Subtract from a counter of a thread cache (single writer).
+    static void sub(std::atomic<size_t> &counter, size_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) - value,
+                      std::memory_order_relaxed);
+    }
+
+    /// @brief Push the node idx on a stack.
+    static void push(Stack &stack, Class &cls, std::uint32_t idx) {
+        std::uint64_t head = stack.head.load(std::memory_order_relaxed);
+        std::uint64_t next;
+
+        do {
+            cls.nodes[idx].next.store(std::uint32_t(head),
+                                      std::memory_order_relaxed);
+            next = ((head >> 32) + 1) << 32 | idx;
+        } while (!stack.head.compare_exchange_weak(head, next,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+
+    /// @brief Pop a node from a stack.
+    /// @return Index of the node (nil when the stack is empty).
+    static std::uint32_t pop(Stack &stack, Class &cls) {
+        std::uint64_t head = stack.head.load(std::memory_order_acquire);
+        std::uint64_t next;
+
+        do {
+            if (std::uint32_t(head) == nil) {
+                return nil;
+            }
+            std::uint32_t idx = std::uint32_t(head);
+            next = ((head >> 32) + 1) << 32 |
+                   cls.nodes[idx].next.load(std::memory_order_relaxed);
+        } while (!stack.head.compare_exchange_weak(head, next,
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_acquire));
+        return std::uint32_t(head);
+    }
+
+    /// @brief Store a buffer in the shared list of a class.
+    /// @return False when the list is full.
+    bool push(size_t c, Bytes<T> &&buffer) {
+        std::uint32_t idx = pop(classes_[c].empty, classes_[c]);
+
+        if (idx == nil) {
+            return false;
+        }
+        sharedBuffers_.fetch_add(1, std::memory_order_relaxed);
+        sharedBytes_.fetch_add(buffer.capacity(), std::memory_order_relaxed);
+        classes_[c].nodes[idx].buffer = std::move(buffer);
+        push(classes_[c].full, classes_[c], idx);
+        return true;
+    }
+
+    /// @brief Take a buffer from the shared list of a class.
+    /// @return False when the list is empty.
+    bool pop(size_t c, Bytes<T> &buffer) {
+        std::uint32_t idx = pop(classes_[c].full, classes_[c]);
+
+        if (idx == nil) {
+            return false;
+        }
+        buffer = std::move(classes_[c].nodes[idx].buffer);
+        push(classes_[c].empty, classes_[c], idx);
+        sharedBuffers_.fetch_sub(1, std::memory_order_relaxed);
+        sharedBytes_.fetch_sub(buffer.capacity(), std::memory_order_relaxed);
+        return true;
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
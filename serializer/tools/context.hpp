@@ -1,5 +1,6 @@
 #ifndef SERIALIZER_CONTEXT_H
 #define SERIALIZER_CONTEXT_H
+#include <utility>
 
 /// @brief namespace serializer tools
 namespace serializer::tools {
@@ -17,6 +18,21 @@ template <Phases Phase, typename Serializer> struct Context {
     Serializer serializer;                 ///< serializer
 };
 
+/// @brief Wrapper for the serializer functions that are only executed during
+///        the deserialization (they do not serialize anything, which allows
+///        skipping them, see skip).
+/// @tparam F Type of the function.
+template <typename F> struct DeserializationFunction {
+    F function; ///< serializer function
+
+    /// @brief Execute the function with the given context.
+    /// @param context Context of the serialization.
+    template <Phases Phase, typename Serializer>
+    constexpr void operator()(Context<Phase, Serializer> &&context) const {
+        function(std::move(context));
+    }
+};
+
 } // namespace serializer::tools
 
 #endif
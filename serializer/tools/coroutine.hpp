@@ -0,0 +1,356 @@
+#ifndef SERIALIZER_COROUTINE_HPP
+#define SERIALIZER_COROUTINE_HPP
+#include "bytes.hpp"
+#include "stream.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+/******************************************************************************/
+/*                                 coroutine                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/* task ***********************************************************************/
+
+/// @brief Part of the promise of the tasks that does not depend on the result
+///        type. The root task keeps the innermost coroutine that is suspended
+///        (the one resumed by Task::resume).
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation; ///< coroutine awaiting the task
+    std::coroutine_handle<> resumePoint;  ///< suspended coroutine (root only)
+    TaskPromiseBase *root = this;         ///< promise of the root task
+    std::exception_ptr error;             ///< exception thrown by the task
+
+    /// @brief Record the suspended coroutine h in the root task.
+    void park(std::coroutine_handle<> h) { root->resumePoint = h; }
+};
+
+/// @brief Lazy coroutine type used by the asynchronous serialization (see
+///        serializeAsync). A task can be awaited by another task (the awaiting
+///        task is resumed when it completes) or driven by the user with resume
+///        until done returns true. When a nested task suspends, resume
+///        continues the innermost task.
+/// @tparam T Type of the result.
+template <typename T> class Task {
+  public:
+    struct promise_type : TaskPromiseBase {
+        T value{}; ///< result
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(
+                *this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    auto continuation = h.promise().continuation;
+                    return continuation ? continuation
+                                        : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void return_value(T result) { value = std::move(result); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    /* constructors & destructor **********************************************/
+
+    Task() = default;
+    Task(Task const &) = delete;
+    Task &operator=(Task const &) = delete;
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /* driver *****************************************************************/
+
+    /// @brief True when the task is complete.
+    bool done() const { return !handle_ || handle_.done(); }
+
+    /// @brief Run the task until it suspends or completes.
+    /// @throw The exception thrown by the task when it completes with an
+    ///        error.
+    void resume() {
+        if (done()) {
+            return;
+        }
+        auto h = std::exchange(handle_.promise().resumePoint, {});
+        (h ? h : std::coroutine_handle<>(handle_)).resume();
+        if (handle_.done() && handle_.promise().error) {
+            std::rethrow_exception(handle_.promise().error);
+        }
+    }
+
+    /// @brief Result of the task (the task should be complete).
+    /// @throw The exception thrown by the task.
+    T result() const {
+        if (handle_.promise().error) {
+            std::rethrow_exception(handle_.promise().error);
+        }
+        return handle_.promise().value;
+    }
+
+    /* awaitable **************************************************************/
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> parent) {
+        handle_.promise().continuation = parent;
+        handle_.promise().root = parent.promise().root;
+        return handle_;
+    }
+
+    T await_resume() const { return result(); }
+
+  private:
+    std::coroutine_handle<promise_type> handle_ = nullptr; ///< coroutine
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {}
+};
+
+/// @brief Awaitable that always suspends the task (the innermost task is
+///        resumed by the next call to Task::resume). It is used to wait for
+///        the output buffer to be drained or for the input to be fed.
+struct Park {
+    bool await_ready() const noexcept { return false; }
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> h) const {
+        h.promise().park(h);
+    }
+    void await_resume() const noexcept {}
+};
+
+/// @brief Instance of Park (co_await tools::park).
+inline constexpr Park park;
+
+/* async output ***************************************************************/
+
+/// @brief Memory buffer type used by the asynchronous serialization. The
+///        serialized data is appended to a buffer that is drained by the user
+///        (see pending and consume). The serialization suspends when the
+///        pending data does not leave enough space for the next value, so the
+///        memory used is bounded by the capacity (plus the size of the largest
+///        value that is not split). The positions work like OutputStream (the
+///        position of the buffer is its size).
+class AsyncOutput {
+  public:
+    using byte_type = std::byte;
+
+    /// @brief Constructor.
+    /// @param capacity Capacity of the buffer.
+    explicit AsyncOutput(size_t capacity = default_stream_buffer_size)
+        : buffer_(capacity), capacity_(capacity) {}
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of bytes appended (consumed or not).
+    size_t size() const {
+        return measuring_ ? end_ : base_ + buffer_.size();
+    }
+
+    /// @brief Capacity of the buffer.
+    size_t capacity() const { return capacity_; }
+
+    /// @brief Data that has not been consumed yet.
+    std::span<std::byte const> pending() const {
+        return {buffer_.data() + begin_, buffer_.size() - begin_};
+    }
+
+    /// @brief True if nbBytes can be appended without exceeding the capacity
+    ///        (always true when there is no pending data).
+    bool hasSpace(size_t nbBytes) const {
+        size_t count = buffer_.size() - begin_;
+        return count == 0 || count + nbBytes <= capacity_;
+    }
+
+    /// @brief Drop the first nbBytes of the pending data (they have been sent).
+    void consume(size_t nbBytes) {
+        begin_ += nbBytes;
+        if (begin_ >= buffer_.size()) {
+            base_ += buffer_.size();
+            buffer_.clear();
+            begin_ = 0;
+        }
+    }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at the end of the buffer.
+    /// @param pos     Position where the bytes are appended (should be size()).
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    /// @throw std::logic_error when pos is not the end of the buffer.
+    void append(size_t pos, std::byte const *bytes, size_t nbBytes) {
+        if (pos != size()) [[unlikely]] {
+            throw std::logic_error(
+                "error: the data can only be appended to a stream.");
+        }
+        if (measuring_) {
+            end_ += nbBytes;
+            return;
+        }
+        if (begin_ > 0 && buffer_.size() + nbBytes > capacity_) {
+            size_t count = buffer_.size() - begin_;
+            std::memmove(buffer_.data(), buffer_.data() + begin_, count);
+            base_ += begin_;
+            buffer_.resize(count);
+            begin_ = 0;
+        }
+        buffer_.append(buffer_.size(), bytes, nbBytes);
+    }
+
+    /// @brief Run a function that appends data without writing anything (see
+    ///        OutputStream::measure).
+    /// @param fun Function that appends data to the buffer.
+    /// @return Number of bytes appended by the function.
+    size_t measure(auto &&fun) {
+        size_t begin = size();
+        size_t end = end_;
+        bool measuring = std::exchange(measuring_, true);
+
+        end_ = begin;
+        fun();
+        size_t nbBytes = end_ - begin;
+        end_ = end;
+        measuring_ = measuring;
+        return nbBytes;
+    }
+
+  private:
+    Bytes<std::byte> buffer_; ///< pending data (from begin_)
+    size_t capacity_ = 0;     ///< capacity of the buffer
+    size_t begin_ = 0;        ///< first byte that has not been consumed
+    size_t base_ = 0;         ///< position of the first byte of the buffer
+    size_t end_ = 0;          ///< size of the buffer (measure)
+    bool measuring_ = false;  ///< true when measuring
+};
+
+/* async input ****************************************************************/
+
+/// @brief Exception thrown when reading data that has not been received yet
+///        from an AsyncInput (the asynchronous deserialization waits for more
+///        data and tries again).
+class InputUnderflow : public std::out_of_range {
+  public:
+    InputUnderflow() : std::out_of_range("error: data not received yet.") {}
+};
+
+/// @brief Memory buffer type used by the asynchronous deserialization. The
+///        received data is given to the buffer with feed, and the
+///        deserialization suspends when the data it needs has not been
+///        received yet. The bytes that precede the last released position are
+///        dropped, so the buffer only holds the value being deserialized.
+class AsyncInput {
+  public:
+    using byte_type = std::byte;
+
+    /// @brief Constructor.
+    /// @param capacity Initial capacity of the buffer.
+    explicit AsyncInput(size_t capacity = default_stream_buffer_size)
+        : buffer_(capacity) {}
+
+    /* feed *******************************************************************/
+
+    /// @brief Add received data at the end of the buffer.
+    /// @param bytes Received bytes.
+    /// @param nbBytes Number of bytes.
+    void feed(std::byte const *bytes, size_t nbBytes) {
+        if (released_ > base_) {
+            size_t count = buffer_.size() - (released_ - base_);
+            std::memmove(buffer_.data(), buffer_.data() + (released_ - base_),
+                         count);
+            buffer_.resize(count);
+            base_ = released_;
+        }
+        buffer_.append(buffer_.size(), bytes, nbBytes);
+    }
+
+    /// @brief Mark the end of the data (reading past the end throws
+    ///        std::out_of_range instead of waiting).
+    void close() { closed_ = true; }
+
+    /// @brief True when the end of the data has been marked.
+    bool closed() const { return closed_; }
+
+    /// @brief Position of the end of the received data.
+    size_t end() const { return base_ + buffer_.size(); }
+
+    /// @brief True if nbBytes at pos can be read (or if the input is closed).
+    bool hasData(size_t pos, size_t nbBytes) const {
+        return closed_ || end() >= pos + nbBytes;
+    }
+
+    /// @brief Allow the bytes before pos to be dropped (they will not be read
+    ///        again).
+    void release(size_t pos) { released_ = std::max(released_, pos); }
+
+    /* read *******************************************************************/
+
+    /// @brief Copy nbBytes from the buffer at pos into bytes.
+    /// @param pos Position of the data.
+    /// @param bytes Destination buffer.
+    /// @param nbBytes Number of bytes to read.
+    /// @throw std::logic_error when pos has already been dropped.
+    /// @throw InputUnderflow when the data has not been received yet.
+    /// @throw std::out_of_range when the input is closed before the data.
+    void read(size_t pos, void *bytes, size_t nbBytes) const {
+        check(pos, nbBytes);
+        std::memcpy(bytes, buffer_.data() + (pos - base_), nbBytes);
+    }
+
+    /// @brief Same as read (the bytes are not dropped by read either).
+    void peek(size_t pos, void *bytes, size_t nbBytes) const {
+        read(pos, bytes, nbBytes);
+    }
+
+  private:
+    Bytes<std::byte> buffer_; ///< received data
+    size_t base_ = 0;         ///< position of the first byte of the buffer
+    size_t released_ = 0;     ///< bytes before this position can be dropped
+    bool closed_ = false;     ///< true when all the data has been received
+
+    /// @brief Verify that the range can be read.
+    void check(size_t pos, size_t nbBytes) const {
+        if (pos < base_) [[unlikely]] {
+            throw std::logic_error(
+                "error: the data can only be read forward in a stream.");
+        }
+        if (pos + nbBytes > end()) {
+            if (closed_) {
+                throw std::out_of_range("error: unexpected end of stream.");
+            }
+            throw InputUnderflow();
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef SERIALIZER_DYNAMIC_ARRAY_HPP
 #define SERIALIZER_DYNAMIC_ARRAY_HPP
 #include "../meta/concepts.hpp"
+#include <tuple>
 
 /******************************************************************************/
 /*                               Dynamic Array                                */
@@ -10,7 +11,10 @@
 namespace serializer::tools {
 
 /// @brief Wrapper object for dynamic arrays (can store references to the
-///        variables that contains the array size).
+///        variables that contains the array size). The dimensions given as
+///        variables are stored by reference and the other ones (literals) by
+///        value, so the wrapper can outlive the expression that creates it
+///        (see serializerMembers).
 template <concepts::Pointer T, typename... DTs> struct DynamicArray {
     /// @brief Constructor that should be used by the user.
     /// @param mem Reference to the pointer of the array that should be
@@ -26,14 +30,19 @@ template <concepts::Pointer T, typename... DTs> struct DynamicArray {
     /// @param mem Reference to the pointer of the array that should be
     ///            serialized.
     /// @param dimensions Tuple that holds the dimensions of the sub-array.
-    constexpr explicit DynamicArray(T &mem,
-                                    std::tuple<const DTs &...> &&dimensions)
+    constexpr explicit DynamicArray(T &mem, std::tuple<DTs...> &&dimensions)
         : mem(mem), dimensions(dimensions) {}
 
-    T &mem; ///< reference to the pointer of the array.
-    std::tuple<const DTs &...> dimensions; ///< dimensions of the array.
+    T &mem;                        ///< reference to the pointer of the array.
+    std::tuple<DTs...> dimensions; ///< dimensions of the array.
 };
 
+template <typename T, typename... DTs>
+DynamicArray(T &, DTs &&...) -> DynamicArray<T, DTs...>;
+
+template <typename T, typename... DTs>
+DynamicArray(T &, std::tuple<DTs...> &&) -> DynamicArray<T, DTs...>;
+
 } // end namespace serializer::tools
 
 #endif
@@ -0,0 +1,63 @@
+#ifndef SERIALIZER_FRAME_HPP
+#define SERIALIZER_FRAME_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/******************************************************************************/
+/*                                   frame                                    */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Value stored at the beginning of each frame header (used to detect
+///        invalid headers and to find the next frame after a corruption).
+inline constexpr std::uint16_t frame_magic = 0x5346; // "FS"
+
+/// @brief Flag set when the payload is protected by a checksum (the other bits
+///        of the flags are free for the user).
+inline constexpr std::uint16_t frame_checksum = 1;
+
+/// @brief Header serialized before the payload of each frame. The payload can
+///        be forwarded, split or dispatched using only the header.
+struct FrameHeader {
+    std::uint16_t magic = frame_magic; ///< frame marker
+    std::uint16_t flags = 0;           ///< frame_checksum and user flags
+    std::uint32_t type = 0;            ///< type id of the payload
+    std::uint64_t length = 0;          ///< number of bytes of the payload
+    std::uint32_t checksum = 0;        ///< crc32 of the payload (optional)
+    std::uint32_t headerChecksum = 0;  ///< crc32 of the previous fields
+};
+
+/// @brief Table used to compute the crc32 (reflected polynomial 0xEDB88320).
+inline constexpr auto crc32_table = [] {
+    std::array<std::uint32_t, 256> table = {};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+/// @brief Compute the crc32 of a buffer of bytes.
+/// @param bytes Buffer of bytes.
+/// @param nbBytes Size of the buffer.
+/// @param crc Crc of the previous bytes (to compute the crc by parts).
+/// @return crc32 of the bytes.
+inline constexpr std::uint32_t crc32(auto const *bytes, size_t nbBytes,
+                                     std::uint32_t crc = 0) {
+    static_assert(sizeof(*bytes) == 1, "error: crc32 requires bytes.");
+    crc = ~crc;
+    for (size_t i = 0; i < nbBytes; ++i) {
+        crc = crc32_table[(crc ^ std::uint8_t(bytes[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // end namespace serializer::tools
+
+#endif
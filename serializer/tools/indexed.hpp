@@ -0,0 +1,60 @@
+#ifndef SERIALIZER_INDEXED_HPP
+#define SERIALIZER_INDEXED_HPP
+#include <cstddef>
+#include <cstdint>
+
+/******************************************************************************/
+/*                                  Indexed                                   */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Default minimum number of elements for which the offset index of an
+///        Indexed container is serialized.
+inline constexpr size_t default_index_threshold = 64;
+
+/// @brief Type used to store the size of each element in the offset index.
+using index_delta_type = std::uint32_t;
+
+/// @brief Bit of the number of bytes of the elements that is set when the
+///        offset index is serialized.
+inline constexpr size_t index_present_flag = size_t(1)
+                                             << (sizeof(size_t) * 8 - 1);
+
+/// @brief Wrapper object for containers that are serialized with an offset
+///        index. The container is serialized as:
+///        [size][number of bytes of the elements | index flag][elements]
+///        [index]
+///        The index is only serialized when the container has at least
+///        Threshold elements, and the readers use the flag (not their own
+///        threshold) to know if it is present. It stores the size of each
+///        element (delta encoding), the offsets are obtained using a prefix
+///        sum (see IndexedView).
+/// @tparam C Type of the container.
+/// @tparam Threshold Minimum number of elements for which the index is
+///                   serialized.
+template <typename C, size_t Threshold = default_index_threshold>
+struct Indexed {
+    static constexpr size_t threshold = Threshold;
+
+    /// @brief Constructor from a reference to the container.
+    /// @param container Reference to the container.
+    constexpr explicit Indexed(C &container) : container(container) {}
+
+    C &container; ///< reference to the container.
+};
+
+/// @brief Helper function for creating an Indexed wrapper with a custom
+///        threshold.
+/// @tparam Threshold Minimum number of elements for which the index is
+///                   serialized.
+/// @param container Reference to the container.
+template <size_t Threshold, typename C>
+inline constexpr auto indexed(C &container) {
+    return Indexed<C, Threshold>(container);
+}
+
+} // end namespace serializer::tools
+
+#endif
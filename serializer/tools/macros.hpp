@@ -6,7 +6,10 @@
 /******************************************************************************/
 
 /// @brief Generate the serialize and deserialize methods with the specified
-///        serializer. The keywords virtual and override can be added.
+///        serializer. The keywords virtual and override can be added. The
+///        serializerMembers methods give access to the serialized members
+///        (used to inspect the serialized types at compile time) and the
+///        serializerType method gives the serializer used for a buffer type.
 /// @param Ser Serializer.
 /// @param virt Virtual keyworkd.
 /// @param over Override keyworkd.
@@ -19,6 +22,15 @@
     constexpr virt size_t deserialize(MemT &mem, size_t pos = 0) over {        \
         return serializer::deserializeWithId<Ser, decltype(this)>(             \
             mem, pos, __VA_ARGS__);                                            \
+    }                                                                          \
+    constexpr auto serializerMembers([[maybe_unused]] auto &mem) const {       \
+        return serializer::membersWithId<Ser, decltype(this)>(__VA_ARGS__);   \
+    }                                                                          \
+    constexpr auto serializerMembers([[maybe_unused]] auto &mem) {             \
+        return serializer::membersWithId<Ser, decltype(this)>(__VA_ARGS__);   \
+    }                                                                          \
+    static constexpr auto serializerType([[maybe_unused]] auto &mem) {         \
+        return std::type_identity<Ser>();                                      \
     }
 
 /// @brief Generate the serialze and deserialize methods with the specified
@@ -36,6 +48,47 @@
     INTERNAL_SERIALIZE_MACRO_IMPL(serializer::Serializer<decltype(mem)>, auto, \
                                   /* virt */, /* over */, __VA_ARGS__)
 
+/// @brief Generate the serialize and deserialize methods that use the offset
+///        table layout (see serializeTable and View).
+/// @param Ser Serializer.
+/// @param ... Members to serialize.
+#define INTERNAL_SERIALIZE_TABLE_MACRO_IMPL(Ser, ...)                          \
+    constexpr size_t serialize(auto &mem, size_t pos = 0) const {              \
+        return serializer::serializeTable<Ser, decltype(this)>(mem, pos,       \
+                                                               __VA_ARGS__);   \
+    }                                                                          \
+    constexpr size_t deserialize(auto &mem, size_t pos = 0) {                  \
+        return serializer::deserializeTable<Ser, decltype(this)>(              \
+            mem, pos, __VA_ARGS__);                                            \
+    }                                                                          \
+    constexpr auto serializerMembers([[maybe_unused]] auto &mem) const {       \
+        return serializer::membersWithId<Ser, decltype(this)>(__VA_ARGS__);   \
+    }                                                                          \
+    constexpr auto serializerMembers([[maybe_unused]] auto &mem) {             \
+        return serializer::membersWithId<Ser, decltype(this)>(__VA_ARGS__);   \
+    }                                                                          \
+    constexpr auto serializerTable([[maybe_unused]] auto &mem) const {         \
+        return serializer::tableLayout(__VA_ARGS__);                           \
+    }                                                                          \
+    static constexpr auto serializerType([[maybe_unused]] auto &mem) {         \
+        return std::type_identity<Ser>();                                      \
+    }
+
+/// @brief Generate the serialize and deserialize methods with the default
+///        serializer using the offset table layout (the members can be read
+///        individually with a View).
+/// @param ... Members to serialize.
+#define SERIALIZE_TABLE(...)                                                   \
+    INTERNAL_SERIALIZE_TABLE_MACRO_IMPL(serializer::Serializer<decltype(mem)>, \
+                                        __VA_ARGS__)
+
+/// @brief Generate the serialize and deserialize methods with the specified
+///        serializer using the offset table layout.
+/// @param Ser Serializer.
+/// @param ... Members to serialize.
+#define SERIALIZE_TABLE_CUSTOM(Ser, ...)                                       \
+    INTERNAL_SERIALIZE_TABLE_MACRO_IMPL(Ser, __VA_ARGS__)
+
 /// @brief Generate the serialze and deserialize virtual methods using the
 ///        specified serializer.
 /// @param Ser Serializer
@@ -79,6 +132,12 @@
     }                                                                          \
     constexpr size_t deserialize(auto const &mem, size_t pos = 0) {            \
         return serializer::deserializeStruct(mem, pos, this);                  \
+    }                                                                          \
+    constexpr auto serializerMembers(auto &) const {                           \
+        return serializer::structMembers(this);                                \
+    }                                                                          \
+    constexpr auto serializerMembers(auto &) {                                 \
+        return serializer::structMembers(this);                                \
     }
 
 /******************************************************************************/
@@ -91,6 +150,11 @@
 ///            value or size_t& by reference)
 #define SER_DARR(...) serializer::tools::DynamicArray(__VA_ARGS__)
 
+/// @brief Helper macro for serializing a container with an offset index (see
+///        Indexed).
+/// @param container Container to serialize.
+#define SER_INDEXED(container) serializer::tools::Indexed(container)
+
 /// @brief Helper macro for SERIALIZE_CUSTOM (get the type of the bytes buffer)
 #define SER_MEMT decltype(mem)
 
@@ -119,9 +183,9 @@
 ///        deserialization.
 /// @param code Code to execute.
 #define SER_DFUN(code)                                                         \
-    SER_FUN({                                                                  \
+    serializer::tools::DeserializationFunction{SER_FUN({                       \
         if constexpr (Phase == serializer::tools::Phases::Deserialization)     \
             code;                                                              \
-    })
+    })}
 
 #endif
@@ -0,0 +1,96 @@
+#ifndef SERIALIZER_PARALLEL_HPP
+#define SERIALIZER_PARALLEL_HPP
+#include "thread_pool.hpp"
+#include <cstddef>
+
+/******************************************************************************/
+/*                                  Parallel                                  */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Default number of elements of the chunks of the parallel containers.
+inline constexpr size_t default_parallel_chunk_size = 4096;
+
+/// @brief Wrapper object for containers that are serialized by a thread pool.
+///        The container is split in chunks, the size of each chunk is
+///        computed, the positions of the chunks are obtained using a prefix
+///        sum, and the chunks are serialized concurrently at their final
+///        position. The serialized data is the same as the one of the
+///        container (a Parallel container can be deserialized as the
+///        container and conversely).
+///        The parallel mode is used for random access containers which
+///        elements are not trivial, when the memory buffer supports random
+///        access. The chunks are measured with a ByteCounter and written in
+///        a span, so the elements which serializer has a fixed memory type
+///        (for instance SERIALIZE_CUSTOM(Serializer<Bytes>, ...)) are
+///        serialized sequentially.
+/// @tparam C Type of the container.
+template <typename C> struct Parallel {
+    /// @brief Constructor.
+    /// @param container Reference to the container.
+    /// @param pool Thread pool that serializes the chunks.
+    /// @param chunkSize Number of elements of the chunks.
+    constexpr Parallel(C &container, ThreadPool &pool,
+                       size_t chunkSize = default_parallel_chunk_size)
+        : container(container), pool(pool),
+          chunkSize(chunkSize > 0 ? chunkSize : 1) {}
+
+    C &container;     ///< reference to the container.
+    ThreadPool &pool; ///< threads
+    size_t chunkSize; ///< number of elements of the chunks
+};
+
+/// @brief Helper function for creating a Parallel wrapper.
+/// @param container Reference to the container.
+/// @param pool Thread pool that serializes the chunks.
+/// @param chunkSize Number of elements of the chunks.
+template <typename C>
+inline constexpr auto parallel(C &container, ThreadPool &pool,
+                               size_t chunkSize = default_parallel_chunk_size) {
+    return Parallel<C>(container, pool, chunkSize);
+}
+
+/// @brief Wrapper object for containers that are serialized with the
+///        boundaries of their chunks, so they can be deserialized by a thread
+///        pool. The container is serialized as:
+///        [size][chunk size][number of bytes of the elements][elements]
+///        [end of each chunk]
+///        The ends of the chunks are relative to the first element. The chunks
+///        are serialized concurrently like the ones of Parallel. When the data
+///        is deserialized, contiguous containers are resized once and their
+///        chunks are deserialized in place, and the other containers (lists,
+///        sets, maps, ...) are built from the runs of elements deserialized by
+///        the threads. The memory buffer should support random access, and
+///        the elements which serializer has a fixed memory type are
+///        (de)serialized sequentially.
+/// @tparam C Type of the container.
+template <typename C> struct Chunked {
+    /// @brief Constructor.
+    /// @param container Reference to the container.
+    /// @param pool Thread pool that (de)serializes the chunks.
+    /// @param chunkSize Number of elements of the chunks (serialization).
+    constexpr Chunked(C &container, ThreadPool &pool,
+                      size_t chunkSize = default_parallel_chunk_size)
+        : container(container), pool(pool),
+          chunkSize(chunkSize > 0 ? chunkSize : 1) {}
+
+    C &container;     ///< reference to the container.
+    ThreadPool &pool; ///< threads
+    size_t chunkSize; ///< number of elements of the chunks
+};
+
+/// @brief Helper function for creating a Chunked wrapper.
+/// @param container Reference to the container.
+/// @param pool Thread pool that (de)serializes the chunks.
+/// @param chunkSize Number of elements of the chunks (serialization).
+template <typename C>
+inline constexpr auto chunked(C &container, ThreadPool &pool,
+                              size_t chunkSize = default_parallel_chunk_size) {
+    return Chunked<C>(container, pool, chunkSize);
+}
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef SERIALIZER_STATS_HPP
+#define SERIALIZER_STATS_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/******************************************************************************/
+/*                                   stats                                    */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Operation recorded by a statistics policy.
+enum class StatsOperation { Serialization, Deserialization };
+
+/// @brief Statistics of a type.
+struct TypeStats {
+    size_t serialized = 0;               ///< objects serialized
+    size_t deserialized = 0;             ///< objects deserialized
+    size_t bytesWritten = 0;             ///< bytes serialized
+    size_t bytesRead = 0;                ///< bytes deserialized
+    std::uint64_t serializeCycles = 0;   ///< cycles spent serializing
+    std::uint64_t deserializeCycles = 0; ///< cycles spent deserializing
+
+    constexpr TypeStats &operator+=(TypeStats const &other) {
+        serialized += other.serialized;
+        deserialized += other.deserialized;
+        bytesWritten += other.bytesWritten;
+        bytesRead += other.bytesRead;
+        serializeCycles += other.serializeCycles;
+        deserializeCycles += other.deserializeCycles;
+        return *this;
+    }
+};
+
+/// @brief Statistics policy of a serializer. It is given with the additional
+///        types of the Serializer (Serializer<MemT, TypeTable, Policy>). When
+///        stats_enabled is true, the serialization and the deserialization of
+///        each object that uses the serializer are recorded with
+///        Policy::record<T>(operation, bytes, cycles) (the nested objects
+///        that use the same policy are included in the totals of their
+///        parent).
+template <typename T>
+concept StatsPolicy = requires {
+    { T::stats_enabled } -> std::convertible_to<bool>;
+};
+
+/// @brief Policy that does not collect anything (default, the serializer
+///        code is unchanged).
+struct NoStats {
+    static constexpr bool stats_enabled = false;
+};
+
+/// @brief Statistics policy of a serializer (the first policy found in its
+///        additional types, NoStats otherwise).
+template <typename... Ts> struct stats_policy {
+    using type = NoStats;
+};
+
+template <typename T, typename... Ts> struct stats_policy<T, Ts...> {
+    using type = typename stats_policy<Ts...>::type;
+};
+
+template <StatsPolicy T, typename... Ts> struct stats_policy<T, Ts...> {
+    using type = T;
+};
+
+template <typename... Ts>
+using stats_policy_t = typename stats_policy<Ts...>::type;
+
+/// @brief Statistics policy of a serializer type.
+template <typename Ser> struct serializer_stats {
+    using type = NoStats;
+};
+
+template <typename Ser>
+    requires requires { typename Ser::stats_type; }
+struct serializer_stats<Ser> {
+    using type = typename Ser::stats_type;
+};
+
+template <typename Ser>
+using serializer_stats_t = typename serializer_stats<Ser>::type;
+
+/// @brief Current value of the cycle counter (time stamp counter on x86,
+///        nanoseconds otherwise).
+inline std::uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/// @brief Record the operation fun (returns the end position of the object
+///        that starts at pos) on an object of type T with the statistics
+///        policy of Ser (nothing is recorded at compile time).
+/// @return End position of the object.
+template <typename Ser, typename T>
+constexpr inline size_t recordStats(StatsOperation operation, size_t pos,
+                                    auto &&fun) {
+    if (std::is_constant_evaluated()) {
+        return fun();
+    }
+    std::uint64_t begin = cycles();
+    size_t end = fun();
+    serializer_stats_t<Ser>::template record<T>(operation, end - pos,
+                                                cycles() - begin);
+    return end;
+}
+
+/* thread stats ***************************************************************/
+
+/// @brief Counters of a type for one thread (written by the thread only).
+struct ThreadStatsNode {
+    std::type_info const *type = nullptr;          ///< counted type
+    std::atomic<std::uint64_t> counters[6] = {};   ///< see TypeStats
+    std::atomic<ThreadStatsNode *> next = nullptr; ///< next type
+    bool registered = false;                       ///< in the thread list
+
+    /// @brief Statistics of the node.
+    TypeStats load() const {
+        return {counters[0].load(std::memory_order_relaxed),
+                counters[1].load(std::memory_order_relaxed),
+                counters[2].load(std::memory_order_relaxed),
+                counters[3].load(std::memory_order_relaxed),
+                counters[4].load(std::memory_order_relaxed),
+                counters[5].load(std::memory_order_relaxed)};
+    }
+
+    /// @brief Add a value to a counter (single writer, no atomic RMW).
+    void add(size_t idx, std::uint64_t value) {
+        counters[idx].store(counters[idx].load(std::memory_order_relaxed) +
+                                value,
+                            std::memory_order_relaxed);
+    }
+};
+
+/// @brief Policy that counts the objects, the bytes and the cycles of each
+///        type in thread-local counters (no lock and no shared write on the
+///        serialization path). The counters of all the threads, including
+///        the threads that have exited, are merged by collect.
+class ThreadStats {
+  public:
+    static constexpr bool stats_enabled = true;
+
+    /// @brief Record an operation on an object of type T.
+    /// @param operation Serialization or deserialization.
+    /// @param bytes Number of bytes written or read.
+    /// @param cycles Cycles spent (see tools::cycles).
+    template <typename T>
+    static void record(StatsOperation operation, size_t bytes,
+                       std::uint64_t cycles) {
+        ThreadStatsNode &node = node_<T>;
+
+        if (!node.registered) [[unlikely]] {
+            node.type = &typeid(T);
+            list().push(&node);
+            node.registered = true;
+        }
+        size_t idx = operation == StatsOperation::Serialization ? 0 : 1;
+        node.add(idx, 1);
+        node.add(idx + 2, bytes);
+        node.add(idx + 4, cycles);
+    }
+
+    /// @brief Statistics of the calling thread for the type T.
+    template <typename T> static TypeStats local() { return node_<T>.load(); }
+
+    /// @brief Merge the counters of all the threads.
+    /// @return Statistics of each type (by type name).
+    static std::map<std::string, TypeStats> collect() {
+        std::map<std::type_index, TypeStats> totals;
+        std::map<std::string, TypeStats> result;
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        totals = retired_;
+        for (List const *list : lists_) {
+            for (ThreadStatsNode const *node = list->head.load(
+                     std::memory_order_acquire);
+                 node; node = node->next.load(std::memory_order_relaxed)) {
+                totals[*node->type] += node->load();
+            }
+        }
+        for (auto const &[type, stats] : totals) {
+            result[typeName(type)] += stats;
+        }
+        return result;
+    }
+
+    /// @brief Reset the counters of all the threads (the threads should not
+    ///        serialize during the reset).
+    static void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        retired_.clear();
+        for (List const *list : lists_) {
+            for (ThreadStatsNode *node =
+                     list->head.load(std::memory_order_acquire);
+                 node; node = node->next.load(std::memory_order_relaxed)) {
+                for (auto &counter : node->counters) {
+                    counter.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    /// @brief Print the merged statistics (sorted by number of bytes).
+    static void dump(std::ostream &os) {
+        auto stats = collect();
+        std::vector<std::pair<std::string, TypeStats>> types(stats.begin(),
+                                                             stats.end());
+        std::sort(types.begin(), types.end(), [](auto const &a, auto const &b) {
+            return a.second.bytesWritten + a.second.bytesRead >
+                   b.second.bytesWritten + b.second.bytesRead;
+        });
+        os << std::left << std::setw(32) << "type" << std::right
+           << std::setw(12) << "serialized" << std::setw(14) << "bytes"
+           << std::setw(16) << "cycles" << std::setw(14) << "deserialized"
+           << std::setw(14) << "bytes" << std::setw(16) << "cycles"
+           << std::endl;
+        for (auto const &[name, s] : types) {
+            os << std::left << std::setw(32) << name << std::right
+               << std::setw(12) << s.serialized << std::setw(14)
+               << s.bytesWritten << std::setw(16) << s.serializeCycles
+               << std::setw(14) << s.deserialized << std::setw(14)
+               << s.bytesRead << std::setw(16) << s.deserializeCycles
+               << std::endl;
+        }
+    }
+
+  private:
+    /// @brief Types counted by a thread (registered while the thread runs,
+    ///        merged in retired_ when it exits).
+    struct List {
+        std::atomic<ThreadStatsNode *> head = nullptr; ///< most recent type
+
+        List() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lists_.push_back(this);
+        }
+
+        ~List() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (ThreadStatsNode *node = head.load(); node;
+                 node = node->next.load()) {
+                retired_[*node->type] += node->load();
+            }
+            std::erase(lists_, this);
+        }
+
+        void push(ThreadStatsNode *node) {
+            node->next.store(head.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+            head.store(node, std::memory_order_release);
+        }
+    };
+
+    static inline std::mutex mutex_;                 ///< protects the lists
+    static inline std::vector<List *> lists_;        ///< running threads
+    static inline std::map<std::type_index, TypeStats> retired_; ///< exited
+    template <typename T>
+    static inline thread_local ThreadStatsNode node_; ///< counters of T
+
+    static List &list() {
+        thread_local List list;
+        return list;
+    }
+
+    /// @brief Name of a type (demangled when possible).
+    static std::string typeName(std::type_index type) {
+#if __has_include(<cxxabi.h>)
+        int status = 0;
+        char *name =
+            abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (status == 0) {
+            std::string result = name;
+            std::free(name);
+            return result;
+        }
+#endif
+        return type.name();
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
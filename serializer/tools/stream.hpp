@@ -0,0 +1,397 @@
+#ifndef SERIALIZER_STREAM_HPP
+#define SERIALIZER_STREAM_HPP
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <ios>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+/******************************************************************************/
+/*                                   stream                                   */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Default capacity of the staging buffer of the streams.
+inline constexpr size_t default_stream_buffer_size = 1 << 20;
+
+/* sinks **********************************************************************/
+
+/// @brief Sink that writes to a file descriptor.
+struct FdSink {
+    int fd; ///< file descriptor (not closed by the sink)
+
+    /// @brief Write all the bytes (partial writes are retried).
+    /// @throw std::system_error when the write fails.
+    void write(std::byte const *bytes, size_t nbBytes) {
+        while (nbBytes > 0) {
+            ssize_t count = ::write(fd, bytes, nbBytes);
+            if (count < 0) [[unlikely]] {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot write to the fd.");
+            }
+            bytes += count;
+            nbBytes -= size_t(count);
+        }
+    }
+};
+
+/// @brief Sink that writes to a std::ostream.
+struct OStreamSink {
+    std::ostream &os; ///< output stream
+
+    /// @brief Write all the bytes.
+    /// @throw std::ios_base::failure when the stream is in a failed state.
+    void write(std::byte const *bytes, size_t nbBytes) {
+        os.write(reinterpret_cast<char const *>(bytes),
+                 std::streamsize(nbBytes));
+        if (!os) [[unlikely]] {
+            throw std::ios_base::failure("error: cannot write to the stream.");
+        }
+    }
+};
+
+/* output stream **************************************************************/
+
+/// @brief Memory buffer type that streams the serialized data to a sink
+///        through a fixed size staging buffer, so the memory used does not
+///        depend on the size of the serialized data. The data can only be
+///        appended: the positions given to append must follow each other
+///        (the position of the stream is its size).
+///        The values which encoding needs a size that is only known after
+///        serializing their content (offset tables and indexed containers) are
+///        measured first (see measure), so nothing is written twice.
+/// @tparam Sink Type of the sink (see FdSink and OStreamSink).
+template <typename Sink> class OutputStream {
+  public:
+    using byte_type = std::byte;
+
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor from a sink.
+    /// @param sink Sink where the data is flushed.
+    /// @param capacity Capacity of the staging buffer.
+    explicit OutputStream(Sink sink,
+                          size_t capacity = default_stream_buffer_size)
+        : sink_(std::move(sink)),
+          buffer_(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+          capacity_(capacity) {}
+
+    OutputStream(OutputStream const &) = delete;
+    OutputStream &operator=(OutputStream const &) = delete;
+
+    /// @brief Destructor (the remaining data is flushed, the errors are
+    ///        ignored, call flush to handle them).
+    ~OutputStream() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of bytes written to the stream (flushed or not).
+    size_t size() const { return measuring_ ? end_ : flushed_ + staged_; }
+
+    /// @brief Access to the sink.
+    Sink &sink() { return sink_; }
+
+    /* append *****************************************************************/
+
+    /// @brief Appends some bytes at the end of the stream. When the staging
+    ///        buffer is full, it is flushed. Large blocks are written to the
+    ///        sink directly.
+    /// @param pos     Position where the bytes are appended (should be size()).
+    /// @param bytes   Buffer of bytes to append.
+    /// @param nbBytes Number of bytes to append.
+    /// @throw std::logic_error when pos is not the end of the stream.
+    void append(size_t pos, std::byte const *bytes, size_t nbBytes) {
+        if (pos != size()) [[unlikely]] {
+            throw std::logic_error(
+                "error: the data can only be appended to a stream.");
+        }
+        if (measuring_) {
+            end_ += nbBytes;
+            return;
+        }
+        if (staged_ + nbBytes > capacity_) {
+            flush();
+            if (nbBytes >= capacity_) {
+                sink_.write(bytes, nbBytes);
+                flushed_ += nbBytes;
+                return;
+            }
+        }
+        std::memcpy(buffer_.get() + staged_, bytes, nbBytes);
+        staged_ += nbBytes;
+    }
+
+    /// @brief Write the content of the staging buffer to the sink.
+    void flush() {
+        if (staged_ > 0) {
+            sink_.write(buffer_.get(), staged_);
+            flushed_ += staged_;
+            staged_ = 0;
+        }
+    }
+
+    /* measure ****************************************************************/
+
+    /// @brief Run a function that appends data to the stream without writing
+    ///        anything (only the size of the stream changes while the function
+    ///        runs). This is used to compute the size of a value before
+    ///        serializing it.
+    /// @param fun Function that appends data to the stream.
+    /// @return Number of bytes appended by the function.
+    size_t measure(auto &&fun) {
+        size_t begin = size();
+        size_t end = end_;
+        bool measuring = std::exchange(measuring_, true);
+
+        end_ = begin;
+        fun();
+        size_t nbBytes = end_ - begin;
+        end_ = end;
+        measuring_ = measuring;
+        return nbBytes;
+    }
+
+  private:
+    Sink sink_;                           ///< destination of the data
+    std::unique_ptr<std::byte[]> buffer_; ///< staging buffer
+    size_t capacity_ = 0;                 ///< capacity of the staging buffer
+    size_t staged_ = 0;                   ///< number of bytes in the buffer
+    size_t flushed_ = 0;                  ///< number of bytes in the sink
+    size_t end_ = 0;                      ///< size of the stream (measure)
+    bool measuring_ = false;              ///< true when measuring
+};
+
+/// @brief Memory buffer type that only counts the number of bytes appended
+///        (used to compute the size of serialized data).
+class ByteCounter {
+  public:
+    using byte_type = std::byte;
+
+    /// @brief Number of bytes appended.
+    size_t size() const { return size_; }
+
+    /// @brief Count the appended bytes (nothing is stored).
+    void append(size_t pos, std::byte const *, size_t nbBytes) {
+        size_ = pos + nbBytes;
+    }
+
+    /// @brief Run a function and return the number of bytes it appended.
+    size_t measure(auto &&fun) {
+        size_t begin = size_;
+        fun();
+        size_t nbBytes = size_ - begin;
+        size_ = begin;
+        return nbBytes;
+    }
+
+  private:
+    size_t size_ = 0; ///< number of bytes appended
+};
+
+/* sources ********************************************************************/
+
+/// @brief Source that reads from a file descriptor.
+struct FdSource {
+    int fd; ///< file descriptor (not closed by the source)
+
+    /// @brief Read at most nbBytes (blocks until some data is available).
+    /// @return Number of bytes read (0 at the end of the file).
+    /// @throw std::system_error when the read fails.
+    size_t read(std::byte *bytes, size_t nbBytes) {
+        while (true) {
+            ssize_t count = ::read(fd, bytes, nbBytes);
+            if (count >= 0) [[likely]] {
+                return size_t(count);
+            }
+            if (errno != EINTR) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "error: cannot read from the fd.");
+            }
+        }
+    }
+};
+
+/// @brief Source that reads from a std::istream.
+struct IStreamSource {
+    std::istream &is; ///< input stream
+
+    /// @brief Read at most nbBytes.
+    /// @return Number of bytes read (0 at the end of the stream).
+    size_t read(std::byte *bytes, size_t nbBytes) {
+        is.read(reinterpret_cast<char *>(bytes), std::streamsize(nbBytes));
+        return size_t(is.gcount());
+    }
+};
+
+/* input stream ***************************************************************/
+
+/// @brief Memory buffer type that reads the serialized data from a source
+///        through a fixed size window, so the memory used does not depend on
+///        the size of the serialized data. The window is refilled when a value
+///        crosses its end, and large blocks are read directly into their
+///        destination. The positions can only move forward: the bytes before
+///        the last position read are dropped, and the bytes that are jumped
+///        over (ex: offset tables) are discarded. Successive values can be
+///        deserialized one after the other (the position of the next value is
+///        returned by deserialize).
+/// @tparam Source Type of the source (see FdSource and IStreamSource).
+template <typename Source> class InputStream {
+  public:
+    using byte_type = std::byte;
+
+    /* constructors ***********************************************************/
+
+    /// @brief Constructor from a source.
+    /// @param source Source from which the data is read.
+    /// @param capacity Capacity of the window.
+    explicit InputStream(Source source,
+                         size_t capacity = default_stream_buffer_size)
+        : source_(std::move(source)),
+          window_(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+          capacity_(capacity) {}
+
+    InputStream(InputStream const &) = delete;
+    InputStream &operator=(InputStream const &) = delete;
+
+    /* accessors **************************************************************/
+
+    /// @brief Position of the first byte of the window in the stream.
+    size_t position() const { return begin_; }
+
+    /// @brief Access to the source.
+    Source &source() { return source_; }
+
+    /* read *******************************************************************/
+
+    /// @brief Copy nbBytes from the stream at pos into bytes. The bytes before
+    ///        pos are dropped.
+    /// @param pos Position of the data in the stream.
+    /// @param bytes Destination buffer.
+    /// @param nbBytes Number of bytes to read.
+    /// @throw std::logic_error when pos has already been dropped.
+    /// @throw std::out_of_range when the end of the source is reached.
+    void read(size_t pos, void *bytes, size_t nbBytes) const {
+        auto dst = static_cast<std::byte *>(bytes);
+
+        seek(pos);
+        size_t count = std::min(nbBytes, size_);
+        std::memcpy(dst, window_.get() + offset_, count);
+        drop(count);
+        dst += count;
+        nbBytes -= count;
+        if (nbBytes == 0) {
+            return;
+        }
+        if (nbBytes >= capacity_) {
+            // large blocks are read without going through the window
+            fill(dst, nbBytes);
+            begin_ += nbBytes;
+        } else {
+            refill(nbBytes);
+            std::memcpy(dst, window_.get(), nbBytes);
+            drop(nbBytes);
+        }
+    }
+
+    /// @brief Copy nbBytes from the stream at pos into bytes without dropping
+    ///        them (they can be read again).
+    /// @param pos Position of the data in the stream.
+    /// @param bytes Destination buffer.
+    /// @param nbBytes Number of bytes to read (smaller than the capacity).
+    void peek(size_t pos, void *bytes, size_t nbBytes) const {
+        if (nbBytes > capacity_) [[unlikely]] {
+            throw std::length_error("error: peek larger than the window.");
+        }
+        seek(pos);
+        if (size_ < nbBytes) {
+            refill(nbBytes);
+        }
+        std::memcpy(bytes, window_.get() + offset_, nbBytes);
+    }
+
+  private:
+    // the deserialize functions take the buffer by const reference, reading
+    // only changes the window
+    mutable Source source_;               ///< origin of the data
+    std::unique_ptr<std::byte[]> window_; ///< window
+    size_t capacity_ = 0;                 ///< capacity of the window
+    mutable size_t offset_ = 0;           ///< offset of the first valid byte
+    mutable size_t size_ = 0;             ///< number of valid bytes
+    mutable size_t begin_ = 0;            ///< position of the valid bytes
+
+    /// @brief Drop the bytes before pos (the data between the end of the
+    ///        window and pos is discarded).
+    void seek(size_t pos) const {
+        if (pos < begin_) [[unlikely]] {
+            throw std::logic_error(
+                "error: the data can only be read forward in a stream.");
+        }
+        if (pos - begin_ <= size_) {
+            drop(pos - begin_);
+            return;
+        }
+        size_t skipped = pos - begin_ - size_;
+        drop(size_);
+        while (skipped > 0) {
+            size_t count = std::min(skipped, capacity_);
+            fill(window_.get(), count);
+            skipped -= count;
+        }
+        begin_ = pos;
+    }
+
+    /// @brief Drop count valid bytes.
+    void drop(size_t count) const {
+        offset_ += count;
+        size_ -= count;
+        begin_ += count;
+    }
+
+    /// @brief Move the valid bytes at the beginning of the window and read
+    ///        from the source until at least nbBytes are valid.
+    void refill(size_t nbBytes) const {
+        std::memmove(window_.get(), window_.get() + offset_, size_);
+        offset_ = 0;
+        while (size_ < nbBytes) {
+            size_t count =
+                source_.read(window_.get() + size_, capacity_ - size_);
+            if (count == 0) [[unlikely]] {
+                throw std::out_of_range("error: unexpected end of stream.");
+            }
+            size_ += count;
+        }
+    }
+
+    /// @brief Read exactly nbBytes from the source into bytes.
+    void fill(std::byte *bytes, size_t nbBytes) const {
+        while (nbBytes > 0) {
+            size_t count = source_.read(bytes, nbBytes);
+            if (count == 0) [[unlikely]] {
+                throw std::out_of_range("error: unexpected end of stream.");
+            }
+            bytes += count;
+            nbBytes -= count;
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef SERIALIZER_THREAD_POOL_HPP
+#define SERIALIZER_THREAD_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/******************************************************************************/
+/*                                thread pool                                 */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Pool of threads used by the parallel (de)serialization. The pool
+///        runs one parallel loop at a time: the iterations are distributed
+///        dynamically (atomic counter) between the workers and the calling
+///        thread. A loop started from a worker runs sequentially on the worker
+///        (nested parallel containers).
+class ThreadPool {
+  public:
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor.
+    /// @param nbThreads Number of threads that run the loops (the calling
+    ///                  thread is one of them).
+    explicit ThreadPool(size_t nbThreads = std::thread::hardware_concurrency())
+        : nbThreads_(std::max(nbThreads, size_t(1))) {
+        for (size_t i = 1; i < nbThreads_; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    /// @brief Destructor (stop and join the workers).
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of threads that run the loops (including the calling
+    ///        thread).
+    size_t size() const { return nbThreads_; }
+
+    /// @brief True when called from a worker of a pool.
+    static bool inWorker() { return worker_; }
+
+    /* loops ******************************************************************/
+
+    /// @brief Run fun(i) for i in [0, nbTasks) and wait for the end of the
+    ///        loop.
+    /// @param nbTasks Number of iterations.
+    /// @param fun Function called for each iteration.
+    /// @throw The first exception thrown by fun (the other iterations still
+    ///        run).
+    void parallelFor(size_t nbTasks, std::function<void(size_t)> fun) {
+        if (nbTasks == 0) {
+            return;
+        }
+        if (workers_.empty() || nbTasks == 1 || worker_) {
+            for (size_t i = 0; i < nbTasks; ++i) {
+                fun(i);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> loopLock(loopMutex_);
+        auto job = std::make_shared<Job>(std::move(fun), nbTasks);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = job;
+            ++generation_;
+        }
+        start_.notify_all();
+        run(*job);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [&] { return job->done == job->nbTasks; });
+            job_ = nullptr;
+        }
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+  private:
+    /// @brief Parallel loop.
+    struct Job {
+        Job(std::function<void(size_t)> fun, size_t nbTasks)
+            : fun(std::move(fun)), nbTasks(nbTasks) {}
+
+        std::function<void(size_t)> fun; ///< loop body
+        size_t nbTasks = 0;              ///< number of iterations
+        std::atomic<size_t> next = 0;    ///< next iteration
+        std::atomic<size_t> done = 0;    ///< completed iterations
+        std::exception_ptr error;        ///< first error
+        std::mutex errorMutex;           ///< protects error
+    };
+
+    size_t nbThreads_ = 1;             ///< number of threads
+    std::vector<std::thread> workers_; ///< workers
+    std::mutex loopMutex_;             ///< one loop at a time
+    std::mutex mutex_;                 ///< protects the job
+    std::condition_variable start_;    ///< new job or stop
+    std::condition_variable done_;     ///< end of the job
+    std::shared_ptr<Job> job_;         ///< current job
+    size_t generation_ = 0;            ///< number of jobs started
+    bool stop_ = false;                ///< destruction of the pool
+    static inline thread_local bool worker_ = false; ///< true in workers
+
+    /// @brief Run the iterations of a job until there are none left.
+    void run(Job &job) {
+        size_t count = 0;
+
+        for (size_t i = job.next++; i < job.nbTasks; i = job.next++) {
+            try {
+                job.fun(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job.errorMutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+            }
+            ++count;
+        }
+        if (count > 0 && (job.done += count) == job.nbTasks) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_.notify_all();
+        }
+    }
+
+    /// @brief Loop of the workers.
+    void work() {
+        size_t generation = 0;
+
+        worker_ = true;
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock,
+                            [&] { return stop_ || generation_ != generation; });
+                if (stop_) {
+                    return;
+                }
+                generation = generation_;
+                job = job_;
+            }
+            if (job) {
+                run(*job);
+            }
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
@@ -32,6 +32,19 @@ inline constexpr void insert(Container &&container, T &&element) {
     container.push_back(element);
 }
 
+/// @brief Insert an element at the end of an iterable using the insert member
+///        function with the end() hint (constant time for the sorted
+///        containers when the elements are inserted in order).
+/// @tparam Container Container type.
+/// @tparam T Type of the lement to insert.
+/// @param container
+/// @param element element to insert in the container.
+template <typename Container, typename T>
+    requires serializer::concepts::HintInsertable<Container, T>
+inline constexpr void insertBack(Container &&container, T &&element) {
+    container.insert(container.end(), std::forward<T>(element));
+}
+
 /// @brief Insert an element into an iterable using the operator[].
 /// @tparam Container Container type.
 /// @tparam T Type of the lement to insert.
@@ -98,6 +111,15 @@ T tupleProd(std::tuple<Types...> const &tuple) {
 /*                         deserialize with accessors                         */
 /******************************************************************************/
 
+/// @brief Associate the index of a member in the SERIALIZE list with an
+///        accessor (used for deserializing a subset of the members).
+/// @tparam Idx Index of the member.
+/// @tparam Accessor Type of the accessor.
+template <size_t Idx, typename Accessor> struct Field {
+    static constexpr size_t index = Idx; ///< index of the member
+    Accessor accessor;                   ///< accessor for the attribute
+};
+
 /// @brief Deserialize the attribute accessible with `accessor`.
 /// @tparam Ser Serializer
 /// @tparam T Type of the accessor
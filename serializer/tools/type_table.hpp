@@ -8,6 +8,9 @@
 #include "serializer/exceptions/create_type.hpp"
 #include <stdexcept>
 #include <type_traits>
+#ifdef SERIALIZER_ALLOC_STATS
+#include "alloc_stats.hpp"
+#endif
 
 /******************************************************************************/
 /*                                 type table                                 */
@@ -97,6 +100,14 @@ template <typename T> inline constexpr void create(auto &elt) {
         } else {
             throw exceptions::CreateTypeError<T>();
         }
+#ifdef SERIALIZER_ALLOC_STATS
+        if constexpr (concepts::Pointer<Type> || mtf::is_shared_v<Type> ||
+                      mtf::is_unique_v<Type>) {
+            if (!std::is_constant_evaluated()) {
+                countCreate<T>();
+            }
+        }
+#endif
     } else {
         throw exceptions::AbstractTypeError<T>();
     }
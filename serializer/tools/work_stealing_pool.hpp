@@ -0,0 +1,220 @@
+#ifndef SERIALIZER_WORK_STEALING_POOL_HPP
+#define SERIALIZER_WORK_STEALING_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+/*                             work stealing pool                             */
+/******************************************************************************/
+
+/// @brief namespace serializer tools
+namespace serializer::tools {
+
+/// @brief Pool of threads that run independent tasks. Each worker has its own
+///        queue: the tasks submitted by a worker are pushed to its queue and
+///        run in LIFO order (locality), the tasks submitted by other threads
+///        are distributed between the queues, and the idle workers steal the
+///        oldest tasks of the other queues. The thread that waits for the end
+///        of the tasks runs tasks too.
+class WorkStealingPool {
+  public:
+    /* constructors & destructor **********************************************/
+
+    /// @brief Constructor.
+    /// @param nbThreads Number of threads that run the tasks (the thread that
+    ///                  calls wait is one of them).
+    explicit WorkStealingPool(
+        size_t nbThreads = std::thread::hardware_concurrency())
+        : nbThreads_(std::max(nbThreads, size_t(1))) {
+        for (size_t i = 0; i < nbThreads_; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        // the last queue is the one of the waiting thread
+        for (size_t i = 0; i + 1 < nbThreads_; ++i) {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    WorkStealingPool(WorkStealingPool const &) = delete;
+    WorkStealingPool &operator=(WorkStealingPool const &) = delete;
+
+    /// @brief Destructor (the remaining tasks are run, then the workers are
+    ///        joined).
+    ~WorkStealingPool() {
+        try {
+            wait();
+        } catch (...) {
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /* accessors **************************************************************/
+
+    /// @brief Number of threads that run the tasks.
+    size_t size() const { return nbThreads_; }
+
+    /// @brief Number of tasks submitted that are not complete.
+    size_t pending() const { return pending_; }
+
+    /* tasks ******************************************************************/
+
+    /// @brief Add a task to the pool.
+    /// @param task Task (the exceptions are forwarded to wait).
+    void submit(std::function<void()> task) {
+        size_t idx = current_.pool == this
+                         ? current_.queue
+                         : next_++ % queues_.size();
+        ++pending_;
+        // counted first, so queued_ is never lower than the number of tasks in
+        // the queues
+        ++queued_;
+        {
+            std::lock_guard<std::mutex> lock(queues_[idx]->mutex);
+            queues_[idx]->tasks.push_back(std::move(task));
+        }
+        if (sleeping_ > 0) {
+            wakeUp(true);
+        }
+    }
+
+    /// @brief Run tasks until all the submitted tasks are complete.
+    /// @throw The first exception thrown by a task since the last wait.
+    void wait() {
+        Current current = std::exchange(current_, {this, queues_.size() - 1});
+        while (pending_ > 0) {
+            if (!runOne(queues_.size() - 1)) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ++sleeping_;
+                done_.wait(lock, [&] { return pending_ == 0 || queued_ > 0; });
+                --sleeping_;
+            }
+        }
+        current_ = current;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+  private:
+    /// @brief Queue of tasks of a thread.
+    struct Queue {
+        std::mutex mutex;                        ///< protects the tasks
+        std::deque<std::function<void()>> tasks; ///< tasks
+    };
+
+    /// @brief Queue used by the current thread (zero initialized).
+    struct Current {
+        WorkStealingPool *pool; ///< pool of the thread
+        size_t queue;           ///< queue of the thread
+    };
+
+    size_t nbThreads_ = 1;                       ///< number of threads
+    std::vector<std::unique_ptr<Queue>> queues_; ///< one queue per thread
+    std::vector<std::thread> workers_;           ///< workers
+    std::atomic<size_t> pending_ = 0;            ///< tasks not complete
+    std::atomic<size_t> next_ = 0;               ///< queue of the next task
+    std::mutex mutex_;                           ///< sleep, wake and error
+    std::condition_variable wake_;               ///< new task or stop
+    std::condition_variable done_;               ///< task complete
+    std::atomic<size_t> queued_ = 0;             ///< tasks in the queues
+    std::atomic<size_t> sleeping_ = 0;           ///< threads that may sleep
+    bool stop_ = false;                          ///< destruction
+    std::exception_ptr error_;                   ///< first error
+    static inline thread_local Current current_; ///< queue of the thread
+
+    /// @brief Take a task from the queue idx (newest) or steal one from the
+    ///        other queues (oldest).
+    bool take(size_t idx, std::function<void()> &task) {
+        for (size_t i = 0; i < queues_.size(); ++i) {
+            Queue &queue = *queues_[(idx + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Run one task.
+    /// @return False when there was no task to run.
+    bool runOne(size_t idx) {
+        std::function<void()> task;
+
+        if (!take(idx, task)) {
+            return false;
+        }
+        --queued_;
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        if (--pending_ == 0 && sleeping_ > 0) {
+            wakeUp(false);
+        }
+        return true;
+    }
+
+    /// @brief Wake the sleeping threads. The sleeping threads increment
+    ///        sleeping_ and check the counters while holding the mutex, so
+    ///        taking the mutex before notifying cannot lose a wake up, and the
+    ///        threads that did not increment sleeping_ yet will see the new
+    ///        counters.
+    /// @param task True when a task was submitted (a worker is woken up).
+    void wakeUp(bool task) {
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        if (task) {
+            wake_.notify_one();
+        }
+        done_.notify_all();
+    }
+
+    /// @brief Loop of the workers.
+    void work(size_t idx) {
+        current_ = {this, idx};
+        while (true) {
+            if (runOne(idx)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++sleeping_;
+            wake_.wait(lock, [&] { return stop_ || queued_ > 0; });
+            --sleeping_;
+            if (stop_) {
+                return;
+            }
+        }
+    }
+};
+
+} // end namespace serializer::tools
+
+#endif
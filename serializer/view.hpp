@@ -0,0 +1,220 @@
+#ifndef SERIALIZER_VIEW_H
+#define SERIALIZER_VIEW_H
+#include "meta/members.hpp"
+#include "serialize.hpp"
+#include "skip.hpp"
+#include "tools/bytes.hpp"
+#include "tools/indexed.hpp"
+#include <bit>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/// @brief serializer namespace
+namespace serializer {
+
+/// @brief Read only access to the members of an object serialized with the
+///        offset table layout (SERIALIZE_TABLE). Each member is deserialized
+///        directly from the buffer without reading the other ones, so only the
+///        accessed members are materialized.
+/// @tparam T Type of the serialized object.
+/// @tparam MemT Type of the memory buffer.
+/// @tparam Ser Serializer used to deserialize the members.
+template <typename T, typename MemT = tools::Bytes<std::byte>,
+          typename Ser = Serializer<MemT const>>
+class View {
+  public:
+    static_assert(mtf::has_table_v<T, MemT>,
+                  "error: the type should be serialized with SERIALIZE_TABLE.");
+
+    using members_type = mtf::members_t<T, MemT>; ///< id and members
+
+    /// @brief Number of members in the table.
+    static constexpr size_t size = mtf::table_size_v<T, MemT>;
+
+    /// @brief Type of the member `Idx` (excluding the id).
+    template <size_t Idx>
+    using member_type = std::remove_cvref_t<std::tuple_element_t<
+        Idx + std::tuple_size_v<members_type> - size, members_type>>;
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from memory buffer reference and position.
+    /// @param mem Memory buffer that contains the serialized object.
+    /// @param pos Position of the object in the memory buffer.
+    constexpr View(MemT const &mem, size_t pos = 0)
+        : mem_(mem), tablePos_(pos) {
+        if constexpr (std::tuple_size_v<members_type> != size) {
+            // the id is serialized before the table
+            using id_type = std::tuple_element_t<0, members_type>;
+            tablePos_ += sizeof(id_type);
+        }
+    }
+
+    /* positions **************************************************************/
+
+    /// @brief Position of the member `Idx` in the memory buffer.
+    template <size_t Idx> constexpr size_t position() const {
+        static_assert(Idx < size, "error: member index out of range.");
+        if constexpr (Idx == 0) {
+            return tablePos_ + size * sizeof(size_t);
+        } else {
+            return tablePos_ + entry(Idx - 1);
+        }
+    }
+
+    /// @brief Position of the end of the object in the memory buffer.
+    constexpr size_t end() const {
+        if constexpr (size == 0) {
+            return tablePos_;
+        } else {
+            return tablePos_ + entry(size - 1);
+        }
+    }
+
+    /* access *****************************************************************/
+
+    /// @brief Deserialize the member `Idx` into `elt`.
+    /// @param elt Element that is deserialized.
+    /// @return Position of the end of the member in the buffer.
+    template <size_t Idx> constexpr size_t get(auto &&elt) const {
+        return deserialize<Ser>(mem_, position<Idx>(), elt);
+    }
+
+    /// @brief Deserialize and return the member `Idx`.
+    template <size_t Idx> constexpr member_type<Idx> get() const {
+        member_type<Idx> elt{};
+        get<Idx>(elt);
+        return elt;
+    }
+
+    /// @brief Create a view on the member `Idx` (the member should also use
+    ///        the offset table layout).
+    template <size_t Idx> constexpr auto view() const {
+        return View<member_type<Idx>, MemT, Ser>(mem_, position<Idx>());
+    }
+
+  private:
+    MemT const &mem_;     ///< memory buffer
+    size_t tablePos_ = 0; ///< position of the offset table
+
+    /// @brief Read the entry `idx` of the offset table.
+    constexpr size_t entry(size_t idx) const {
+        return readUnaligned_<size_t>(mem_, tablePos_ + idx * sizeof(size_t));
+    }
+};
+
+/// @brief Random access to the elements of a container serialized with an
+///        offset index (see tools::Indexed). The offsets of the elements are
+///        computed once at construction (prefix sum of the index), then any
+///        element or sub-range can be deserialized without reading the other
+///        elements. The accessors are const, so disjoint ranges can be
+///        deserialized concurrently.
+///        Note: containers smaller than their threshold have no index (see
+///        tools::index_present_flag), in that case the offsets are computed
+///        by skipping the elements.
+/// @tparam C Type of the serialized container.
+/// @tparam MemT Type of the memory buffer.
+/// @tparam Ser Serializer used to deserialize the elements.
+template <typename C, typename MemT = tools::Bytes<std::byte>,
+          typename Ser = Serializer<MemT const>>
+class IndexedView {
+  public:
+    using value_type = mtf::remove_const_t<mtf::iter_value_t<mtf::clean_t<C>>>;
+    using size_type = decltype(std::size(std::declval<C>()));
+
+    /* constructor ************************************************************/
+
+    /// @brief Constructor from memory buffer reference and position.
+    /// @param mem Memory buffer that contains the serialized container.
+    /// @param pos Position of the container in the memory buffer.
+    IndexedView(MemT const &mem, size_t pos = 0) : mem_(mem) {
+        size_ = readUnaligned_<size_type>(mem, pos);
+        pos += sizeof(size_type);
+        size_t nbBytes = readUnaligned_<size_t>(mem, pos);
+        begin_ = pos + sizeof(size_t);
+        end_ = begin_ + (nbBytes & ~tools::index_present_flag);
+        offsets_.resize(size_ + 1, 0);
+
+        if (nbBytes & tools::index_present_flag) {
+            // the index is not aligned in the buffer
+            for (size_t i = 0; i < size_; ++i) {
+                offsets_[i + 1] =
+                    offsets_[i] +
+                    readUnaligned_<tools::index_delta_type>(
+                        mem, end_ + i * sizeof(tools::index_delta_type));
+            }
+            end_ += size_ * sizeof(tools::index_delta_type);
+        } else {
+            for (size_t i = 0; i < size_; ++i) {
+                offsets_[i + 1] =
+                    skip<Ser, value_type>(mem, begin_ + offsets_[i]) - begin_;
+            }
+        }
+    }
+
+    /* positions **************************************************************/
+
+    /// @brief Number of elements in the container.
+    size_t size() const { return size_; }
+
+    /// @brief Position of the element `idx` in the memory buffer.
+    /// @throw std::out_of_range when idx is not a valid index.
+    size_t position(size_t idx) const {
+        if (idx >= size_) [[unlikely]] {
+            throw std::out_of_range("error: element index out of range.");
+        }
+        return begin_ + offsets_[idx];
+    }
+
+    /// @brief Position of the end of the container in the memory buffer.
+    size_t end() const { return end_; }
+
+    /* access *****************************************************************/
+
+    /// @brief Deserialize the element `idx` into `elt`.
+    /// @param idx Index of the element.
+    /// @param elt Element that is deserialized.
+    /// @return Position of the end of the element in the buffer.
+    size_t get(size_t idx, auto &&elt) const {
+        return deserialize<Ser>(mem_, position(idx), elt);
+    }
+
+    /// @brief Deserialize and return the element `idx`.
+    value_type get(size_t idx) const {
+        value_type elt{};
+        get(idx, elt);
+        return elt;
+    }
+
+    /// @brief Deserialize the elements in [first, last).
+    /// @param first Index of the first element.
+    /// @param last Index of the end of the range.
+    /// @param out Output iterator where the elements are stored.
+    /// @return Output iterator to the end of the range.
+    template <typename OutputIt>
+    OutputIt getRange(size_t first, size_t last, OutputIt out) const {
+        if (last > size_ || first > last) [[unlikely]] {
+            throw std::out_of_range("error: invalid element range.");
+        }
+        Ser serializer(mem_, begin_ + offsets_[first]);
+        for (size_t i = first; i < last; ++i) {
+            value_type elt{};
+            serializer.select_deserialize(elt);
+            *out++ = std::move(elt);
+        }
+        return out;
+    }
+
+  private:
+    MemT const &mem_;             ///< memory buffer
+    size_t size_ = 0;             ///< number of elements
+    size_t begin_ = 0;            ///< position of the first element
+    size_t end_ = 0;              ///< end of the serialized container
+    std::vector<size_t> offsets_; ///< offsets of the elements
+};
+
+} // end namespace serializer
+
+#endif
@@ -33,4 +33,14 @@ class CStructSerializable {
     double d_ = 0;
 };
 
+struct CStructRaw {
+    char c;
+    int i;
+    long l;
+    float f;
+    double d;
+
+    SERIALIZE_STRUCT()
+};
+
 #endif // SERIALIZER_CSTRUCT_H
@@ -1,3 +1,10 @@
+#ifndef HEDGEHOG_HPP
+#define HEDGEHOG_HPP
+#include <mutex>
+#include <serializer/dispatch.hpp>
+#include <serializer/tools/bytes_pool.hpp>
+#include <serializer/io/pipelined_sender.hpp>
+#include <serializer/io/unix_socket.hpp>
 #include <serializer/serializer.hpp>
 #include <serializer/tools/macros.hpp>
 
@@ -19,8 +26,8 @@ template <typename T, BlockId Id> class MatrixBlock;
 template <typename T>
 using TypeTable = serializer::tools::TypeTable<Matrix<T>, PartialSum<T>,
                                                MatrixBlock<T, Input>>;
-template <typename T>
-using HHSerializer = serializer::Serializer<serializer::Bytes, TypeTable<T>>;
+template <typename T, typename MemT = serializer::Bytes>
+using HHSerializer = serializer::Serializer<MemT, TypeTable<T>>;
 
 /******************************************************************************/
 /*                          matrix and matrix blocks                          */
@@ -67,8 +74,10 @@ template <typename T, BlockId Id> class MatrixBlock {
     /* SERIALIZE(serializer::tools::getId<MatrixBlock<T, Id>>(TypeTable<T>()), x_, */
     /*           y_, matrixWidth_, matrixHeight_, blockSize_, dataSize_, */
     /*           SER_DARR(data_, dataSize_)); */
-    SERIALIZE_CUSTOM(HHSerializer<T>, x_, y_, matrixWidth_, matrixHeight_,
-                   blockSize_, dataSize_, SER_DARR(data_, dataSize_));
+    template <typename MemT> using Serializer = HHSerializer<T, MemT>;
+    SERIALIZE_CUSTOM(Serializer<SER_MEMT>, x_, y_, matrixWidth_,
+                     matrixHeight_, blockSize_, dataSize_,
+                     SER_DARR(data_, dataSize_));
 
     size_t x() const { return x_; }
     size_t y() const { return y_; }
@@ -99,16 +108,80 @@ template <typename T> struct PartialSum {
 
 struct Network {
     static inline serializer::Bytes data;
-    static void send(serializer::Bytes mem) {
-        data.append(data.size(), mem.data(), mem.size());
+    static inline std::mutex mutex;
+    static void send(serializer::Bytes const &mem) {
+        send(mem.data(), mem.size());
+    }
+    static void send(std::byte const *bytes, size_t nbBytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        data.append(data.size(), bytes, nbBytes);
     }
     static serializer::Bytes rcv() {
+        std::lock_guard<std::mutex> lock(mutex);
         serializer::Bytes result = data;
         data.clear();
         return result;
     }
 };
 
+struct NetworkSink {
+    void write(std::byte const *bytes, size_t nbBytes) {
+        Network::send(bytes, nbBytes);
+    }
+};
+
+/******************************************************************************/
+/*                                 transports                                 */
+/******************************************************************************/
+
+// The transport used by the tasks to send their outputs is given as a template
+// parameter of the tasks.
+
+/// @brief Serialize the outputs into the network buffer.
+struct BufferTransport {
+    template <typename T> static void send(T const &elt) {
+        auto &pool = serializer::tools::SharedBytesPool<std::byte>::global();
+        serializer::Bytes mem = pool.acquire();
+
+        elt.serialize(mem);
+        Network::send(mem);
+        pool.release(std::move(mem));
+    }
+};
+
+/// @brief Serialize the outputs in frames into the network buffer (see
+///        FrameDispatcher).
+struct FrameTransport {
+    template <typename T> static void send(T const &elt) {
+        auto &pool = serializer::tools::SharedBytesPool<std::byte>::global();
+        serializer::Bytes mem = pool.acquire();
+
+        serializer::serializeFrame(mem, 0, 0, elt);
+        Network::send(mem);
+        pool.release(std::move(mem));
+    }
+};
+
+/// @brief Post the outputs to the frame sender of the process.
+struct SocketTransport {
+    static inline serializer::io::FrameSender *sender = nullptr;
+
+    template <typename T> static void send(T const &elt) {
+        sender->post(elt);
+    }
+};
+
+/// @brief Post the outputs to a pipelined sender that writes into the network
+///        buffer.
+struct PipelineTransport {
+    static inline serializer::io::PipelinedSender<NetworkSink> *sender =
+        nullptr;
+
+    template <typename T> static void send(T const &elt) {
+        sender->post(elt);
+    }
+};
+
 /******************************************************************************/
 /*                              abstract classes                              */
 /******************************************************************************/
@@ -119,28 +192,24 @@ template <typename... Outputs> struct Out {};
 
 template <typename T> struct Execute;
 template <typename T> struct Executes;
-template <typename T> struct Send;
-template <typename T> struct Sends;
+template <typename T, typename Transport = BufferTransport> struct Send;
+template <typename T, typename Transport> struct Sends;
 
 template <typename... Types>
 struct Executes<In<Types...>> : Execute<Types>... {};
 
-template <typename... Types> struct Sends<Out<Types...>> : Send<Types>... {};
+template <typename... Types, typename Transport>
+struct Sends<Out<Types...>, Transport> : Send<Types, Transport>... {};
 
-template <typename Input, typename Output>
-struct Task : Executes<Input>, Sends<Output> {};
+template <typename Input, typename Output, typename Transport>
+struct Task : Executes<Input>, Sends<Output, Transport> {};
 
 template <typename T> struct Execute {
     virtual void execute(std::shared_ptr<T>) = 0;
 };
 
-template <typename T> struct Send {
-    serializer::Bytes mem;
-
-    void send(std::shared_ptr<T> elt) {
-        elt->serialize(mem);
-        Network::send(mem);
-    }
+template <typename T, typename Transport> struct Send {
+    void send(std::shared_ptr<T> elt) { Transport::send(*elt); }
 };
 
 template <typename... Tasks> struct RunExecute {
@@ -178,22 +247,40 @@ struct TaskManager : RunExecute<Tasks...> {
         size_t pos = 0;
 
         while (pos < buff.size()) {
-            auto id = serializer::tools::getId<TypeTable>(buff, pos);
-            serializer::tools::applyId(id, TypeTable(), [&]<typename T>() {
-                auto v = std::make_shared<T>();
-                pos = v->deserialize(buff, pos);
-                this->runExecute(v);
-            });
+            pos = dispatch(buff, pos);
+        }
+    }
+
+    void receive(serializer::io::FrameReceiver &receiver) {
+        while (receiver.receive([&](auto &buff, serializer::Frame frame) {
+            dispatch(buff, frame.pos);
+        })) {
         }
     }
+
+    void receive(serializer::FrameDispatcher<TypeTable> &dispatcher,
+                 serializer::Bytes buff) {
+        dispatcher.dispatch(buff, [this](auto v) { this->runExecute(v); });
+    }
+
+    size_t dispatch(auto &buff, size_t pos) {
+        auto id = serializer::tools::getId<TypeTable>(buff, pos);
+        serializer::tools::applyId(id, TypeTable(), [&]<typename T>() {
+            auto v = std::make_shared<T>();
+            pos = v->deserialize(buff, pos);
+            this->runExecute(v);
+        });
+        return pos;
+    }
 };
 
 /******************************************************************************/
 /*                                   tasks                                    */
 /******************************************************************************/
 
-template <typename T>
-struct SplitTask : Task<In<Matrix<T>>, Out<MatrixBlock<T, Input>>> {
+template <typename T, typename Transport = BufferTransport>
+struct SplitTask
+    : Task<In<Matrix<T>>, Out<MatrixBlock<T, Input>>, Transport> {
     void execute(std::shared_ptr<Matrix<T>> matrix) override {
         for (size_t i = 0; i < matrix->nbRawBlocks(); ++i) {
             for (size_t j = 0; j < matrix->nbColBlocks(); ++j) {
@@ -210,8 +297,9 @@ struct SplitTask : Task<In<Matrix<T>>, Out<MatrixBlock<T, Input>>> {
     }
 };
 
-template <typename T>
-struct ComputeTask : Task<In<MatrixBlock<T, Input>>, Out<PartialSum<T>>> {
+template <typename T, typename Transport = BufferTransport>
+struct ComputeTask
+    : Task<In<MatrixBlock<T, Input>>, Out<PartialSum<T>>, Transport> {
     void execute(std::shared_ptr<MatrixBlock<T, Input>> block) override {
         size_t jend =
             std::min(block->matrixWidth(), block->x() + block->blockSize());
@@ -233,9 +321,14 @@ struct ComputeTask : Task<In<MatrixBlock<T, Input>>, Out<PartialSum<T>>> {
     }
 };
 
-template <typename T> struct ResultTask : Task<In<PartialSum<T>>, Out<>> {
+template <typename T>
+struct ResultTask : Task<In<PartialSum<T>>, Out<>, BufferTransport> {
     void execute(std::shared_ptr<PartialSum<T>> ps) override {
+        std::lock_guard<std::mutex> lock(mutex);
         result += ps->value;
     }
     size_t result = 0;
+    std::mutex mutex;
 };
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef THROWING_HPP
+#define THROWING_HPP
+#include "test-classes/simple.hpp"
+#include <serializer/tools/stream.hpp>
+#include <stdexcept>
+#include <type_traits>
+
+/// @brief Record which serialization throws (it can only be measured).
+struct ThrowingRecord {
+    size_t serialize(auto &mem, size_t pos = 0) const {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(mem)>,
+                                     serializer::tools::ByteCounter>) {
+            return Simple(0, 0, "throwing").serialize(mem, pos);
+        } else {
+            throw std::runtime_error("error: serialization failed.");
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef WITHCHUNKED_HPP
+#define WITHCHUNKED_HPP
+#include "test-classes/composed.hpp"
+#include <serializer/serializer.hpp>
+#include <serializer/tools/macros.hpp>
+#include <serializer/tools/parallel.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+class WithChunked {
+  public:
+    explicit WithChunked(serializer::tools::ThreadPool &pool) : pool_(&pool) {}
+
+    SERIALIZE(serializer::tools::chunked(strings_, *pool_, 4),
+              serializer::tools::chunked(list_, *pool_, 8),
+              serializer::tools::parallel(composed_, *pool_, 4), last_);
+
+    /* accessors **************************************************************/
+    [[nodiscard]] std::vector<std::string> &strings() { return strings_; }
+    [[nodiscard]] std::list<int> &list() { return list_; }
+    [[nodiscard]] std::vector<Composed> &composed() { return composed_; }
+    [[nodiscard]] int last() const { return last_; }
+    void setLast(int last) { last_ = last; }
+
+  private:
+    serializer::tools::ThreadPool *pool_ = nullptr;
+    std::vector<std::string> strings_;
+    std::list<int> list_;
+    std::vector<Composed> composed_;
+    int last_ = 0;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef WITHINDEXED_HPP
+#define WITHINDEXED_HPP
+#include "test-classes/composed.hpp"
+#include <serializer/serializer.hpp>
+#include <serializer/tools/macros.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+class WithIndexed {
+  public:
+    SERIALIZE(SER_INDEXED(strings_), SER_INDEXED(composed_),
+              SER_INDEXED(map_), serializer::tools::indexed<2>(small_));
+
+    /* accessors **************************************************************/
+    [[nodiscard]] std::vector<std::string> &strings() { return strings_; }
+    [[nodiscard]] std::vector<Composed> &composed() { return composed_; }
+    [[nodiscard]] std::map<int, std::string> &map() { return map_; }
+    [[nodiscard]] std::vector<std::string> &small() { return small_; }
+
+  private:
+    std::vector<std::string> strings_;
+    std::vector<Composed> composed_;
+    std::map<int, std::string> map_;
+    std::vector<std::string> small_;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef WITHTABLE_HPP
+#define WITHTABLE_HPP
+#include "test-classes/simple.hpp"
+#include <serializer/serializer.hpp>
+#include <serializer/tools/macros.hpp>
+#include <string>
+#include <vector>
+
+class WithTable;
+using TableSerializer =
+    serializer::Serializer<serializer::Bytes,
+                           serializer::tools::TypeTable<WithTable>>;
+
+class Header {
+  public:
+    explicit Header(int id = 0, std::string topic = "")
+        : id_(id), topic_(std::move(topic)) {}
+
+    SERIALIZE_TABLE(id_, topic_);
+
+    /* accessors **************************************************************/
+    [[nodiscard]] int id() const { return id_; }
+    [[nodiscard]] std::string const &topic() const { return topic_; }
+    void setId(int id) { id_ = id; }
+    void setTopic(std::string topic) { topic_ = std::move(topic); }
+
+  private:
+    int id_;
+    std::string topic_;
+};
+
+class WithTable {
+  public:
+    WithTable() = default;
+    WithTable(Header header, std::vector<double> values, Simple simple,
+              long flags)
+        : header_(std::move(header)), values_(std::move(values)),
+          simple_(std::move(simple)), flags_(flags) {}
+
+    SERIALIZE_TABLE_CUSTOM(TableSerializer, header_, values_, simple_, flags_);
+
+    /* accessors **************************************************************/
+    [[nodiscard]] Header const &header() const { return header_; }
+    [[nodiscard]] std::vector<double> const &values() const { return values_; }
+    [[nodiscard]] Simple const &simple() const { return simple_; }
+    [[nodiscard]] long flags() const { return flags_; }
+
+  private:
+    Header header_;
+    std::vector<double> values_;
+    Simple simple_;
+    long flags_ = 0;
+};
+
+#endif
@@ -25,6 +25,28 @@
 #define TEST_DYNAMIC_ARRAYS
 #define TEST_TREE
 #define TEST_HH
+#define TEST_FIXED_SIZE
+#define TEST_VIEW
+#define TEST_INDEXED
+#define TEST_SKIP
+#define TEST_PROJECTION
+#define TEST_ACCESS
+#define TEST_STREAM
+#define TEST_FRAME
+#define TEST_ASYNC_FILE
+#define TEST_COROUTINE
+#define TEST_RECORD_LOG
+#define TEST_SHM_RING
+#define TEST_UNIX_SOCKET
+#define TEST_CHECKPOINT
+#define TEST_PARALLEL
+#define TEST_CHUNKED
+#define TEST_DISPATCH
+#define TEST_SHARED_BYTES_POOL
+#define TEST_BATCH_BUFFER
+#define TEST_PIPELINED_SENDER
+#define TEST_ALLOC_STATS
+#define TEST_SERIALIZER_STATS
 
 /******************************************************************************/
 /*                         tests with a simple class                          */
@@ -1061,3 +1083,2255 @@ TEST_CASE("hedgehog") {
     delete[] data;
 }
 #endif
+
+/******************************************************************************/
+/*                                 fixed size                                 */
+/******************************************************************************/
+
+#ifdef TEST_FIXED_SIZE
+#include "test-classes/composed.hpp"
+#include "test-classes/cstruct.h"
+#include "test-classes/withstaticarrays.hpp"
+TEST_CASE("fixed size") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    using serializer::mtf::dynamic_size;
+    using serializer::mtf::fixed_serialized_size_v;
+    std::vector<CStructSerializable> origin;
+    std::vector<CStructSerializable> other;
+    CStructSerializable elt;
+    serializer::Bytes result;
+
+    static_assert(fixed_serialized_size_v<int, Ser> == sizeof(int));
+    static_assert(fixed_serialized_size_v<CStructSerializable, Ser> ==
+                  sizeof(char) + sizeof(int) + sizeof(long) + sizeof(float) +
+                      sizeof(double));
+    static_assert(fixed_serialized_size_v<std::pair<int, double>, Ser> ==
+                  sizeof(int) + sizeof(double));
+    static_assert(fixed_serialized_size_v<CStructSerializable[3], Ser> ==
+                  3 * fixed_serialized_size_v<CStructSerializable, Ser>);
+    static_assert(fixed_serialized_size_v<std::array<int, 4>, Ser> ==
+                  sizeof(size_t) + 4 * sizeof(int));
+    static_assert(fixed_serialized_size_v<Simple, Ser> == dynamic_size);
+    static_assert(fixed_serialized_size_v<Composed, Ser> == dynamic_size);
+    static_assert(fixed_serialized_size_v<std::vector<int>, Ser> ==
+                  dynamic_size);
+    static_assert(fixed_serialized_size_v<WithStaticArrays, Ser> ==
+                  dynamic_size);
+    static_assert(fixed_serialized_size_v<int *, Ser> == dynamic_size);
+    static_assert(
+        fixed_serialized_size_v<decltype(SER_FUN({})), Ser> == dynamic_size);
+
+    for (int i = 0; i < 100; ++i) {
+        origin.emplace_back('a' + i % 26, i, 2 * i, i / 2.0, i / 4.0);
+    }
+
+    size_t end = serializer::serialize<Ser>(result, 0, origin);
+    REQUIRE(end == sizeof(size_t) +
+                       100 * fixed_serialized_size_v<CStructSerializable, Ser>);
+    serializer::deserialize<Ser>(result, 0, other);
+
+    REQUIRE(other.size() == origin.size());
+    for (size_t i = 0; i < origin.size(); ++i) {
+        REQUIRE(other[i].c() == origin[i].c());
+        REQUIRE(other[i].i() == origin[i].i());
+        REQUIRE(other[i].l() == origin[i].l());
+        REQUIRE(other[i].f() == origin[i].f());
+        REQUIRE(other[i].d() == origin[i].d());
+    }
+
+    // random access to the serialized elements
+    serializer::deserializeElement<Ser, decltype(origin)>(result, 0, 42, elt);
+    REQUIRE(elt.i() == origin[42].i());
+    REQUIRE(elt.l() == origin[42].l());
+    serializer::deserializeElement<Ser, decltype(origin)>(result, 0, 99, elt);
+    REQUIRE(elt.i() == origin[99].i());
+    REQUIRE_THROWS_AS((serializer::deserializeElement<Ser, decltype(origin)>(
+                          result, 0, 100, elt)),
+                      std::out_of_range);
+}
+#endif
+
+/******************************************************************************/
+/*                                    view                                    */
+/******************************************************************************/
+
+#ifdef TEST_VIEW
+#include "test-classes/withtable.hpp"
+TEST_CASE("view") {
+    WithTable origin(Header(3, "topic"), {1.0, 2.0, 3.0},
+                     Simple(4, 5, "simple"), 42);
+    WithTable other;
+    serializer::Bytes result;
+
+    size_t end = origin.serialize(result);
+    REQUIRE(end == result.size());
+
+    // full deserialization
+    REQUIRE(other.deserialize(result) == end);
+    REQUIRE(other.header().id() == origin.header().id());
+    REQUIRE(other.header().topic() == origin.header().topic());
+    REQUIRE(other.values() == origin.values());
+    REQUIRE(other.simple() == origin.simple());
+    REQUIRE(other.flags() == origin.flags());
+
+    // id of the type table
+    REQUIRE(serializer::tools::getId<TableSerializer::type_table>(result) ==
+            0);
+
+    // access to single members
+    serializer::View<WithTable> view(result);
+    static_assert(view.size == 4);
+    REQUIRE(view.end() == end);
+    REQUIRE(view.get<3>() == origin.flags());
+    REQUIRE(view.get<1>() == origin.values());
+    REQUIRE(view.get<2>() == origin.simple());
+    REQUIRE(view.view<0>().get<1>() == origin.header().topic());
+    REQUIRE(view.view<0>().get<0>() == origin.header().id());
+
+    long flags = 0;
+    REQUIRE(view.get<3>(flags) == end);
+    REQUIRE(flags == origin.flags());
+
+    // view inside a container
+    std::vector<Header> headers = {Header(1, "a"), Header(2, "bb")};
+    serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, 0, headers);
+    serializer::View<Header> first(result, sizeof(size_t));
+    serializer::View<Header> second(result, first.end());
+    REQUIRE(first.get<1>() == "a");
+    REQUIRE(second.get<0>() == 2);
+    REQUIRE(second.get<1>() == "bb");
+    REQUIRE(second.end() == result.size());
+}
+#endif
+
+/******************************************************************************/
+/*                                  indexed                                   */
+/******************************************************************************/
+
+#ifdef TEST_INDEXED
+#include "test-classes/withindexed.hpp"
+#include <cstring>
+TEST_CASE("indexed containers") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    WithIndexed origin;
+    WithIndexed other;
+    serializer::Bytes result;
+
+    for (int i = 0; i < 200; ++i) {
+        origin.strings().push_back(std::string(i % 17, 'a' + i % 26));
+    }
+    for (int i = 0; i < 10; ++i) {
+        origin.composed().emplace_back(Simple(i, 2 * i, std::to_string(i)), i,
+                                       i / 2.0);
+    }
+    for (int i = 0; i < 100; ++i) {
+        origin.map().insert({i, std::to_string(i * i)});
+    }
+    origin.small() = {"one", "two", "three"};
+
+    size_t end = origin.serialize(result);
+    REQUIRE(other.deserialize(result) == end);
+    REQUIRE(other.strings() == origin.strings());
+    REQUIRE(other.composed() == origin.composed());
+    REQUIRE(other.map() == origin.map());
+    REQUIRE(other.small() == origin.small());
+
+    // random access
+    serializer::IndexedView<std::vector<std::string>> strings(result);
+    REQUIRE(strings.size() == 200);
+    REQUIRE(strings.get(0) == origin.strings()[0]);
+    REQUIRE(strings.get(123) == origin.strings()[123]);
+    REQUIRE(strings.get(199) == origin.strings()[199]);
+    REQUIRE_THROWS_AS(strings.get(200), std::out_of_range);
+
+    // not indexed (smaller than the threshold)
+    serializer::IndexedView<std::vector<Composed>> composed(result,
+                                                             strings.end());
+    REQUIRE(composed.size() == 10);
+    REQUIRE(composed.get(7) == origin.composed()[7]);
+
+    // sub-range
+    serializer::IndexedView<std::map<int, std::string>> map(result,
+                                                            composed.end());
+    std::vector<std::pair<int, std::string>> range;
+    map.getRange(40, 45, std::back_inserter(range));
+    REQUIRE(range.size() == 5);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(range[i].first == 40 + i);
+        REQUIRE(range[i].second == origin.map()[40 + i]);
+    }
+
+    // custom threshold (the view does not need to know it)
+    serializer::IndexedView<std::vector<std::string>> small(result, map.end());
+    REQUIRE(small.get(2) == "three");
+    REQUIRE(small.end() == end);
+
+    // the reader threshold does not have to match the writer one
+    std::vector<std::string> strs = origin.small(), other3;
+    end = serializer::serialize<Ser>(result, 0,
+                                     serializer::tools::indexed<2>(strs));
+    REQUIRE(serializer::deserialize<Ser>(result, 0, SER_INDEXED(other3)) ==
+            end);
+    REQUIRE(other3 == strs);
+    end = serializer::serialize<Ser>(result, 0, SER_INDEXED(strs));
+    REQUIRE(serializer::deserialize<Ser>(
+                result, 0, serializer::tools::indexed<2>(other3)) == end);
+    REQUIRE(other3 == strs);
+
+    // corrupted number of bytes
+    size_t nbBytes = 1;
+    std::memcpy(result.data() + sizeof(size_t), &nbBytes, sizeof(nbBytes));
+    REQUIRE_THROWS_AS(serializer::deserialize<Ser>(result, 0,
+                                                   SER_INDEXED(other3)),
+                      std::out_of_range);
+
+    // the index does not change the other serialized types
+    strs = origin.strings();
+    size_t plainEnd = serializer::serialize<Ser>(result, 0, strs);
+    size_t indexedEnd =
+        serializer::serialize<Ser>(result, 0, SER_INDEXED(strs));
+    REQUIRE(indexedEnd == plainEnd + sizeof(size_t) +
+                              strs.size() *
+                                  sizeof(serializer::tools::index_delta_type));
+}
+#endif
+
+/******************************************************************************/
+/*                                    skip                                    */
+/******************************************************************************/
+
+#ifdef TEST_SKIP
+#include "test-classes/abstract.hpp"
+#include "test-classes/tree.hpp"
+#include "test-classes/withchunked.hpp"
+#include "test-classes/withcontainer.hpp"
+#include "test-classes/withfunctions.hpp"
+#include "test-classes/withindexed.hpp"
+#include "test-classes/withtable.hpp"
+TEST_CASE("skip") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    Tree<int> tree;
+    WithContainer container;
+    WithTable table(Header(1, "header"), {1, 2, 3}, Simple(1, 2, "s"), 3);
+    WithIndexed indexed;
+    serializer::tools::ThreadPool pool(2);
+    WithChunked chunked(pool);
+    AbstractCollection collection;
+    Composed composed(Simple(1, 2, "composed"), 3, 4);
+    Composed other;
+    serializer::Bytes result;
+    std::vector<size_t> positions;
+
+    for (auto elt : {5, 4, 8, 6, 1, 3, 7, 2, 9}) {
+        tree.insert(elt);
+    }
+    for (int i = 0; i < 10; ++i) {
+        container.addInt(i);
+        container.addDouble(i);
+        container.addSimple(Simple(i, i, "simple"));
+        container.addVec({i, i});
+        container.addArrPtr(i, nullptr);
+    }
+    for (int i = 0; i < 100; ++i) {
+        indexed.strings().push_back(std::to_string(i));
+    }
+    indexed.small() = {"a", "b"};
+    for (int i = 0; i < 30; ++i) {
+        chunked.strings().push_back(std::to_string(i));
+        chunked.list().push_back(i);
+        chunked.composed().emplace_back(Simple(i, i, "chunked"), i, i);
+    }
+    chunked.setLast(42);
+    collection.push_back(new Concrete1(1, 2));
+    collection.push_back(new Concrete2("concrete"));
+    collection.push_back(std::make_shared<Concrete2>("shared"));
+    collection.add_unique(std::make_unique<Concrete1>(3, 4));
+
+    positions.push_back(tree.serialize(result));
+    positions.push_back(container.serialize(result, positions.back()));
+    positions.push_back(table.serialize(result, positions.back()));
+    positions.push_back(indexed.serialize(result, positions.back()));
+    positions.push_back(chunked.serialize(result, positions.back()));
+    positions.push_back(collection.serialize(result, positions.back()));
+    positions.push_back(composed.serialize(result, positions.back()));
+
+    size_t pos = 0;
+    pos = serializer::skip<Ser, Tree<int>>(result, pos);
+    REQUIRE(pos == positions[0]);
+    pos = serializer::skip<Ser, WithContainer>(result, pos);
+    REQUIRE(pos == positions[1]);
+    pos = serializer::skip<TableSerializer, WithTable>(result, pos);
+    REQUIRE(pos == positions[2]);
+    pos = serializer::skip<Ser, WithIndexed>(result, pos);
+    REQUIRE(pos == positions[3]);
+    pos = serializer::skip<Ser, WithChunked>(result, pos);
+    REQUIRE(pos == positions[4]);
+    pos = serializer::skip<AbstractSerializer, AbstractCollection>(result, pos);
+    REQUIRE(pos == positions[5]);
+
+    // only the tail of the buffer is deserialized
+    REQUIRE(other.deserialize(result, pos) == positions[6]);
+    REQUIRE(other == composed);
+
+    // types that cannot be skipped
+    REQUIRE_THROWS((serializer::skip<Ser, WithFunctions>(result, 0)));
+}
+#endif
+
+/******************************************************************************/
+/*                                 projection                                 */
+/******************************************************************************/
+
+#ifdef TEST_PROJECTION
+#include "test-classes/composed.hpp"
+#include "test-classes/withchunked.hpp"
+#include "test-classes/withtable.hpp"
+TEST_CASE("projection") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    Composed composed(Simple(1, 2, "composed"), 3, 4);
+    Simple simple(0, 0);
+    Header header(5, "topic");
+    Header otherHeader;
+    serializer::Bytes result;
+
+    // sequential layout (the Simple is the first member of Composed)
+    composed.serialize(result);
+    size_t pos = serializer::deserializeProjection<Ser>(
+        result, 0, simple, serializer::field<2>(&Simple::setStr));
+    REQUIRE(pos == serializer::skip<Ser, Simple>(result, 0));
+    REQUIRE(simple.str() == "composed");
+    REQUIRE(simple.x() == 0);
+    REQUIRE(simple.y() == 0);
+
+    simple = Simple(1, 2, "simple");
+    size_t end = simple.serialize(result);
+    Simple other(0, 0, "");
+    auto project = serializer::bindProjection<Ser>(
+        other, serializer::field<1>(&Simple::setY),
+        serializer::field<2>(&Simple::setStr));
+    pos = project(result);
+    REQUIRE(pos == end);
+    REQUIRE(other.x() == 0);
+    REQUIRE(other.y() == 2);
+    REQUIRE(other.str() == "simple");
+
+    // offset table layout (fields in any order)
+    end = header.serialize(result);
+    pos = serializer::deserializeProjection<Ser>(
+        result, 0, otherHeader, serializer::field<1>(&Header::setTopic),
+        serializer::field<0>(&Header::setId));
+    REQUIRE(pos == end);
+    REQUIRE(otherHeader.id() == 5);
+    REQUIRE(otherHeader.topic() == "topic");
+
+    // the chunked and parallel containers are skipped
+    serializer::tools::ThreadPool pool(2);
+    WithChunked chunked(pool), otherChunked(pool);
+    for (int i = 0; i < 20; ++i) {
+        chunked.strings().push_back(std::to_string(i));
+        chunked.list().push_back(i);
+        chunked.composed().emplace_back(Simple(i, i, "chunked"), i, i);
+    }
+    chunked.setLast(42);
+    end = chunked.serialize(result);
+    pos = serializer::deserializeProjection<Ser>(
+        result, 0, otherChunked, serializer::field<3>(&WithChunked::setLast));
+    REQUIRE(pos == end);
+    REQUIRE(otherChunked.last() == 42);
+    REQUIRE(otherChunked.strings().empty());
+}
+#endif
+
+/******************************************************************************/
+/*                                   access                                   */
+/******************************************************************************/
+
+#ifdef TEST_ACCESS
+#include "test-classes/cstruct.h"
+TEST_CASE("access") {
+    CStructRaw raw = {.c = 'c', .i = 4, .l = 12347890, .f = 3.14, .d = 1.618};
+    CStructRaw other = {};
+    std::vector<CStructRaw> raws;
+    serializer::Bytes result;
+
+    for (int i = 0; i < 10; ++i) {
+        raws.push_back({.c = 'a', .i = i, .l = 2l * i, .f = 0, .d = 0.5 * i});
+    }
+
+    // aligned (in place)
+    size_t end = raw.serialize(result);
+    REQUIRE(end == sizeof(CStructRaw));
+    REQUIRE(other.deserialize(result) == end);
+    REQUIRE(other.l == raw.l);
+    auto ref = serializer::access<CStructRaw>(result, 0);
+    REQUIRE(ref.inPlace());
+    REQUIRE(ref.get() == std::bit_cast<CStructRaw const *>(result.data()));
+    REQUIRE(ref->i == 4);
+    REQUIRE((*ref).d == 1.618);
+
+    // misaligned (copy)
+    serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, 0, 'x', raw, raws);
+    auto misaligned = serializer::access<CStructRaw>(result, 1);
+    REQUIRE(!misaligned.inPlace());
+    REQUIRE(misaligned->l == 12347890);
+    REQUIRE(misaligned->c == 'c');
+    REQUIRE(other.deserialize(result, 1) == 1 + sizeof(CStructRaw));
+    REQUIRE(other.d == raw.d);
+    auto copied =
+        serializer::accessArray<CStructRaw>(result, 1 + sizeof(CStructRaw));
+    REQUIRE(!copied.inPlace());
+    REQUIRE(copied.size() == 10);
+    REQUIRE(copied[7].l == 14);
+
+    // arrays
+    end = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, 0, raws);
+    auto array = serializer::accessArray<CStructRaw>(result, 0);
+    REQUIRE(array.inPlace());
+    REQUIRE(array.size() == raws.size());
+    for (size_t i = 0; i < raws.size(); ++i) {
+        REQUIRE(array[i].i == raws[i].i);
+        REQUIRE(array[i].d == raws[i].d);
+    }
+
+    // bounds
+    REQUIRE_THROWS_AS(serializer::access<CStructRaw>(result, end - 1),
+                      std::out_of_range);
+    result.resize(end - 1);
+    REQUIRE_THROWS_AS(serializer::accessArray<CStructRaw>(result, 0),
+                      std::out_of_range);
+}
+#endif
+
+/******************************************************************************/
+/*                                   stream                                   */
+/******************************************************************************/
+
+#ifdef TEST_STREAM
+#include "test-classes/cstruct.h"
+#include "test-classes/withindexed.hpp"
+#include "test-classes/withtable.hpp"
+#include <cstdio>
+#include <serializer/tools/stream.hpp>
+#include <sstream>
+TEST_CASE("stream") {
+    using Sink = serializer::tools::OStreamSink;
+    WithIndexed indexed;
+    Header header(3, "stream header");
+    std::vector<int> large(100, 7);
+    serializer::Bytes result;
+    std::ostringstream oss;
+
+    for (int i = 0; i < 100; ++i) {
+        indexed.strings().push_back(std::string(i % 13, 'a' + i % 26));
+        indexed.map().insert({i, std::to_string(i)});
+    }
+    indexed.composed().emplace_back(Simple(1, 2, "composed"), 3, 4);
+    indexed.small() = {"one", "two", "three"};
+
+    size_t pos = indexed.serialize(result);
+    pos = header.serialize(result, pos);
+    pos = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, pos, large);
+
+    // same encoding as in memory, with a staging buffer smaller than the data
+    {
+        serializer::tools::OutputStream stream(Sink{oss}, 64);
+        size_t end = indexed.serialize(stream);
+        end = header.serialize(stream, end);
+        REQUIRE(oss.str().size() < end); // only the full buffers are flushed
+        end = serializer::serialize<
+            serializer::Serializer<serializer::tools::OutputStream<Sink>>>(
+            stream, end, large);
+        REQUIRE(end == pos);
+        REQUIRE(stream.size() == pos);
+        REQUIRE_THROWS_AS(header.serialize(stream, 0), std::logic_error);
+        stream.flush();
+    }
+    std::string str = oss.str();
+    REQUIRE(str.size() == pos);
+    REQUIRE(std::memcmp(str.data(), result.data(), pos) == 0);
+
+    // file descriptor
+    std::FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    {
+        serializer::tools::OutputStream stream(
+            serializer::tools::FdSink{fileno(file)}, 32);
+        header.serialize(stream);
+    }
+    serializer::Bytes fromFile(pos);
+    std::rewind(file);
+    fromFile.resize(std::fread(fromFile.data(), 1, pos, file));
+    std::fclose(file);
+    Header other;
+    REQUIRE(other.deserialize(fromFile) == fromFile.size());
+    REQUIRE(other.id() == 3);
+    REQUIRE(other.topic() == "stream header");
+
+    // size computation
+    serializer::tools::ByteCounter counter;
+    size_t size = indexed.serialize(counter);
+    REQUIRE(size == counter.size());
+    REQUIRE(counter.size() ==
+            serializer::skip<serializer::Serializer<serializer::Bytes>,
+                             WithIndexed>(result, 0));
+}
+
+TEST_CASE("input stream") {
+    using Source = serializer::tools::IStreamSource;
+    using Stream = serializer::tools::InputStream<Source>;
+    WithIndexed indexed;
+    Header header(3, "stream header");
+    std::vector<int> large(100);
+    CStructRaw raw = {.c = 'c', .i = 4, .l = 12347890, .f = 3.14, .d = 1.618};
+    serializer::Bytes result;
+
+    for (int i = 0; i < 100; ++i) {
+        indexed.strings().push_back(std::string(i % 13, 'a' + i % 26));
+        indexed.map().insert({i, std::to_string(i)});
+        large[i] = i;
+    }
+    indexed.composed().emplace_back(Simple(1, 2, "composed"), 3, 4);
+    indexed.small() = {"one", "two", "three"};
+
+    size_t pos = indexed.serialize(result);
+    pos = header.serialize(result, pos);
+    pos = serializer::serialize<serializer::Serializer<serializer::Bytes>>(
+        result, pos, large, raw);
+
+    // window smaller than the values (the large vector bypasses the window)
+    std::istringstream iss(std::string(
+        std::bit_cast<char const *>(result.data()), result.size()));
+    Stream stream(Source{iss}, 64);
+    WithIndexed otherIndexed;
+    Header otherHeader;
+    std::vector<int> otherLarge;
+    CStructRaw otherRaw = {};
+
+    size_t end = otherIndexed.deserialize(stream);
+    REQUIRE(otherIndexed.strings() == indexed.strings());
+    REQUIRE(otherIndexed.composed() == indexed.composed());
+    REQUIRE(otherIndexed.map() == indexed.map());
+    REQUIRE(otherIndexed.small() == indexed.small());
+    end = otherHeader.deserialize(stream, end);
+    REQUIRE(otherHeader.id() == 3);
+    REQUIRE(otherHeader.topic() == "stream header");
+    end = serializer::deserialize<serializer::Serializer<Stream>>(
+        stream, end, otherLarge, otherRaw);
+    REQUIRE(end == pos);
+    REQUIRE(otherLarge == large);
+    REQUIRE(otherRaw.d == raw.d);
+
+    // errors
+    REQUIRE_THROWS_AS(otherHeader.deserialize(stream, 0), std::logic_error);
+    REQUIRE_THROWS_AS(otherHeader.deserialize(stream, end), std::out_of_range);
+
+    // file descriptor
+    std::FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    std::fwrite(result.data(), 1, result.size(), file);
+    std::rewind(file);
+    serializer::tools::InputStream fdStream(
+        serializer::tools::FdSource{fileno(file)}, 16);
+    end = serializer::skip<serializer::Serializer<serializer::Bytes>,
+                           WithIndexed>(result, 0);
+    REQUIRE(otherHeader.deserialize(fdStream, end) ==
+            header.serialize(result, end));
+    std::fclose(file);
+}
+#endif
+
+/******************************************************************************/
+/*                                   frame                                    */
+/******************************************************************************/
+
+#ifdef TEST_FRAME
+#include "test-classes/composed.hpp"
+#include <serializer/frame.hpp>
+TEST_CASE("frame") {
+    using Table = serializer::tools::TypeTable<Simple, Composed>;
+    Simple simple(1, 2, "simple");
+    Composed composed(Simple(3, 4, "composed"), 5, 6);
+    serializer::Bytes result;
+    std::vector<size_t> positions = {0};
+
+    positions.push_back(serializer::serializeFrame(
+        result, positions.back(), serializer::tools::getId<Simple>(Table()),
+        simple));
+    positions.push_back(serializer::serializeFrame(
+        result, positions.back(), serializer::tools::getId<Composed>(Table()),
+        composed));
+    positions.push_back(serializer::serializeFrame(
+        result, positions.back(), serializer::tools::getId<Simple>(Table()),
+        simple, 0x100)); // no checksum, user flag
+    REQUIRE(result.size() == positions.back());
+
+    // dispatch using only the headers
+    auto receive = [&](serializer::Bytes const &mem, size_t pos) {
+        std::vector<std::string> received;
+        while (pos < mem.size()) {
+            auto frame = serializer::readFrame(mem, pos);
+            serializer::tools::applyId(frame.header.type, Table(),
+                                       [&]<typename T>() {
+                                           T obj;
+                                           serializer::deserializeFrame(
+                                               mem, frame, obj);
+                                           received.push_back(
+                                               typeid(T).name());
+                                       });
+            pos = frame.end();
+        }
+        return received;
+    };
+    REQUIRE(receive(result, 0) ==
+            std::vector<std::string>{typeid(Simple).name(),
+                                     typeid(Composed).name(),
+                                     typeid(Simple).name()});
+
+    auto frame = serializer::readFrame(result, positions[1]);
+    REQUIRE(frame.header.type == 1);
+    REQUIRE(frame.header.flags == serializer::tools::frame_checksum);
+    REQUIRE(frame.end() == positions[2]);
+    Composed otherComposed;
+    REQUIRE(serializer::deserializeFrame(result, frame, otherComposed) ==
+            positions[2]);
+    REQUIRE(otherComposed == composed);
+    REQUIRE(serializer::readFrame(result, positions[2]).header.flags == 0x100);
+
+    // forward a payload without decoding it
+    serializer::Bytes forwarded;
+    auto payload = serializer::framePayload(result, frame);
+    serializer::appendFrame(forwarded, 0, frame.header.type, payload.data(),
+                            payload.size());
+    REQUIRE(receive(forwarded, 0) ==
+            std::vector<std::string>{typeid(Composed).name()});
+
+    // corrupt payload: the frame is rejected, the next one is still valid
+    serializer::Bytes corrupt = result;
+    corrupt[frame.pos + 3] = ~corrupt[frame.pos + 3];
+    REQUIRE_THROWS_AS(serializer::readFrame(corrupt, positions[1]),
+                      serializer::exceptions::CorruptFrameError);
+    REQUIRE(serializer::readFrame(corrupt, frame.end()).header.type == 0);
+
+    // corrupt header: resynchronize on the next valid frame
+    corrupt = result;
+    corrupt[positions[1] + 8] = std::byte(0xff); // length
+    REQUIRE_THROWS_AS(serializer::readFrame(corrupt, positions[1]),
+                      serializer::exceptions::CorruptFrameError);
+    REQUIRE(serializer::findFrame(corrupt, positions[1]) == positions[2]);
+    REQUIRE(!serializer::findFrame(corrupt, positions[3]).has_value());
+
+    // truncated buffer
+    corrupt.resize(positions[3] - 1);
+    REQUIRE_THROWS_AS(serializer::readFrame(corrupt, positions[2]),
+                      serializer::exceptions::CorruptFrameError);
+}
+#endif
+
+/******************************************************************************/
+/*                                 async file                                 */
+/******************************************************************************/
+
+#ifdef TEST_ASYNC_FILE
+#include <serializer/io/async_file.hpp>
+TEST_CASE("async file") {
+    std::string path = "/tmp/serializer-async-file-test.bin";
+    std::vector<Simple> batch;
+    std::vector<size_t> offsets;
+
+    for (int i = 0; i < 10; ++i) {
+        batch.emplace_back(i, 2 * i, "batch " + std::to_string(i));
+    }
+
+    auto write = [&](serializer::io::AsyncFileOptions options) {
+        serializer::io::AsyncFile file(path, O_WRONLY | O_CREAT | O_TRUNC,
+                                       options);
+        offsets = {0};
+        for (int i = 0; i < 10; ++i) {
+            serializer::Bytes bytes = file.buffer(128);
+            batch[i].serialize(bytes, 0);
+            offsets.push_back(offsets.back() + bytes.size());
+            file.append(std::move(bytes));
+        }
+        // segment list
+        std::vector<serializer::Bytes> segments;
+        for (int i = 0; i < 2; ++i) {
+            segments.push_back(file.buffer());
+            batch[i].serialize(segments.back(), 0);
+            offsets.push_back(offsets.back() + segments.back().size());
+        }
+        file.append(std::move(segments));
+        REQUIRE(file.size() == offsets.back());
+        file.close();
+    };
+
+    auto check = [&]() {
+        serializer::io::AsyncFile file(path, O_RDONLY);
+        std::vector<Simple> received(offsets.size() - 1);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            file.read(offsets[i], offsets[i + 1] - offsets[i],
+                      [&received, i](serializer::Bytes &bytes) {
+                          received[i].deserialize(bytes, 0);
+                      });
+        }
+        file.drain();
+        REQUIRE(file.inFlight() == 0);
+        for (size_t i = 0; i < received.size(); ++i) {
+            REQUIRE(received[i] == batch[i % 10]);
+        }
+        file.read(offsets.back(), 1, [](auto &) {});
+        REQUIRE_THROWS_AS(file.drain(), std::out_of_range);
+    };
+
+    // the data is appended after the content of the file
+    auto append = [&](serializer::io::AsyncFileOptions options) {
+        serializer::io::AsyncFile file(path, O_RDWR, options);
+        REQUIRE(file.size() == offsets.back());
+        serializer::Bytes bytes = file.buffer();
+        batch[(offsets.size() - 1) % 10].serialize(bytes, 0);
+        offsets.push_back(offsets.back() + bytes.size());
+        file.append(std::move(bytes));
+        REQUIRE(file.size() == offsets.back());
+        file.close();
+    };
+
+    write({.queueDepth = 4});
+    append({.queueDepth = 4});
+    check();
+
+    // small aligned blocks to test the block boundaries
+    write({.queueDepth = 4, .direct = true, .blockSize = 4096});
+    check();
+    append({.queueDepth = 4, .direct = true, .blockSize = 4096});
+    check();
+
+    REQUIRE_THROWS_AS(
+        serializer::io::AsyncFile(path, O_RDONLY,
+                                  {.direct = true, .blockSize = 1000}),
+        std::invalid_argument);
+    std::remove(path.c_str());
+}
+#endif
+
+/******************************************************************************/
+/*                                 coroutine                                  */
+/******************************************************************************/
+
+#ifdef TEST_COROUTINE
+#include "test-classes/withcontainer.hpp"
+#include "test-classes/withmap.hpp"
+TEST_CASE("coroutine") {
+    constexpr size_t nb_connections = 3;
+    std::vector<WithContainer> originals(nb_connections);
+    std::vector<WithContainer> others(nb_connections);
+    WithMap originalMap;
+    WithMap otherMap;
+
+    for (size_t c = 0; c < nb_connections; ++c) {
+        for (int i = 0; i < 10 * int(c + 1); ++i) {
+            originals[c].addInt(i);
+            originals[c].addDouble(i * 1.5);
+            originals[c].addSimple(Simple(i, 2 * i, "s" + std::to_string(i)));
+            originals[c].addVec(std::vector<int>(size_t(i), i));
+        }
+        originals[c].addArr(3, int(c));
+        originals[c].addArrSimple(2, Simple(1, 2, "simple"));
+    }
+    for (int i = 0; i < 20; ++i) {
+        originalMap.insert("key" + std::to_string(i), std::to_string(i));
+    }
+
+    // several connections are multiplexed on one thread: the outputs are
+    // drained and the inputs fed a few bytes at a time
+    struct Connection {
+        serializer::tools::AsyncOutput out{16};
+        serializer::tools::AsyncInput in{16};
+        serializer::tools::Task<size_t> writer;
+        serializer::tools::Task<size_t> reader;
+        serializer::Bytes wire;
+    };
+    std::vector<Connection> connections(nb_connections + 1);
+    for (size_t c = 0; c < nb_connections; ++c) {
+        connections[c].writer =
+            serializer::serializeAsync(connections[c].out, originals[c]);
+        connections[c].reader =
+            serializer::deserializeAsync(connections[c].in, 0, others[c]);
+    }
+    connections.back().writer =
+        serializer::serializeAsync(connections.back().out, originalMap);
+    connections.back().reader =
+        serializer::deserializeAsync(connections.back().in, 0, otherMap);
+
+    bool done = false;
+    size_t maxPending = 0;
+    while (!done) {
+        done = true;
+        for (auto &connection : connections) {
+            connection.writer.resume();
+            auto pending = connection.out.pending();
+            maxPending = std::max(maxPending, pending.size());
+            size_t count = std::min<size_t>(pending.size(), 5);
+            connection.wire.append(connection.wire.size(), pending.data(),
+                                   count);
+            connection.in.feed(pending.data(), count);
+            connection.out.consume(count);
+            if (connection.writer.done() &&
+                connection.out.pending().empty()) {
+                connection.in.close();
+            }
+            connection.reader.resume();
+            done = done && connection.reader.done();
+        }
+    }
+
+    for (size_t c = 0; c < nb_connections; ++c) {
+        serializer::Bytes expected;
+        REQUIRE(connections[c].writer.result() ==
+                originals[c].serialize(expected));
+        REQUIRE(connections[c].wire.size() == expected.size());
+        REQUIRE(std::memcmp(connections[c].wire.data(), expected.data(),
+                            expected.size()) == 0);
+        REQUIRE(connections[c].reader.result() == expected.size());
+        REQUIRE(others[c].getVec() == originals[c].getVec());
+        REQUIRE(others[c].getLst() == originals[c].getLst());
+        REQUIRE(others[c].getClassVec() == originals[c].getClassVec());
+        REQUIRE(others[c].getVec2D() == originals[c].getVec2D());
+        REQUIRE(others[c].getArr() == originals[c].getArr());
+        REQUIRE(others[c].getArrSimple() == originals[c].getArrSimple());
+    }
+    REQUIRE(otherMap.map() == originalMap.map());
+    // the buffer holds at most one value that is not split
+    REQUIRE(maxPending <= 64);
+
+    // truncated input
+    serializer::tools::AsyncInput in;
+    Simple simple;
+    auto task = serializer::deserializeAsync(in, 0, simple);
+    in.feed(connections[0].wire.data(), 6);
+    task.resume();
+    REQUIRE(!task.done());
+    in.close();
+    REQUIRE_THROWS_AS(task.resume(), std::out_of_range);
+}
+
+#include "test-classes/withchunked.hpp"
+#include "test-classes/withdynamicarrays.hpp"
+#include "test-classes/withpointers.hpp"
+#include "test-classes/withsmartptr.hpp"
+#include "test-classes/withtuple.hpp"
+TEST_CASE("coroutine pointers, tuples and dynamic arrays") {
+    constexpr size_t capacity = 16;
+
+    // the data is sent a few bytes at a time through small buffers
+    auto transfer = [&](auto const &original, auto &other) {
+        serializer::tools::AsyncOutput out{capacity};
+        serializer::tools::AsyncInput in{capacity};
+        serializer::Bytes wire;
+        serializer::Bytes expected;
+        size_t maxPending = 0;
+        auto writer = serializer::serializeAsync(out, original);
+        auto reader = serializer::deserializeAsync(in, 0, other);
+
+        while (!reader.done()) {
+            writer.resume();
+            auto pending = out.pending();
+            maxPending = std::max(maxPending, pending.size());
+            size_t count = std::min<size_t>(pending.size(), 3);
+            wire.append(wire.size(), pending.data(), count);
+            in.feed(pending.data(), count);
+            out.consume(count);
+            if (writer.done() && out.pending().empty()) {
+                in.close();
+            }
+            reader.resume();
+        }
+        REQUIRE(writer.result() == original.serialize(expected));
+        REQUIRE(wire.size() == expected.size());
+        REQUIRE(std::memcmp(wire.data(), expected.data(), expected.size()) ==
+                0);
+        REQUIRE(reader.result() == expected.size());
+        // the values are split, so the capacity is never exceeded
+        REQUIRE(maxPending <= capacity);
+    };
+
+    WithTuple originalTuple(1, 2, 3.5, "one", "two", "three", Simple(1, 2),
+                            Composed(Simple(3, 4), 5, 6.5), {1, 2, 3},
+                            {"a", "b"}, {{"k1", "v1"}, {"k2", "v2"}},
+                            new int(7), nullptr);
+    WithTuple otherTuple;
+    transfer(originalTuple, otherTuple);
+    REQUIRE(otherTuple.numberTuple() == originalTuple.numberTuple());
+    REQUIRE(otherTuple.stringTuple() == originalTuple.stringTuple());
+    REQUIRE(otherTuple.containerTuple() == originalTuple.containerTuple());
+    REQUIRE(std::get<0>(otherTuple.objTuple()) ==
+            std::get<0>(originalTuple.objTuple()));
+    REQUIRE(*std::get<0>(otherTuple.pointerTuple()) == 7);
+    REQUIRE(std::get<1>(otherTuple.pointerTuple()) == nullptr);
+
+    WithPointers originalPointers(new Simple(1, 2, "pointer"));
+    WithPointers otherPointers(nullptr);
+    transfer(originalPointers, otherPointers);
+    REQUIRE(otherPointers.nullPointer() == nullptr);
+    REQUIRE(*otherPointers.fundamentalPointer() == 1.9);
+    REQUIRE(*otherPointers.classPointer() == *originalPointers.classPointer());
+
+    WithSmartPtr originalSmart(1, 2.5, "smart");
+    WithSmartPtr otherSmart;
+    transfer(originalSmart, otherSmart);
+    REQUIRE(otherSmart.intPtr() == 1);
+    REQUIRE(otherSmart.doublePtr() == 2.5);
+    REQUIRE(otherSmart.otherType() == "smart");
+
+    WithDynamicArray originalArrays(2);
+    WithDynamicArray otherArrays;
+    std::vector<double> external(10, 4.5);
+    originalArrays.borrow(external.data(), external.size());
+    for (size_t i = 0; i < 16; ++i) {
+        originalArrays.twoDOneD()[i] = int(i);
+    }
+    for (size_t i = 0; i < 5; ++i) {
+        originalArrays.own()[i] = int(i);
+        originalArrays.ownSimple()[i] = Simple(int(i), int(i), "simple");
+        originalArrays.multipleDim()[i % 2][i % 2] = int(i);
+    }
+    transfer(originalArrays, otherArrays);
+    for (size_t i = 0; i < 10; ++i) {
+        REQUIRE(otherArrays.borrowed()[i] == 4.5);
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        REQUIRE(otherArrays.twoDOneD()[i] == int(i));
+    }
+    for (size_t i = 0; i < 5; ++i) {
+        REQUIRE(otherArrays.own()[i] == int(i));
+        REQUIRE(otherArrays.ownSimple()[i] == originalArrays.ownSimple()[i]);
+    }
+    REQUIRE(otherArrays.null() == nullptr);
+    REQUIRE(otherArrays.multipleDim()[1][1] ==
+            originalArrays.multipleDim()[1][1]);
+    delete[] otherArrays.borrowed();
+
+    // same data as the (parallel) serializer
+    serializer::tools::ThreadPool pool(2);
+    WithChunked originalChunked(pool);
+    WithChunked otherChunked(pool);
+    for (int i = 0; i < 20; ++i) {
+        originalChunked.strings().push_back("string" + std::to_string(i));
+        originalChunked.list().push_back(i);
+        originalChunked.composed().emplace_back(Simple(i, i, "c"), i, i);
+    }
+    originalChunked.setLast(42);
+    transfer(originalChunked, otherChunked);
+    REQUIRE(otherChunked.strings() == originalChunked.strings());
+    REQUIRE(otherChunked.list() == originalChunked.list());
+    REQUIRE(otherChunked.composed() == originalChunked.composed());
+    REQUIRE(otherChunked.last() == 42);
+}
+#endif
+
+/******************************************************************************/
+/*                                 record log                                 */
+/******************************************************************************/
+
+#ifdef TEST_RECORD_LOG
+#include <filesystem>
+#include <fstream>
+#include <serializer/io/record_log.hpp>
+TEST_CASE("record log") {
+    namespace fs = std::filesystem;
+    std::string path = "/tmp/serializer-record-log-test.log";
+    std::string copy = "/tmp/serializer-record-log-test-copy.log";
+    auto remove = [](std::string const &file) {
+        fs::remove(file);
+        fs::remove(file + ".index");
+    };
+    auto record = [](size_t i) {
+        return Simple(int(i), int(2 * i), "record " + std::to_string(i));
+    };
+    auto check = [&](serializer::io::RecordLog &log, size_t size) {
+        REQUIRE(log.size() == size);
+        for (size_t i = 0; i < size; i += 7) {
+            Simple simple;
+            REQUIRE(log.read(i, simple) == i % 2);
+            REQUIRE(simple == record(i));
+            REQUIRE(simple.str() == record(i).str());
+        }
+    };
+    remove(path);
+    remove(copy);
+
+    {
+        serializer::io::RecordLog log(path, {.bufferSize = 256});
+        for (size_t i = 0; i < 100; ++i) {
+            REQUIRE(log.append(record(i), std::uint32_t(i % 2)) == i);
+        }
+        check(log, 100);
+        log.checkpoint();
+        for (size_t i = 100; i < 150; ++i) {
+            log.append(record(i), std::uint32_t(i % 2));
+        }
+        check(log, 150);
+        log.flush();
+
+        // crash after the checkpoint: the copy has a partial frame at the end
+        fs::copy_file(path, copy);
+        fs::copy_file(path + ".index", copy + ".index");
+        std::ofstream(copy, std::ios::app) << "partial";
+    }
+    {
+        serializer::io::RecordLog log(path);
+        REQUIRE(log.recovered() == 0);
+        check(log, 150);
+        REQUIRE_THROWS_AS(log.read(150, *std::make_unique<Simple>()),
+                          std::out_of_range);
+    }
+    {
+        serializer::io::RecordLog log(copy);
+        REQUIRE(log.recovered() == 50);
+        REQUIRE(fs::file_size(copy) == log.dataSize());
+        check(log, 150);
+        log.append(record(150), 0);
+        check(log, 151);
+    }
+    {
+        // invalid trailer: all the frames are read again
+        std::fstream(copy + ".index", std::ios::in | std::ios::out)
+            .write("corrupt", 7);
+        serializer::io::RecordLog log(copy);
+        REQUIRE(log.recovered() == 151);
+        check(log, 151);
+    }
+    {
+        serializer::io::RecordLog log(copy);
+        REQUIRE(log.recovered() == 0);
+        check(log, 151);
+    }
+    {
+        // valid checksums but offsets that are not increasing: the index is
+        // ignored and all the frames are read again
+        std::uint64_t offsets[2] = {0, 0};
+        serializer::io::RecordIndexTrailer trailer;
+        trailer.count = 2;
+        trailer.dataSize = fs::file_size(copy);
+        trailer.offsetsChecksum = serializer::tools::crc32(
+            reinterpret_cast<std::byte const *>(offsets), sizeof(offsets));
+        trailer.checksum = serializer::tools::crc32(
+            reinterpret_cast<std::byte const *>(&trailer),
+            offsetof(serializer::io::RecordIndexTrailer, checksum));
+        std::ofstream index(copy + ".index", std::ios::binary);
+        index.write(reinterpret_cast<char const *>(offsets), sizeof(offsets));
+        index.write(reinterpret_cast<char const *>(&trailer), sizeof(trailer));
+    }
+    {
+        serializer::io::RecordLog log(copy);
+        REQUIRE(log.recovered() == 151);
+        check(log, 151);
+    }
+
+    // the files are closed when the constructor throws
+    auto nbFds = [] {
+        return std::distance(fs::directory_iterator("/proc/self/fd"),
+                             fs::directory_iterator());
+    };
+    remove(copy);
+    fs::create_directory(copy + ".index");
+    auto fds = nbFds();
+    REQUIRE_THROWS_AS(serializer::io::RecordLog(copy), std::system_error);
+    REQUIRE(nbFds() == fds);
+    fs::remove(copy + ".index");
+    remove(path);
+    remove(copy);
+}
+#endif
+
+/******************************************************************************/
+/*                             shared memory ring                             */
+/******************************************************************************/
+
+#ifdef TEST_SHM_RING
+#include "test-classes/cstruct.h"
+#include <serializer/io/shm_ring.hpp>
+#include <sys/wait.h>
+#include <thread>
+TEST_CASE("shared memory ring") {
+    auto message = [](int i) {
+        return Simple(i, 2 * i, std::string(size_t(i % 40), 'x'));
+    };
+
+    // spsc: the records wrap around the end of the ring
+    auto spsc = serializer::io::SpscRing::create("/serializer-test-ring", 256);
+    auto consumer = serializer::io::SpscRing::open("/serializer-test-ring");
+    int received = 0;
+    for (int i = 0; i < 200; ++i) {
+        while (!spsc.trySend(message(i))) {
+            Simple simple;
+            REQUIRE(consumer.tryReceive(simple));
+            REQUIRE(simple.str() == message(received).str());
+            REQUIRE(simple == message(received++));
+        }
+    }
+    Simple simple;
+    while (consumer.tryReceive(simple)) {
+        REQUIRE(simple == message(received++));
+    }
+    REQUIRE(received == 200);
+    REQUIRE(spsc.used() == 0);
+    REQUIRE_THROWS_AS(spsc.tryReserve(256), std::length_error);
+
+    // in place access to the payload
+    spsc.send(CStructRaw{.c = 'c', .i = 1, .l = 2, .f = 1.5, .d = 2.5});
+    REQUIRE(consumer.tryConsume([](std::span<std::byte const> payload) {
+        auto raw = serializer::access<CStructRaw>(payload, 0);
+        REQUIRE(raw.inPlace());
+        REQUIRE(raw->d == 2.5);
+    }));
+
+    // the capacity of the header does not match the size of the object
+    {
+        int fd = shm_open("/serializer-test-bad-ring", O_CREAT | O_RDWR, 0600);
+        std::uint64_t header[2] = {serializer::io::shm_ring_magic, 1 << 20};
+        REQUIRE(::pwrite(fd, header, sizeof(header), 0) == sizeof(header));
+        REQUIRE(ftruncate(fd, sizeof(serializer::io::ShmRingHeader) + 256) ==
+                0);
+        ::close(fd);
+        REQUIRE_THROWS_AS(
+            serializer::io::SpscRing::open("/serializer-test-bad-ring"),
+            std::system_error);
+        shm_unlink("/serializer-test-bad-ring");
+    }
+
+    // mpsc: concurrent producers
+    auto mpsc = serializer::io::MpscRing::anonymous(1024);
+    constexpr int nb_producers = 3, nb_messages = 500;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < nb_producers; ++p) {
+        producers.emplace_back([&mpsc, p, &message] {
+            for (int i = 0; i < nb_messages; ++i) {
+                mpsc.send(message(p * nb_messages + i));
+            }
+        });
+    }
+    std::vector<int> last(nb_producers, -1);
+    for (int count = 0; count < nb_producers * nb_messages; ++count) {
+        mpsc.receive(simple);
+        int p = simple.x() / nb_messages;
+        // the messages of each producer are received in order
+        REQUIRE(simple.x() > last[size_t(p)]);
+        REQUIRE(simple.str() == message(simple.x()).str());
+        last[size_t(p)] = simple.x();
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    REQUIRE(mpsc.used() == 0);
+
+    // between processes
+    auto ring = serializer::io::SpscRing::anonymous(512);
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < 1000; ++i) {
+            ring.send(message(i));
+        }
+        _exit(0);
+    }
+    bool ok = true;
+    for (int i = 0; i < 1000; ++i) {
+        ring.receive(simple);
+        ok = ok && simple == message(i) && simple.str() == message(i).str();
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    REQUIRE(ok);
+    REQUIRE(WIFEXITED(status));
+}
+#endif
+
+/******************************************************************************/
+/*                                unix socket                                 */
+/******************************************************************************/
+
+#ifdef TEST_UNIX_SOCKET
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+#include <serializer/io/unix_socket.hpp>
+#include <sys/wait.h>
+#include <thread>
+TEST_CASE("unix socket") {
+    auto message = [](int i) {
+        return Simple(i, 2 * i, std::string(size_t(i % 300), 'x'));
+    };
+
+    // batched frames, the reads split the frames (small buffer)
+    auto [in, out] = serializer::io::UnixSocket::pair();
+    std::thread producer([&out, &message] {
+        serializer::io::FrameSender sender(out, 1024);
+        for (int i = 0; i < 2000; ++i) {
+            sender.post(message(i), std::uint32_t(i));
+        }
+        sender.flush();
+        out.shutdownWrite();
+    });
+    serializer::io::FrameReceiver receiver(in, 128);
+    int received = 0;
+    bool ok = true;
+    while (receiver.receive([&](auto &mem, serializer::Frame frame) {
+        Simple simple;
+        simple.deserialize(mem, frame.pos);
+        ok = ok && frame.header.type == std::uint32_t(received) &&
+             simple == message(received) &&
+             simple.str() == message(received).str();
+        ++received;
+    })) {
+    }
+    producer.join();
+    REQUIRE(ok);
+    REQUIRE(received == 2000);
+
+    // the data ends inside a frame
+    auto [in2, out2] = serializer::io::UnixSocket::pair();
+    serializer::Bytes frame;
+    serializer::serializeFrame(frame, 0, 0, message(10));
+    frame.resize(frame.size() - 1);
+    std::vector<serializer::Bytes> segments;
+    segments.push_back(frame);
+    out2.send(segments);
+    out2.shutdownWrite();
+    serializer::io::FrameReceiver truncated(in2);
+    auto ignore = [](auto &, serializer::Frame) {};
+    REQUIRE(truncated.receive(ignore));
+    REQUIRE_THROWS_AS(truncated.receive(ignore),
+                      serializer::exceptions::CorruptFrameError);
+
+    // connection to a socket file
+    serializer::io::UnixListener listener("/tmp/serializer-test.sock");
+    auto client = serializer::io::UnixSocket::connect(
+        "/tmp/serializer-test.sock");
+    auto server = listener.accept();
+    {
+        serializer::io::FrameSender sender(client);
+        sender.post(message(42), 42);
+    }
+    client.close();
+    serializer::io::FrameReceiver fromClient(server);
+    Simple simple;
+    while (fromClient.receive([&](auto &mem, serializer::Frame frame) {
+        REQUIRE(frame.header.type == 42);
+        simple.deserialize(mem, frame.pos);
+    })) {
+    }
+    REQUIRE(simple.str() == message(42).str());
+
+    // hedgehog tasks in two processes
+    constexpr size_t w = 8, h = 8, bs = 2;
+    double sum = 0;
+    double *data = new double[h * w];
+    serializer::Bytes buff;
+    auto matrix = std::make_shared<Matrix<double>>(h, w, bs, data);
+    auto [parent, child] = serializer::io::UnixSocket::pair();
+
+    for (size_t i = 0; i < h * w; ++i) {
+        matrix->data()[i] = double(i);
+        sum += double(i);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        auto ct = std::make_shared<ComputeTask<double, SocketTransport>>();
+        TaskManager<TypeTable<double>, ComputeTask<double, SocketTransport>>
+            tm(ct);
+        serializer::io::FrameSender sender(child);
+        serializer::io::FrameReceiver blocks(child);
+        SocketTransport::sender = &sender;
+        tm.receive(blocks);
+        sender.flush();
+        _exit(0);
+    }
+    child.close();
+    auto st = std::make_shared<SplitTask<double, SocketTransport>>();
+    auto rt = std::make_shared<ResultTask<double>>();
+    TaskManager<TypeTable<double>, SplitTask<double, SocketTransport>,
+                ResultTask<double>>
+        tm(st, rt);
+    {
+        serializer::io::FrameSender sender(parent);
+        SocketTransport::sender = &sender;
+        matrix->serialize(buff);
+        tm.receive(buff); // the blocks are sent to the child
+        sender.flush();
+        SocketTransport::sender = nullptr;
+    }
+    parent.shutdownWrite();
+    serializer::io::FrameReceiver sums(parent);
+    tm.receive(sums);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(rt->result == sum);
+
+    delete[] data;
+}
+#endif
+
+/******************************************************************************/
+/*                                 checkpoint                                 */
+/******************************************************************************/
+
+#ifdef TEST_CHECKPOINT
+#include "test-classes/simple.hpp"
+#include <filesystem>
+#include <serializer/io/checkpoint.hpp>
+TEST_CASE("checkpoint") {
+    namespace fs = std::filesystem;
+    std::string dir = fs::temp_directory_path() / "serializer-checkpoint";
+    auto nbFiles = [&dir] {
+        return std::distance(fs::directory_iterator(dir),
+                             fs::directory_iterator());
+    };
+    fs::remove_all(dir);
+
+    Simple a(1, 2, "a"), b(3, 4, "b");
+    std::vector<int> values(1000, 7);
+    {
+        serializer::io::Checkpoint checkpoint(dir);
+        REQUIRE(!checkpoint.restore());
+        REQUIRE(checkpoint.add(a) == 0);
+        REQUIRE(checkpoint.add(b) == 1);
+        REQUIRE(checkpoint.add(values) == 2);
+
+        // base then deltas that only contain the dirty blocks
+        REQUIRE(checkpoint.snapshot() == 3);
+        // nothing is dirty: no new generation
+        REQUIRE(checkpoint.snapshot() == 0);
+        REQUIRE(checkpoint.generation() == 1);
+        b.str("bb");
+        checkpoint.markDirty(b);
+        REQUIRE(checkpoint.dirty(1));
+        REQUIRE(!checkpoint.dirty(0));
+        REQUIRE(checkpoint.snapshot() == 1);
+        a.x(10);
+        checkpoint.markDirty(0);
+        REQUIRE(checkpoint.snapshot() == 1);
+        REQUIRE(checkpoint.generation() == 3);
+        REQUIRE_THROWS_AS(checkpoint.markDirty(dir), std::out_of_range);
+    }
+
+    // restore the base and the deltas
+    Simple a2, b2;
+    std::vector<int> values2;
+    {
+        serializer::io::Checkpoint checkpoint(dir);
+        checkpoint.add(a2);
+        checkpoint.add(b2);
+        checkpoint.add(values2);
+        REQUIRE(checkpoint.restore());
+        REQUIRE(a2.x() == 10);
+        REQUIRE(b2.str() == "bb");
+        REQUIRE(values2 == values);
+        REQUIRE(!checkpoint.dirty(2));
+
+        // the small deltas replace the first version of the small blocks, the
+        // files are compacted when the large block is the only live data of
+        // the base
+        for (int i = 0; i < 3; ++i) {
+            values2[0] = i;
+            checkpoint.markDirty(values2);
+            checkpoint.snapshot();
+        }
+        REQUIRE(checkpoint.storedSize() <= 3 * checkpoint.liveSize());
+        REQUIRE(checkpoint.compact() == 3);
+        // manifest and base
+        REQUIRE(nbFiles() == 2);
+        REQUIRE(checkpoint.storedSize() == checkpoint.liveSize());
+    }
+    {
+        serializer::io::Checkpoint checkpoint(dir);
+        Simple a3, b3;
+        std::vector<int> values3;
+        checkpoint.add(a3);
+        checkpoint.add(b3);
+        checkpoint.add(values3);
+        REQUIRE(checkpoint.restore());
+        REQUIRE(a3.x() == 10);
+        REQUIRE(values3[0] == 2);
+    }
+    {
+        // the snapshots are always full when the ratio is less than 1
+        serializer::io::Checkpoint checkpoint(dir, {.compactRatio = 0.5});
+        checkpoint.add(a);
+        checkpoint.add(b);
+        checkpoint.add(values);
+        REQUIRE(checkpoint.restore());
+        REQUIRE(checkpoint.snapshot() == 0);
+        checkpoint.markDirty(a);
+        REQUIRE(checkpoint.snapshot() == 3);
+        REQUIRE(nbFiles() == 2);
+    }
+    fs::remove_all(dir);
+}
+#endif
+
+/******************************************************************************/
+/*                                  parallel                                  */
+/******************************************************************************/
+
+#ifdef TEST_PARALLEL
+#include "test-classes/composed.hpp"
+#include "test-classes/cstruct.h"
+#include <list>
+#include <serializer/tools/parallel.hpp>
+#include <serializer/tools/thread_pool.hpp>
+struct FixedMemory {
+    int value = 0;
+    std::string name;
+    bool operator==(FixedMemory const &) const = default;
+    SERIALIZE_CUSTOM(serializer::Serializer<serializer::Bytes>, value, name);
+};
+
+TEST_CASE("parallel serialization") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    using serializer::tools::parallel;
+    serializer::tools::ThreadPool pool(4);
+    std::vector<Composed> composed;
+    std::vector<std::vector<int>> vectors;
+    std::vector<CStructRaw> raws(1000);
+    std::list<std::string> strings;
+
+    for (int i = 0; i < 10000; ++i) {
+        composed.emplace_back(Simple(i, 2 * i, std::string(i % 23, 'a')), i,
+                              i / 2.0);
+        vectors.emplace_back(i % 7, i);
+        strings.push_back(std::to_string(i));
+    }
+
+    // same data as the sequential serialization (3 is written first so the
+    // chunks do not start at the beginning of the buffer)
+    serializer::Bytes sequential, result;
+    serializer::serialize<Ser>(sequential, 0, 3, composed, vectors, raws,
+                               strings);
+    size_t end = serializer::serialize<Ser>(
+        result, 0, 3, parallel(composed, pool, 100),
+        parallel(vectors, pool, 64), parallel(raws, pool),
+        parallel(strings, pool));
+    REQUIRE(end == sequential.size());
+    REQUIRE(result.size() == sequential.size());
+    REQUIRE(std::memcmp(result.data(), sequential.data(), end) == 0);
+
+    // other memory buffers
+    std::vector<std::byte> vec;
+    serializer::serialize<serializer::Serializer<std::vector<std::byte>>>(
+        vec, 0, parallel(composed, pool, 128));
+    serializer::Bytes reference;
+    serializer::serialize<Ser>(reference, 0, composed);
+    REQUIRE(vec.size() == reference.size());
+    REQUIRE(std::memcmp(vec.data(), reference.data(), vec.size()) == 0);
+    std::vector<std::byte> small(10);
+    std::span<std::byte> span(small);
+    REQUIRE_THROWS_AS(
+        (serializer::serialize<serializer::Serializer<std::span<std::byte>>>(
+            span, 0, parallel(composed, pool, 128))),
+        std::out_of_range);
+
+    // deserialization
+    int three = 0;
+    std::vector<Composed> composed2;
+    std::vector<std::vector<int>> vectors2;
+    std::vector<CStructRaw> raws2;
+    std::list<std::string> strings2;
+    REQUIRE(serializer::deserialize<Ser>(result, 0, three,
+                                         parallel(composed2, pool),
+                                         parallel(vectors2, pool), raws2,
+                                         strings2) == end);
+    REQUIRE(three == 3);
+    REQUIRE(composed2 == composed);
+    REQUIRE(vectors2 == vectors);
+    REQUIRE(strings2 == strings);
+
+    // the elements which serializer has a fixed memory type are serialized
+    // sequentially
+    static_assert(!serializer::mtf::accepts_memory_v<
+                  FixedMemory, serializer::tools::ByteCounter>);
+    static_assert(
+        serializer::mtf::accepts_memory_v<Composed, std::span<std::byte>>);
+    std::vector<FixedMemory> fixed, fixed2;
+    for (int i = 0; i < 1000; ++i) {
+        fixed.push_back({i, std::to_string(i)});
+    }
+    serializer::Bytes fixedSequential, fixedResult;
+    serializer::serialize<Ser>(fixedSequential, 0, fixed);
+    end = serializer::serialize<Ser>(fixedResult, 0, parallel(fixed, pool, 64));
+    REQUIRE(end == fixedSequential.size());
+    REQUIRE(std::memcmp(fixedResult.data(), fixedSequential.data(), end) == 0);
+    serializer::deserialize<Ser>(fixedResult, 0, parallel(fixed2, pool));
+    REQUIRE(fixed2 == fixed);
+
+    // the errors are forwarded to the calling thread
+    REQUIRE_THROWS_AS(pool.parallelFor(100,
+                                       [](size_t i) {
+                                           if (i == 42) {
+                                               throw std::runtime_error("42");
+                                           }
+                                       }),
+                      std::runtime_error);
+    std::atomic<size_t> sum = 0;
+    pool.parallelFor(1000, [&sum](size_t i) { sum += i; });
+    REQUIRE(sum == 999 * 1000 / 2);
+}
+#endif
+
+/******************************************************************************/
+/*                                  chunked                                   */
+/******************************************************************************/
+
+#ifdef TEST_CHUNKED
+#include "test-classes/composed.hpp"
+#include <list>
+#include <map>
+#include <serializer/tools/parallel.hpp>
+#include <set>
+#include <sstream>
+TEST_CASE("chunked containers") {
+    using Ser = serializer::Serializer<serializer::Bytes>;
+    using serializer::tools::chunked;
+    serializer::tools::ThreadPool pool(4);
+    std::vector<Composed> composed, composed2, composed3;
+    std::vector<int> ints, ints2;
+    std::map<int, std::string> map, map2;
+    std::set<std::string> set, set2;
+    std::list<int> list, list2;
+
+    for (int i = 0; i < 5000; ++i) {
+        composed.emplace_back(Simple(i, 2 * i, std::string(i % 13, 'a')), i,
+                              i / 2.0);
+        ints.push_back(i);
+        map.insert({i, std::to_string(i)});
+        set.insert(std::to_string(i));
+        list.push_back(-i);
+    }
+
+    serializer::Bytes result;
+    size_t end = serializer::serialize<Ser>(
+        result, 0, chunked(composed, pool, 100), chunked(ints, pool, 1000),
+        chunked(map, pool, 300), chunked(set, pool, 700),
+        chunked(list, pool, 64));
+    REQUIRE(end == result.size());
+    REQUIRE(serializer::deserialize<Ser>(
+                result, 0, chunked(composed2, pool), chunked(ints2, pool),
+                chunked(map2, pool), chunked(set2, pool),
+                chunked(list2, pool)) == end);
+    REQUIRE(composed2 == composed);
+    REQUIRE(ints2 == ints);
+    REQUIRE(map2 == map);
+    REQUIRE(set2 == set);
+    REQUIRE(list2 == list);
+
+    // the elements which serializer has a fixed memory type are
+    // (de)serialized sequentially
+    std::vector<FixedMemory> fixed, fixed2;
+    for (int i = 0; i < 1000; ++i) {
+        fixed.push_back({i, std::to_string(i)});
+    }
+    serializer::Bytes fixedResult;
+    end = serializer::serialize<Ser>(fixedResult, 0, chunked(fixed, pool, 64));
+    REQUIRE(serializer::deserialize<Ser>(fixedResult, 0,
+                                         chunked(fixed2, pool)) == end);
+    REQUIRE(fixed2 == fixed);
+
+    // streams and sequential deserialization give the same result
+    using Sink = serializer::tools::OStreamSink;
+    std::ostringstream oss;
+    serializer::tools::OutputStream out(Sink{oss});
+    serializer::serialize<
+        serializer::Serializer<serializer::tools::OutputStream<Sink>>>(
+        out, 0, chunked(composed, pool, 100));
+    out.flush();
+    serializer::tools::ThreadPool single(1);
+    size_t composedEnd = serializer::deserialize<Ser>(
+        result, 0, chunked(composed3, single));
+    REQUIRE(composed3 == composed);
+    REQUIRE(oss.str().size() == composedEnd);
+    REQUIRE(std::memcmp(oss.str().data(), result.data(), composedEnd) == 0);
+
+    // corrupt chunk boundaries
+    std::vector<size_t> ends(50);
+    std::memcpy(ends.data(), result.data() + composedEnd - 50 * sizeof(size_t),
+                50 * sizeof(size_t));
+    ends[10] = ends[11] + 1;
+    std::memcpy(result.data() + composedEnd - 50 * sizeof(size_t), ends.data(),
+                50 * sizeof(size_t));
+    REQUIRE_THROWS_AS(
+        serializer::deserialize<Ser>(result, 0, chunked(composed2, pool)),
+        std::out_of_range);
+}
+#endif
+
+/******************************************************************************/
+/*                                  dispatch                                  */
+/******************************************************************************/
+
+#ifdef TEST_DISPATCH
+#include "test-classes/composed.hpp"
+#include "test-classes/hedgehog.hpp"
+#include <serializer/dispatch.hpp>
+#include <serializer/tools/work_stealing_pool.hpp>
+TEST_CASE("dispatch") {
+    using Table = serializer::tools::TypeTable<Simple, Composed>;
+    using serializer::DispatchOrder;
+    serializer::tools::WorkStealingPool pool(4);
+
+    // tasks submitted by the tasks run on the pool, errors are forwarded
+    std::atomic<size_t> count = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        pool.submit([&] {
+            ++count;
+            pool.submit([&] { ++count; });
+        });
+    }
+    pool.wait();
+    REQUIRE(count == 200);
+    pool.submit([] { throw std::runtime_error("error"); });
+    pool.submit([&] { ++count; });
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+    REQUIRE(count == 201);
+    pool.wait(); // the error is reported once
+
+    // frames of two types with 4 keys
+    constexpr size_t nbFrames = 1000;
+    serializer::Bytes buff;
+    size_t pos = 0;
+    for (int i = 0; i < int(nbFrames); ++i) {
+        if (i % 3 == 0) {
+            pos = serializer::serializeFrame(
+                buff, pos, serializer::tools::getId<Composed>(Table()),
+                Composed(Simple(i % 4, i, "composed"), i, i));
+        } else {
+            pos = serializer::serializeFrame(
+                buff, pos, serializer::tools::getId<Simple>(Table()),
+                Simple(i % 4, i, "simple"));
+        }
+    }
+
+    // no order: every object is handled once
+    std::mutex mutex;
+    std::vector<int> seen;
+    serializer::FrameDispatcher<Table> dispatcher(pool);
+    auto collect = [&](auto obj) {
+        int y;
+        if constexpr (std::is_same_v<decltype(obj), std::shared_ptr<Simple>>) {
+            y = obj->y();
+        } else {
+            y = obj->s().y();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(y);
+    };
+    REQUIRE(dispatcher.dispatch(buff, collect) == nbFrames);
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i < int(nbFrames); ++i) {
+        REQUIRE(seen[i] == i);
+    }
+
+    // per type order
+    std::vector<int> simples, composeds;
+    serializer::FrameDispatcher<Table> typeDispatcher(
+        pool, {.order = DispatchOrder::PerType});
+    typeDispatcher.dispatch(buff, [&](auto obj) {
+        if constexpr (std::is_same_v<decltype(obj), std::shared_ptr<Simple>>) {
+            simples.push_back(obj->y());
+        } else {
+            composeds.push_back(obj->s().y());
+        }
+    });
+    REQUIRE(simples.size() + composeds.size() == nbFrames);
+    REQUIRE(std::is_sorted(simples.begin(), simples.end()));
+    REQUIRE(std::is_sorted(composeds.begin(), composeds.end()));
+
+    // per key order (the key is the first member of the objects)
+    std::array<std::vector<int>, 4> keys;
+    serializer::FrameDispatcher<Table> keyDispatcher(
+        pool, {.order = DispatchOrder::PerKey},
+        [](serializer::Frame const &, std::span<std::byte const> payload) {
+            int key;
+            std::memcpy(&key, payload.data(), sizeof(key));
+            return size_t(key);
+        });
+    keyDispatcher.dispatch(buff, [&](auto obj) {
+        if constexpr (std::is_same_v<decltype(obj), std::shared_ptr<Simple>>) {
+            keys[obj->x()].push_back(obj->y());
+        } else {
+            keys[obj->s().x()].push_back(obj->s().y());
+        }
+    });
+    for (auto const &key : keys) {
+        REQUIRE(key.size() == nbFrames / 4);
+        REQUIRE(std::is_sorted(key.begin(), key.end()));
+    }
+    REQUIRE_THROWS_AS(serializer::FrameDispatcher<Table>(
+                          pool, {.order = DispatchOrder::PerKey}),
+                      std::invalid_argument);
+
+    // corrupt payload: the other frames are still handled
+    serializer::Bytes corrupt = buff;
+    auto frame = serializer::readFrame(corrupt, 0);
+    corrupt[frame.pos + 1] = ~corrupt[frame.pos + 1];
+    seen.clear();
+    REQUIRE_THROWS_AS(dispatcher.dispatch(corrupt, collect),
+                      serializer::exceptions::CorruptFrameError);
+    REQUIRE(seen.size() == nbFrames - 1);
+
+    // truncated buffer: the complete frames are handled
+    corrupt = buff;
+    corrupt.resize(corrupt.size() - 1);
+    seen.clear();
+    REQUIRE_THROWS_AS(dispatcher.dispatch(corrupt, collect),
+                      serializer::exceptions::CorruptFrameError);
+    REQUIRE(seen.size() == nbFrames - 1);
+
+    // hedgehog pipeline with concurrent tasks
+    constexpr size_t w = 64, h = 64, bs = 4;
+    double sum = 0;
+    auto matrix = std::make_shared<Matrix<double>>(h, w, bs, new double[h * w]);
+    auto st = std::make_shared<SplitTask<double, FrameTransport>>();
+    auto ct = std::make_shared<ComputeTask<double, FrameTransport>>();
+    auto rt = std::make_shared<ResultTask<double>>();
+    TaskManager<TypeTable<double>, SplitTask<double, FrameTransport>,
+                ComputeTask<double, FrameTransport>, ResultTask<double>>
+        tm(st, ct, rt);
+    serializer::FrameDispatcher<TypeTable<double>> hhDispatcher(
+        pool, {.idInPayload = true});
+
+    for (size_t i = 0; i < h * w; ++i) {
+        matrix->data()[i] = i;
+        sum += (double)i;
+    }
+    FrameTransport::send(*matrix);
+    delete[] matrix->data();
+    tm.receive(hhDispatcher, Network::rcv()); // split task
+    tm.receive(hhDispatcher, Network::rcv()); // compute tasks
+    tm.receive(hhDispatcher, Network::rcv()); // result task
+    REQUIRE(rt->result == sum);
+}
+#endif
+
+/******************************************************************************/
+/*                              shared bytes pool                             */
+/******************************************************************************/
+
+#ifdef TEST_SHARED_BYTES_POOL
+#include "test-classes/composed.hpp"
+#include <serializer/tools/bytes_pool.hpp>
+#include <thread>
+TEST_CASE("shared bytes pool") {
+    using Pool = serializer::tools::SharedBytesPool<std::byte>;
+    Pool &pool = Pool::global();
+    Composed composed(Simple(1, 2, std::string(1000, 'x')), 3, 4);
+    auto before = pool.stats();
+    size_t capacity = 0, reused = 0;
+    bool skipped = false;
+
+    // run on a new thread (empty cache) with empty shared lists
+    pool.trim();
+    std::thread([&] {
+        // the capacity is rounded up to the size class
+        serializer::Bytes mem = pool.acquire(100);
+        capacity = mem.capacity();
+
+        // the released buffer keeps its capacity and is reused by the thread
+        composed.serialize(mem);
+        std::byte *data = mem.data();
+        pool.release(std::move(mem));
+        for (size_t i = 0; i < 100; ++i) {
+            serializer::Bytes other = pool.acquire();
+            reused += other.data() == data && other.size() == 0;
+            composed.serialize(other);
+            pool.release(std::move(other));
+        }
+
+        // larger requests skip the small buffers
+        mem = pool.acquire(4096);
+        skipped = mem.data() != data && mem.capacity() == 4096;
+        pool.release(std::move(mem));
+    }).join();
+    auto stats = pool.stats();
+    REQUIRE(capacity == 128);
+    REQUIRE(reused == 100);
+    REQUIRE(skipped);
+    REQUIRE(stats.misses == before.misses + 2);
+    REQUIRE(stats.hits == before.hits + 100);
+
+    // the buffers of the threads caches are shared when the threads exit
+    pool.trim();
+    std::thread([&] {
+        for (size_t i = 0; i < 2 * Pool::cache_size; ++i) {
+            pool.release(serializer::Bytes(4096));
+        }
+    }).join();
+    stats = pool.stats();
+    std::thread([&] {
+        std::vector<serializer::Bytes> buffers;
+        for (size_t i = 0; i < 2 * Pool::cache_size; ++i) {
+            buffers.push_back(pool.acquire(4096));
+        }
+    }).join();
+    REQUIRE(pool.stats().sharedHits == stats.sharedHits + 2 * Pool::cache_size);
+
+    // concurrent threads
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors = 0;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < 10000; ++i) {
+                serializer::Bytes buffer = pool.acquire(64 << (i % 8));
+                errors += buffer.capacity() < size_t(64 << (i % 8));
+                composed.serialize(buffer);
+                pool.release(std::move(buffer));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(errors == 0);
+    stats = pool.stats();
+    REQUIRE(stats.cachedBuffers <=
+            Pool::nb_classes * (Pool::shared_size + Pool::cache_size));
+
+    // trim only keeps the cache of the thread
+    pool.trim();
+    REQUIRE(pool.stats().cachedBuffers <= Pool::nb_classes * Pool::cache_size);
+}
+#endif
+
+/******************************************************************************/
+/*                                batch buffer                                */
+/******************************************************************************/
+
+#ifdef TEST_BATCH_BUFFER
+#include "test-classes/simple.hpp"
+#include "test-classes/throwing.hpp"
+#include <serializer/io/batch_buffer.hpp>
+#include <thread>
+TEST_CASE("batch buffer") {
+    serializer::io::BatchBuffer batch(1024, 16);
+    serializer::Bytes sent;
+    auto send = [&](std::span<std::byte const> bytes) {
+        sent.append(sent.size(), bytes.data(), bytes.size());
+    };
+
+    // only the contiguous prefix of completed regions is sent
+    auto a = batch.tryReserve(8);
+    auto b = batch.tryReserve(16);
+    REQUIRE((a && b));
+    REQUIRE(b->offset == 8);
+    std::memset(b->data.data(), 2, b->data.size());
+    batch.commit(*b);
+    REQUIRE(batch.flush(send) == 0);
+    REQUIRE(!batch.empty());
+    std::memset(a->data.data(), 1, a->data.size());
+    batch.commit(*a);
+    REQUIRE(batch.flush(send) == 24);
+    REQUIRE(batch.empty());
+    REQUIRE(sent.size() == 24);
+    REQUIRE(sent[7] == std::byte(1));
+    REQUIRE(sent[8] == std::byte(2));
+
+    // the regions larger than the buffer are rejected
+    REQUIRE_THROWS_AS(batch.tryReserve(2000), std::length_error);
+    REQUIRE(!batch.sealed());
+
+    // the buffer is sealed by the first reservation that does not fit
+    REQUIRE(batch.tryAppend(Simple(1, 2, "simple")));
+    REQUIRE(!batch.tryReserve(1000));
+    REQUIRE(!batch.tryReserve(1)); // sealed
+    REQUIRE(batch.flush(send) > 0);
+    REQUIRE(batch.sealed());
+    REQUIRE(batch.empty());
+    Simple simple;
+    simple.deserialize(sent, 24);
+    REQUIRE(simple == Simple(1, 2, "simple"));
+
+    // reset
+    batch.reset();
+    REQUIRE(!batch.sealed());
+    REQUIRE(batch.tryReserve(1024));
+
+    // the number of records is limited
+    batch.reset();
+    for (size_t i = 0; i < batch.maxRecords(); ++i) {
+        REQUIRE(batch.tryAppend(Simple()));
+    }
+    REQUIRE(!batch.tryAppend(Simple()));
+    batch.flush(send);
+    REQUIRE(batch.sealed());
+
+    // the records which serialization throws are skipped by the flusher
+    batch.reset();
+    sent.clear();
+    REQUIRE(batch.tryAppend(Simple(1, 2, "before")));
+    REQUIRE_THROWS_AS(batch.tryAppend(ThrowingRecord()), std::runtime_error);
+    REQUIRE_THROWS_AS(batch.tryAppendFrame(ThrowingRecord()),
+                      std::runtime_error);
+    REQUIRE(batch.tryAppend(Simple(3, 4, "after")));
+    size_t nbBytes = batch.flush(send);
+    REQUIRE(nbBytes == sent.size());
+    REQUIRE(batch.empty());
+    REQUIRE(batch.flushed() == batch.reserved());
+    size_t pos = simple.deserialize(sent);
+    REQUIRE(simple == Simple(1, 2, "before"));
+    REQUIRE(simple.deserialize(sent, pos) == sent.size());
+    REQUIRE(simple == Simple(3, 4, "after"));
+
+    // concurrent producers serialize frames while the buffer is flushed
+    constexpr size_t nbThreads = 4, nbMessages = 1000;
+    serializer::io::BatchBuffer shared(1 << 20, nbThreads * nbMessages);
+    std::vector<std::thread> producers;
+    std::atomic<size_t> failures = 0;
+    sent.clear();
+    for (size_t t = 0; t < nbThreads; ++t) {
+        producers.emplace_back([&, t] {
+            for (size_t i = 0; i < nbMessages; ++i) {
+                failures += !shared.tryAppendFrame(
+                    Simple(int(t), int(i), "message"), std::uint32_t(t));
+            }
+        });
+    }
+    while (sent.size() == 0 || !shared.empty()) {
+        shared.flush(send);
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    shared.flush(send);
+    REQUIRE(failures == 0);
+    std::vector<int> next(nbThreads, 0);
+    size_t nbFrames = 0;
+    for (size_t pos = 0; pos < sent.size(); ++nbFrames) {
+        auto frame = serializer::readFrame(sent, pos);
+        serializer::deserializeFrame(sent, frame, simple);
+        REQUIRE(simple.x() == int(frame.header.type));
+        REQUIRE(simple.y() == next[simple.x()]++);
+        pos = frame.end();
+    }
+    REQUIRE(nbFrames == nbThreads * nbMessages);
+
+    // concurrent producers seal a small buffer
+    serializer::io::BatchBuffer small(4096);
+    producers.clear();
+    for (size_t t = 0; t < nbThreads; ++t) {
+        producers.emplace_back([&, t] {
+            while (small.tryAppendFrame(Simple(int(t), 0, "message"))) {
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    sent.clear();
+    small.flush(send);
+    REQUIRE(small.sealed());
+    REQUIRE(sent.size() > 4096 - 100);
+    for (size_t pos = 0; pos < sent.size();) {
+        pos = serializer::readFrame(sent, pos).end();
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                              pipelined sender                              */
+/******************************************************************************/
+
+#ifdef TEST_PIPELINED_SENDER
+#include "test-classes/hedgehog.hpp"
+#include "test-classes/simple.hpp"
+#include "test-classes/throwing.hpp"
+#include <serializer/io/pipelined_sender.hpp>
+#include <thread>
+
+struct BytesSink {
+    serializer::Bytes *bytes;
+    bool fail = false;
+
+    void write(std::byte const *data, size_t nbBytes) {
+        if (fail) {
+            throw std::runtime_error("sink error");
+        }
+        bytes->append(bytes->size(), data, nbBytes);
+    }
+};
+
+TEST_CASE("pipelined sender") {
+    using namespace std::chrono_literals;
+    using serializer::io::PipelinedSender;
+    serializer::Bytes sent, expected;
+    Simple simple(1, 2, "simple");
+
+    // the small messages are coalesced in one batch
+    {
+        PipelinedSender<BytesSink> sender(
+            BytesSink{&sent}, {.batchBytes = 1 << 20, .maxDelay = 10s});
+        size_t pos = 0;
+        for (int i = 0; i < 100; ++i) {
+            sender.post(Simple(i, i, "simple"));
+            pos = Simple(i, i, "simple").serialize(expected, pos);
+        }
+        sender.flush();
+        REQUIRE(sender.nbBatches() == 1);
+        REQUIRE(sent.size() == expected.size());
+        REQUIRE(std::memcmp(sent.data(), expected.data(), sent.size()) == 0);
+    }
+
+    // size budget
+    {
+        sent.clear();
+        PipelinedSender<BytesSink> sender(
+            BytesSink{&sent}, {.batchBytes = 1000, .maxDelay = 10s});
+        for (size_t i = 0; i < 1000; ++i) {
+            sender.post(simple);
+        }
+        sender.flush();
+        REQUIRE(sender.nbBatches() > 1);
+        REQUIRE(sender.nbBatches() < 1000);
+        REQUIRE(sender.nbBytes() == sent.size());
+    }
+
+    // latency budget: the batch is sent without flush
+    {
+        sent.clear();
+        PipelinedSender<BytesSink> sender(
+            BytesSink{&sent}, {.batchBytes = 1 << 20, .maxDelay = 1ms});
+        sender.post(simple);
+        for (size_t i = 0; i < 1000 && sender.nbBatches() == 0; ++i) {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(sender.nbBatches() == 1);
+    }
+
+    // concurrent producers with small rotating buffers
+    {
+        constexpr size_t nbThreads = 4, nbMessages = 1000;
+        sent.clear();
+        PipelinedSender<BytesSink> sender(BytesSink{&sent},
+                                          {.nbBuffers = 3,
+                                           .bufferSize = 256,
+                                           .batchBytes = 128,
+                                           .maxDelay = 10us});
+        std::vector<std::thread> producers;
+        for (size_t t = 0; t < nbThreads; ++t) {
+            producers.emplace_back([&, t] {
+                for (size_t i = 0; i < nbMessages; ++i) {
+                    sender.postFrame(Simple(int(t), int(i), "message"),
+                                     std::uint32_t(t));
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        sender.flush();
+        std::vector<int> next(nbThreads, 0);
+        size_t nbFrames = 0;
+        for (size_t pos = 0; pos < sent.size(); ++nbFrames) {
+            auto frame = serializer::readFrame(sent, pos);
+            serializer::deserializeFrame(sent, frame, simple);
+            REQUIRE(simple.x() == int(frame.header.type));
+            REQUIRE(simple.y() == next[simple.x()]++);
+            pos = frame.end();
+        }
+        REQUIRE(nbFrames == nbThreads * nbMessages);
+        REQUIRE_THROWS_AS(sender.post(Simple(0, 0, std::string(1000, 'x'))),
+                          std::length_error);
+    }
+
+    // the messages which serialization throws do not hold the batch back
+    {
+        sent.clear();
+        PipelinedSender<BytesSink> sender(
+            BytesSink{&sent}, {.batchBytes = 1 << 20, .maxDelay = 10s});
+        REQUIRE_THROWS_AS(sender.post(ThrowingRecord()), std::runtime_error);
+        sender.post(simple);
+        REQUIRE_THROWS_AS(sender.postFrame(ThrowingRecord()),
+                          std::runtime_error);
+        sender.flush();
+        REQUIRE(sent.size() == simple.serialize(expected));
+        REQUIRE(std::memcmp(sent.data(), expected.data(), sent.size()) == 0);
+    }
+
+    // the errors of the sink are reported
+    {
+        PipelinedSender<BytesSink> sender(BytesSink{&sent, true});
+        sender.post(simple);
+        REQUIRE_THROWS_AS(sender.flush(), std::runtime_error);
+    }
+
+    // hedgehog pipeline
+    {
+        constexpr size_t w = 16, h = 16, bs = 4;
+        double sum = 0;
+        auto matrix =
+            std::make_shared<Matrix<double>>(h, w, bs, new double[h * w]);
+        auto st = std::make_shared<SplitTask<double, PipelineTransport>>();
+        auto ct = std::make_shared<ComputeTask<double, PipelineTransport>>();
+        auto rt = std::make_shared<ResultTask<double>>();
+        TaskManager<TypeTable<double>, SplitTask<double, PipelineTransport>,
+                    ComputeTask<double, PipelineTransport>, ResultTask<double>>
+            tm(st, ct, rt);
+        PipelinedSender<NetworkSink> sender(NetworkSink{});
+
+        for (size_t i = 0; i < h * w; ++i) {
+            matrix->data()[i] = i;
+            sum += (double)i;
+        }
+        PipelineTransport::sender = &sender;
+        PipelineTransport::send(*matrix);
+        delete[] matrix->data();
+        for (size_t i = 0; i < 3; ++i) {
+            sender.flush();
+            tm.receive(Network::rcv());
+        }
+        PipelineTransport::sender = nullptr;
+        REQUIRE(rt->result == sum);
+    }
+}
+#endif
+
+/******************************************************************************/
+/*                                alloc stats                                 */
+/******************************************************************************/
+
+#ifdef TEST_ALLOC_STATS
+#define SERIALIZER_ALLOC_HOOKS
+#include "test-classes/cstruct.h"
+#include "test-classes/tree.hpp"
+#include <serializer/tools/alloc_stats.hpp>
+
+TEST_CASE("alloc stats") {
+    using namespace serializer::tools;
+    serializer::Bytes mem;
+
+    // heap hooks
+    auto report = countAllocations([] { delete new int(0); });
+    REQUIRE(report.heap == AllocStats{1, sizeof(int)});
+
+    // trivial types are deserialized without allocation
+    CStructSerializable cstruct('c', 1, 2, 3.f, 4.), out;
+    cstruct.serialize(mem);
+    report = countAllocations([&] { out.deserialize(mem); });
+    REQUIRE(report.heap.allocations == 0);
+    REQUIRE(report.types.empty());
+    REQUIRE(out.i() == 1);
+
+    // the buffers and the created objects are counted by the serializer
+    // (cmake -DSERIALIZER_ALLOC_STATS=ON)
+#ifdef SERIALIZER_ALLOC_STATS
+    // the growth of the buffers is counted, not the reused buffers
+    Simple simple(1, 2, std::string(1000, 'x'));
+    serializer::Bytes small(1);
+    report = countAllocations([&] { simple.serialize(small); });
+    REQUIRE(report.buffers.allocations > 0);
+    REQUIRE(report.buffers.bytes >= 1000);
+    REQUIRE(report.heap.allocations == report.buffers.allocations);
+    report = countAllocations([&] { simple.serialize(small); });
+    REQUIRE(report.heap.allocations == 0);
+    REQUIRE(report.buffers.allocations == 0);
+
+    // objects created by the deserialization, per type
+    Tree<int> tree, result;
+    for (int value : {5, 3, 8, 1, 4}) {
+        tree.insert(value);
+    }
+    tree.serialize(mem);
+    report = countAllocations([&] { result.deserialize(mem); });
+    REQUIRE(report.objects == AllocStats{5, 5 * sizeof(Node<int>)});
+    REQUIRE(report.heap == report.objects);
+    REQUIRE(report.types.size() == 1);
+    REQUIRE(*report.types[0].first == typeid(Node<int>));
+    REQUIRE(report.types[0].second == report.objects);
+
+    // the counters are per thread
+    bool fresh = false;
+    std::thread([&] { fresh = allocTypes == nullptr; }).join();
+    REQUIRE(fresh);
+    REQUIRE(typeAllocStats<Node<int>>.registered);
+#endif
+}
+#endif
+
+/******************************************************************************/
+/*                              serializer stats                              */
+/******************************************************************************/
+
+#ifdef TEST_SERIALIZER_STATS
+#include <serializer/tools/stats.hpp>
+#include <sstream>
+#include <thread>
+
+template <typename MemT>
+using StatsSerializer =
+    serializer::Serializer<MemT, serializer::tools::TypeTable<>,
+                           serializer::tools::ThreadStats>;
+
+struct StatsLeaf {
+    int value = 0;
+    std::string name;
+    SERIALIZE_CUSTOM(StatsSerializer<SER_MEMT>, value, name);
+};
+
+struct StatsRoot {
+    std::vector<StatsLeaf> leaves;
+    SERIALIZE_CUSTOM(StatsSerializer<SER_MEMT>, leaves);
+};
+
+TEST_CASE("serializer stats") {
+    using namespace serializer::tools;
+    serializer::Bytes mem;
+    StatsRoot root, out;
+
+    // disabled by default
+    static_assert(std::is_same_v<
+                  serializer::Serializer<serializer::Bytes>::stats_type,
+                  NoStats>);
+    static_assert(std::is_same_v<
+                  StatsSerializer<serializer::Bytes>::stats_type,
+                  ThreadStats>);
+
+    ThreadStats::reset();
+    for (int i = 0; i < 3; ++i) {
+        root.leaves.push_back(StatsLeaf{i, "leaf " + std::to_string(i)});
+    }
+    size_t bytes = root.serialize(mem);
+    out.deserialize(mem);
+    REQUIRE(out.leaves.size() == 3);
+    REQUIRE(out.leaves[2].name == "leaf 2");
+
+    // local counters (the nested objects are included in their parent)
+    TypeStats rootStats = ThreadStats::local<StatsRoot>();
+    TypeStats leafStats = ThreadStats::local<StatsLeaf>();
+    REQUIRE(rootStats.serialized == 1);
+    REQUIRE(rootStats.deserialized == 1);
+    REQUIRE(rootStats.bytesWritten == bytes);
+    REQUIRE(rootStats.bytesRead == bytes);
+    REQUIRE(leafStats.serialized == 3);
+    REQUIRE(leafStats.bytesWritten ==
+            3 * (sizeof(int) + sizeof(size_t) + 6));
+    REQUIRE(leafStats.bytesWritten < rootStats.bytesWritten);
+
+    // merged with the other threads (including the threads that exited)
+    std::thread([&] {
+        serializer::Bytes local;
+        StatsLeaf leaf{1, "thread"};
+        leaf.serialize(local);
+    }).join();
+    auto stats = ThreadStats::collect();
+    REQUIRE(stats.size() == 2);
+    REQUIRE(stats["StatsRoot"].serialized == 1);
+    REQUIRE(stats["StatsLeaf"].serialized == 4);
+    REQUIRE(stats["StatsLeaf"].deserialized == 3);
+
+    std::ostringstream oss;
+    ThreadStats::dump(oss);
+    REQUIRE(oss.str().find("StatsLeaf") != std::string::npos);
+
+    ThreadStats::reset();
+    REQUIRE(ThreadStats::collect()["StatsRoot"].serialized == 0);
+}
+#endif